@@ -0,0 +1,93 @@
+// Batched point-to-monitor classification in points per second, for each
+// kernel this CPU supports against the scalar one, on video walls of 1 to
+// 256 monitors, e.g.
+//   ./build/bin/BenchClassifyPoints
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "screen_classify.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+constexpr double MIN_SECONDS = 0.2;
+constexpr size_t POINTS = 4096; // a frame's worth of particles
+
+static const char* KernelName(int32_t kernel) {
+    switch (kernel) {
+        case SIMD_SSE2: return "sse2";
+        case SIMD_AVX2: return "avx2";
+        default:        return "scalar";
+    }
+}
+
+// Doubling the pass count until a run is long enough to time
+static double Rate(int32_t kernel, const ScreenIndex& index, const vector<int32_t>& points,
+                   vector<int32_t>& out, int64_t& checksum) {
+    size_t count = points.size() / 2;
+    size_t passes = 1;
+    for (;;) {
+        auto start = chrono::steady_clock::now();
+        for (size_t pass = 0; pass < passes; pass++) {
+            rezol_classify_points(kernel, index, points.data(), out.data(), count);
+            checksum += out[pass % count];
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (seconds >= MIN_SECONDS) {
+            return (double)passes * count / seconds;
+        }
+        passes *= 2;
+    }
+}
+
+int main() {
+    cout << "runtime pick: " << KernelName(rezol_simd_best()) << endl;
+    vector<int32_t> kernels;
+    for (int32_t kernel : { (int32_t)SIMD_SCALAR, (int32_t)SIMD_SSE2, (int32_t)SIMD_AVX2 }) {
+        if (rezol_simd_supported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+
+    cout << setw(9) << "monitors";
+    for (int32_t kernel : kernels) {
+        cout << setw(16) << string(KernelName(kernel)) + " pts/s";
+    }
+    cout << setw(10) << "speedup" << endl;
+
+    int64_t checksum = 0;
+    for (int count : { 1, 2, 4, 8, 16, 32, 64, 128, 256 }) {
+        vector<PhysicalScreen> screens = MakeVideoWall(count);
+        ScreenIndex index;
+        rezol_index_build(index, screens);
+
+        // Spread over the wall with a few off it
+        int32_t right = 0, bottom = 0;
+        for (const PhysicalScreen& s : screens) {
+            right = max(right, s.virtualRect.right);
+            bottom = max(bottom, s.virtualRect.bottom);
+        }
+        vector<int32_t> points;
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < POINTS; i++) {
+            seed = seed * 1664525 + 1013904223;
+            points.push_back((int32_t)(seed % (uint32_t)(right + 200)) - 100);
+            seed = seed * 1664525 + 1013904223;
+            points.push_back((int32_t)(seed % (uint32_t)(bottom + 200)) - 100);
+        }
+        vector<int32_t> out(POINTS);
+
+        cout << setw(9) << count << fixed << setprecision(0);
+        double scalar = 0, widest = 0;
+        for (int32_t kernel : kernels) {
+            double rate = Rate(kernel, index, points, out, checksum);
+            scalar = (kernel == SIMD_SCALAR) ? rate : scalar;
+            widest = rate;
+            cout << setw(16) << rate;
+        }
+        cout << setw(9) << setprecision(1) << widest / scalar << "x" << endl;
+    }
+    cout << "(checksum " << checksum << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+// EDID parser throughput in blobs per second. The corpus is every file
+// given on the command line, else every connector's EDID under
+// /sys/class/drm, else a built-in set of synthetic monitors, e.g.
+//   ./build/bin/BenchEDID
+//   ./build/bin/BenchEDID edids/*.bin
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include "edid.h"
+#include "tests/edid_blobs.h"
+
+using namespace std;
+
+constexpr double MIN_SECONDS = 0.5;
+
+static bool ReadBlob(const string& path, vector<EDIDBlob>& corpus) {
+    ifstream in(path, ios::binary);
+    EDIDBlob blob((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    EDIDInfo info;
+    if (!rezol_edid_parse(blob.data(), blob.size(), info)) {
+        return false;
+    }
+    corpus.push_back(blob);
+    return true;
+}
+
+static void ReadSysfs(vector<EDIDBlob>& corpus) {
+    DIR* dir = opendir("/sys/class/drm");
+    if (dir == nullptr) {
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        ReadBlob(string("/sys/class/drm/") + entry->d_name + "/edid", corpus);
+    }
+    closedir(dir);
+}
+
+// Laptop panel, desktop monitor, HDMI TV and a DisplayID tiled panel
+static void Synthesize(vector<EDIDBlob>& corpus) {
+    EDIDBlob panel = MakeEDID(2560, 1600, 160, 46, 26850, 302, 189, nullptr);
+    EDIDSetVendor(panel, "BOE", 0x0A1B, 0, 20, 2021);
+    corpus.push_back(panel);
+
+    EDIDBlob monitor = MakeEDID(1920, 1080, 280, 45, 14850, 527, 296, "DELL U2419H");
+    EDIDSetVendor(monitor, "DEL", 0xA0B5, 0x4C333232, 44, 2019);
+    EDIDSetRangeAndSerial(monitor, 56, 76, 30, 83, 170, "7MT0194G2ABL");
+    corpus.push_back(monitor);
+
+    EDIDBlob tv = MakeEDID(3840, 2160, 560, 90, 59400, 1210, 680, "LG TV");
+    EDIDSetVendor(tv, "GSM", 0xC0A5, 0x01010101, 1, 2023);
+    EDIDAppendCTA(tv, { 0x80 | 16, 4, 31, 93, 95, 97 }, true, 1920, 1080, 280, 45, 14850);
+    corpus.push_back(tv);
+
+    EDIDBlob tile = MakeEDID(2560, 2880, 160, 62, 0, 0, 0, nullptr);
+    EDIDSetVendor(tile, "GSM", 0x5B71, 0, 30, 2016);
+    EDIDAppendDisplayID(tile, "LG UltraFine", 5970, 3360, 2560, 2880, 160, 62, 48325, 2, 1, 1, 0);
+    corpus.push_back(tile);
+}
+
+int main(int argc, char** argv) {
+    vector<EDIDBlob> corpus;
+    const char* source = "files";
+    for (int i = 1; i < argc; i++) {
+        if (!ReadBlob(argv[i], corpus)) {
+            cerr << "skipping " << argv[i] << ": not an EDID" << endl;
+        }
+    }
+    if (argc <= 1) {
+        source = "sysfs";
+        ReadSysfs(corpus);
+    }
+    if (corpus.empty()) {
+        source = "synthetic";
+        Synthesize(corpus);
+    }
+
+    size_t bytes = 0;
+    for (const EDIDBlob& blob : corpus) {
+        bytes += blob.size();
+    }
+    cout << "corpus: " << corpus.size() << " blobs, " << bytes << " bytes (" << source << ")" << endl;
+
+    // Double the pass count until a run is long enough to time
+    EDIDInfo info;
+    int64_t checksum = 0;
+    size_t passes = 1;
+    double seconds = 0;
+    for (;;) {
+        auto start = chrono::steady_clock::now();
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (const EDIDBlob& blob : corpus) {
+                rezol_edid_parse(blob.data(), blob.size(), info);
+                checksum += info.widthMM + info.preferredTiming.refreshMilliHz;
+            }
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (seconds >= MIN_SECONDS) {
+            break;
+        }
+        passes *= 2;
+    }
+
+    double blobs = (double)passes * corpus.size();
+    cout << fixed << setprecision(0)
+         << "parsed " << blobs << " blobs in " << setprecision(3) << seconds << " s: "
+         << setprecision(0) << blobs / seconds << " blobs/sec, "
+         << setprecision(1) << seconds * 1e9 / blobs << " ns/blob"
+         << " (checksum " << checksum << ")" << endl;
+    return 0;
+}
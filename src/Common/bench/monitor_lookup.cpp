@@ -0,0 +1,131 @@
+// Point-to-monitor lookups per second through the spatial index against a
+// scan of every monitor rect, on video walls of 1 to 256 monitors. Then
+// nearest-monitor lookups of points on no monitor, in the bezel gaps of a
+// wall and just off its edges, e.g.
+//   ./build/bin/BenchMonitorLookup
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "screen_index.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+constexpr double MIN_SECONDS = 0.2;
+constexpr size_t POINTS = 4096;
+
+// The loop GML has to write today
+static int32_t Scan(const vector<PhysicalScreen>& screens, int32_t x, int32_t y) {
+    for (size_t i = 0; i < screens.size(); i++) {
+        const GMSRect& r = screens[i].virtualRect;
+        if (x >= r.left && x < r.right && y >= r.top && y < r.bottom) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+// Nearest monitor by scanning, what rezol_index_find_nearest replaces
+static int32_t ScanNearest(const vector<PhysicalScreen>& screens, int32_t x, int32_t y) {
+    int32_t found = -1;
+    int64_t best = INT64_MAX;
+    for (size_t i = 0; i < screens.size(); i++) {
+        const GMSRect& r = screens[i].virtualRect;
+        int64_t dx = (x < r.left) ? (int64_t)r.left - x : (x >= r.right) ? (int64_t)x - (r.right - 1) : 0;
+        int64_t dy = (y < r.top) ? (int64_t)r.top - y : (y >= r.bottom) ? (int64_t)y - (r.bottom - 1) : 0;
+        if (dx * dx + dy * dy < best) {
+            best = dx * dx + dy * dy;
+            found = (int32_t)i;
+        }
+    }
+    return found;
+}
+
+// Lookups per second, doubling the pass count until a run is long enough to time
+template<typename Lookup>
+static double Rate(const vector<int32_t>& points, Lookup lookup, int64_t& checksum) {
+    size_t passes = 1;
+    for (;;) {
+        auto start = chrono::steady_clock::now();
+        for (size_t pass = 0; pass < passes; pass++) {
+            for (size_t i = 0; i < points.size(); i += 2) {
+                checksum += lookup(points[i], points[i + 1]);
+            }
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (seconds >= MIN_SECONDS) {
+            return (double)passes * (points.size() / 2) / seconds;
+        }
+        passes *= 2;
+    }
+}
+
+int main() {
+    cout << setw(9) << "monitors" << setw(16) << "index/sec" << setw(16) << "scan/sec" << setw(10) << "speedup" << endl;
+    int64_t checksum = 0;
+    for (int count : { 1, 2, 4, 8, 16, 32, 64, 128, 256 }) {
+        vector<PhysicalScreen> screens = MakeVideoWall(count);
+        ScreenIndex index;
+        rezol_index_build(index, screens);
+
+        // Points spread over the wall, a few off it, same for both
+        int32_t right = 0, bottom = 0;
+        for (const PhysicalScreen& s : screens) {
+            right = max(right, s.virtualRect.right);
+            bottom = max(bottom, s.virtualRect.bottom);
+        }
+        vector<int32_t> points;
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < POINTS; i++) {
+            seed = seed * 1664525 + 1013904223;
+            points.push_back((int32_t)(seed % (uint32_t)(right + 200)) - 100);
+            seed = seed * 1664525 + 1013904223;
+            points.push_back((int32_t)(seed % (uint32_t)(bottom + 200)) - 100);
+        }
+
+        double indexed = Rate(points, [&](int32_t x, int32_t y) { return rezol_index_find(index, x, y); }, checksum);
+        double scanned = Rate(points, [&](int32_t x, int32_t y) { return Scan(screens, x, y); }, checksum);
+        cout << setw(9) << count << fixed << setprecision(0)
+             << setw(16) << indexed << setw(16) << scanned
+             << setw(9) << setprecision(1) << indexed / scanned << "x" << endl;
+    }
+
+    // Panels with a 40 pixel bezel gap all round, points that hit none
+    cout << endl << setw(9) << "monitors" << setw(16) << "nearest/sec" << setw(16) << "scan/sec"
+         << setw(10) << "speedup" << endl;
+    for (int count : { 1, 2, 4, 8, 16, 32, 64, 128, 256 }) {
+        vector<PhysicalScreen> screens = MakeVideoWall(count);
+        int32_t right = 0, bottom = 0;
+        for (PhysicalScreen& s : screens) {
+            right = max(right, s.virtualRect.right);
+            bottom = max(bottom, s.virtualRect.bottom);
+            s.virtualRect = { s.virtualRect.left + 20, s.virtualRect.top + 20,
+                              s.virtualRect.right - 20, s.virtualRect.bottom - 20 };
+        }
+        ScreenIndex index;
+        rezol_index_build(index, screens);
+
+        vector<int32_t> points;
+        uint32_t seed = 12345;
+        while (points.size() < 2 * POINTS) {
+            seed = seed * 1664525 + 1013904223;
+            int32_t x = (int32_t)(seed % (uint32_t)(right + 200)) - 100;
+            seed = seed * 1664525 + 1013904223;
+            int32_t y = (int32_t)(seed % (uint32_t)(bottom + 200)) - 100;
+            if (rezol_index_find(index, x, y) < 0) {
+                points.push_back(x);
+                points.push_back(y);
+            }
+        }
+
+        double indexed = Rate(points, [&](int32_t x, int32_t y) { return rezol_index_find_nearest(index, x, y); },
+                              checksum);
+        double scanned = Rate(points, [&](int32_t x, int32_t y) { return ScanNearest(screens, x, y); }, checksum);
+        cout << setw(9) << count << fixed << setprecision(0)
+             << setw(16) << indexed << setw(16) << scanned
+             << setw(9) << setprecision(1) << indexed / scanned << "x" << endl;
+    }
+    cout << "(checksum " << checksum << ")" << endl;
+    return 0;
+}
@@ -0,0 +1,351 @@
+// Latency of the calls a game makes, per backend and per topology size, as
+// JSON so upgrades can be gated on it. Each call is timed on its own and
+// reported as p50 and p99 in nanoseconds, with the operator new calls it
+// made averaged over every timed call, e.g.
+//   ./build/bin/GMSVirtualScreenBench
+//   ./build/bin/GMSVirtualScreenBench --out bench.json --seconds 0.05
+//   ./build/bin/GMSVirtualScreenBench --native
+// The fixture backend serves recorded video walls of 1, 2, 8, 64 and 256
+// monitors, and on Linux the DRM backend reads the same walls from a fake
+// sysfs tree, so neither needs a display. --native adds whatever this
+// machine enumerates through the normal backend choice.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_topology.h"
+#include "screen_schema.h"
+#include "screen_wire.h"
+#include "edid.h"
+#include "tests/fixture_topologies.h"
+#ifdef __linux__
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "linux_backends.h"
+#include "tests/edid_blobs.h"
+#endif
+
+using namespace std;
+
+// Every operator new in the process, the library's included: on Linux the
+// executable's definition interposes on the shared library's calls. On
+// Windows the DLL has its own heap and its allocations are not seen.
+static atomic<uint64_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+static const int FixtureSizes[] = { 1, 2, 8, 64, 256 };
+static const char* FixturePath = "gms_bench.gmsf";
+
+constexpr size_t MIN_SAMPLES = 101;
+constexpr size_t MAX_SAMPLES = 200000;
+constexpr size_t BATCH = 1024; // points or rects per batched call
+
+static double minSeconds = 0.2;
+
+struct BenchResult {
+    string  backend;
+    size_t  monitors;
+    string  op;
+    size_t  calls;
+    int64_t p50;
+    int64_t p99;
+    double  allocsPerCall;
+};
+
+static vector<BenchResult> results;
+
+static int64_t Percentile(vector<int64_t>& samples, double fraction) {
+    size_t at = min(samples.size() - 1, (size_t)(fraction * samples.size()));
+    nth_element(samples.begin(), samples.begin() + at, samples.end());
+    return samples[at];
+}
+
+// Time single calls until there are enough samples over a long enough run
+static void Measure(const string& backend, size_t monitors, const char* op, const function<void(size_t)>& call) {
+    for (size_t i = 0; i < 3; i++) {
+        call(i);
+    }
+    vector<int64_t> samples;
+    samples.reserve(MAX_SAMPLES);
+    uint64_t allocated = allocations.load(memory_order_relaxed);
+    auto begin = chrono::steady_clock::now();
+    while (samples.size() < MAX_SAMPLES) {
+        auto start = chrono::steady_clock::now();
+        call(samples.size());
+        auto end = chrono::steady_clock::now();
+        samples.push_back(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+        if (samples.size() >= MIN_SAMPLES && chrono::duration<double>(end - begin).count() >= minSeconds) {
+            break;
+        }
+    }
+    allocated = allocations.load(memory_order_relaxed) - allocated;
+
+    BenchResult r;
+    r.backend = backend;
+    r.monitors = monitors;
+    r.op = op;
+    r.calls = samples.size();
+    r.allocsPerCall = (double)allocated / samples.size();
+    r.p50 = Percentile(samples, 0.50);
+    r.p99 = Percentile(samples, 0.99);
+    results.push_back(r);
+}
+
+// Points and rects spread over and a little around the desktop
+static void MakeInputs(const vector<PhysicalScreen>& screens, vector<int32_t>& points,
+                       vector<double>& logical, vector<int32_t>& rects) {
+    int32_t right = 1, bottom = 1;
+    for (const PhysicalScreen& s : screens) {
+        right = max(right, s.virtualRect.right);
+        bottom = max(bottom, s.virtualRect.bottom);
+    }
+    uint32_t seed = 12345;
+    auto next = [&seed](int32_t range) {
+        seed = seed * 1664525 + 1013904223;
+        return (int32_t)(seed % (uint32_t)(range + 200)) - 100;
+    };
+    points.clear();
+    logical.clear();
+    rects.clear();
+    for (size_t i = 0; i < BATCH; i++) {
+        int32_t x = next(right), y = next(bottom);
+        points.insert(points.end(), { x, y });
+        logical.insert(logical.end(), { (double)x, (double)y });
+        rects.insert(rects.end(), { x, y, x + 800, y + 600 });
+    }
+}
+
+// Everything a game calls once the backend has enumerated. The backend's
+// topology must already be current.
+static void MeasureQueries(const string& backend) {
+    TopologyRef topology = rezol_topology_refresh();
+    const vector<PhysicalScreen>& screens = topology->screens;
+    size_t monitors = screens.size();
+
+    Measure(backend, monitors, "enumerate", [](size_t) { rezol_ext_refresh_topology(); });
+
+    // Serialization on its own, and through the export with its snapshot check
+    topology = rezol_topology_current();
+    vector<char> buf(rezol_schema_screen_info_size(WIRE_FORMAT_V2, monitors));
+    Measure(backend, monitors, "serialize_v1", [&](size_t) {
+        rezol_write_screen_info(buf.data(), buf.size(), *topology, 0, INT32_MAX, WIRE_FORMAT_V1);
+    });
+    Measure(backend, monitors, "serialize_v2", [&](size_t) {
+        rezol_write_screen_info(buf.data(), buf.size(), *topology, 0, INT32_MAX, WIRE_FORMAT_V2);
+    });
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    Measure(backend, monitors, "get_screen_info", [&](size_t) {
+        rezol_ext_get_screen_info_sized(address, (double)buf.size());
+    });
+
+    // Lookups and transforms, BATCH points or rects per batched call
+    vector<int32_t> points, rects;
+    vector<double> logical;
+    MakeInputs(screens, points, logical, rects);
+    vector<int32_t> indices(BATCH);
+    vector<char> placements(BATCH * (size_t)rezol_ext_get_buffer_size(RECTPLACEMENT));
+    vector<double> out(BATCH * 4);
+    char pointsAddress[32], rectsAddress[32], logicalAddress[32], indicesAddress[32], placementsAddress[32], outAddress[32];
+    snprintf(pointsAddress, sizeof(pointsAddress), "%p", (void*)points.data());
+    snprintf(rectsAddress, sizeof(rectsAddress), "%p", (void*)rects.data());
+    snprintf(logicalAddress, sizeof(logicalAddress), "%p", (void*)logical.data());
+    snprintf(indicesAddress, sizeof(indicesAddress), "%p", (void*)indices.data());
+    snprintf(placementsAddress, sizeof(placementsAddress), "%p", (void*)placements.data());
+    snprintf(outAddress, sizeof(outAddress), "%p", (void*)out.data());
+
+    Measure(backend, monitors, "monitor_from_point", [&](size_t i) {
+        size_t at = (i % BATCH) * 2;
+        rezol_ext_monitor_from_point(points[at], points[at + 1]);
+    });
+    Measure(backend, monitors, "monitors_from_points", [&](size_t) {
+        rezol_ext_monitors_from_points(pointsAddress, indicesAddress, BATCH);
+    });
+    Measure(backend, monitors, "monitors_from_rects", [&](size_t) {
+        rezol_ext_monitors_from_rects(rectsAddress, placementsAddress, BATCH);
+    });
+    Measure(backend, monitors, "transform_points", [&](size_t) {
+        rezol_ext_transform_points(logicalAddress, outAddress, BATCH, SPACE_LOGICAL, SPACE_PIXELS);
+    });
+    Measure(backend, monitors, "transform_rects", [&](size_t) {
+        rezol_ext_transform_rects(logicalAddress, outAddress, BATCH / 2, SPACE_LOGICAL, SPACE_MM);
+    });
+}
+
+static void BenchFixture() {
+    for (int count : FixtureSizes) {
+        vector<PhysicalScreen> screens = MakeVideoWall(count);
+        if (!rezol_fixture_write(FixturePath, screens.data(), count, 0) ||
+            rezol_ext_load_fixture((char*)FixturePath) != 0) {
+            cerr << "Cannot write fixture " << FixturePath << endl;
+            continue;
+        }
+        MeasureQueries("fixture");
+    }
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+}
+
+#ifdef __linux__
+static void WriteFile(const string& path, const void* data, size_t size) {
+    ofstream out(path, ios::binary);
+    out.write(static_cast<const char*>(data), size);
+}
+
+static int RemoveEntry(const char* path, const struct stat*, int, struct FTW*) {
+    return remove(path);
+}
+
+// The same walls as connectors under a fake /sys/class/drm. Panels with
+// an EDID each get their own, so names really are resolved.
+static void BenchDRM() {
+    setenv("GMS_SCREEN_BACKEND", "drm", 1);
+    for (int count : FixtureSizes) {
+        char root[] = "/tmp/gms_bench_XXXXXX";
+        if (mkdtemp(root) == nullptr) {
+            cerr << "mkdtemp failed" << endl;
+            return;
+        }
+        string drm = string(root) + "/class";
+        mkdir(drm.c_str(), 0755);
+        drm += "/drm";
+        mkdir(drm.c_str(), 0755);
+
+        vector<PhysicalScreen> wall = MakeVideoWall(count);
+        vector<EDIDBlob> edids;
+        for (int i = 0; i < count; i++) {
+            string dir = drm + "/card0-DP-" + to_string(i + 1);
+            mkdir(dir.c_str(), 0755);
+            WriteFile(dir + "/status", "connected\n", 10);
+            WriteFile(dir + "/enabled", "enabled\n", 8);
+            WriteFile(dir + "/modes", "1920x1080\n", 10);
+            EDIDBlob edid;
+            if (wall[i].physSize.width != 0) {
+                char name[MONITOR_NAME_BUFFER_SIZE];
+                snprintf(name, sizeof(name), "Panel %d", i);
+                edid = MakeEDID(1920, 1080, 280, 45, 14850, wall[i].physSize.width, wall[i].physSize.height, name);
+                edids.push_back(edid);
+            }
+            WriteFile(dir + "/edid", edid.data(), edid.size());
+        }
+
+        rezol_drm_set_sysfs_root(root);
+        rezol_edid_cache_clear();
+        MeasureQueries("drm");
+
+        // One monitor's EDID per call, the way enumeration resolves names
+        if (!edids.empty()) {
+            EDIDInfo info;
+            Measure("drm", count, "name_resolution", [&](size_t i) {
+                const EDIDBlob& edid = edids[i % edids.size()];
+                rezol_edid_parse_cached(edid.data(), edid.size(), info);
+            });
+            Measure("drm", count, "name_parse", [&](size_t i) {
+                const EDIDBlob& edid = edids[i % edids.size()];
+                rezol_edid_parse(edid.data(), edid.size(), info);
+            });
+        }
+
+        nftw(root, &RemoveEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+    rezol_drm_set_sysfs_root(nullptr);
+    unsetenv("GMS_SCREEN_BACKEND");
+}
+#endif
+
+static void WriteJSON(ostream& out) {
+    out << "{\n";
+    out << "  \"version\": \"" << (int)GMSVersionMajor << "." << (int)GMSVersionMinor << "." << (int)GMSVersionBuild << "\",\n";
+    out << "  \"unit\": \"ns\",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char allocs[32];
+        snprintf(allocs, sizeof(allocs), "%.2f", r.allocsPerCall);
+        out << (i ? ",\n" : "\n")
+            << "    { \"backend\": \"" << r.backend << "\", \"monitors\": " << r.monitors
+            << ", \"op\": \"" << r.op << "\", \"calls\": " << r.calls
+            << ", \"p50_ns\": " << r.p50 << ", \"p99_ns\": " << r.p99
+            << ", \"allocs_per_call\": " << allocs << " }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    const char* outPath = nullptr;
+    bool native = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            minSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--native") == 0) {
+            native = true;
+        } else {
+            cerr << "usage: " << argv[0] << " [--out file.json] [--seconds per-op] [--native]" << endl;
+            return 1;
+        }
+    }
+
+    // Before the other backends touch the environment
+    if (native && rezol_topology_refresh()->result) {
+        const char* forced = getenv("GMS_SCREEN_BACKEND");
+        MeasureQueries((forced != nullptr && *forced != '\0') ? forced : "native");
+    }
+    BenchFixture();
+#ifdef __linux__
+    BenchDRM();
+#endif
+
+    if (outPath != nullptr) {
+        ofstream out(outPath);
+        WriteJSON(out);
+        if (!out) {
+            cerr << "Cannot write " << outPath << endl;
+            return 1;
+        }
+    } else {
+        WriteJSON(cout);
+    }
+    return 0;
+}
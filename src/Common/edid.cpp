@@ -0,0 +1,334 @@
+#include "edid.h"
+#include <cstring>
+
+// Layouts follow VESA E-EDID 1.4, CTA-861-H and DisplayID 1.3 / 2.0.
+// Every read is bounds checked against the block it belongs to.
+
+static const unsigned char EDIDHeader[8] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+
+static inline uint32_t Le16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t Le24(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16);
+}
+
+static inline uint32_t Le32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool BlockChecksumValid(const unsigned char* block) {
+    unsigned char sum = 0;
+    for (size_t i = 0; i < EDID_BLOCK_SIZE; i++) {
+        sum += block[i];
+    }
+    return sum == 0;
+}
+
+static int32_t RefreshMilliHz(uint32_t pixelClockKHz, int32_t hTotal, int32_t vTotal) {
+    uint64_t total = (uint64_t)hTotal * (uint64_t)vTotal;
+    if (total == 0) {
+        return 0;
+    }
+    return (int32_t)(((uint64_t)pixelClockKHz * 1000000u + total / 2) / total);
+}
+
+// Descriptor text, terminated by 0x0A and padded with spaces
+static void CopyDescriptorText(const unsigned char* text, size_t length, char* out, size_t outSize) {
+    size_t len = 0;
+    for (size_t i = 0; i < length && len < outSize - 1; i++) {
+        if (text[i] == 0x0A || text[i] == 0x00) {
+            break;
+        }
+        out[len++] = static_cast<char>(text[i]);
+    }
+    while (len > 0 && out[len - 1] == ' ') {
+        len--;
+    }
+    out[len] = '\0';
+}
+
+// 18 byte detailed timing descriptor, false if it is a display descriptor
+static bool ParseDTD(const unsigned char* d, EDIDTiming& t) {
+    uint32_t clock = Le16(d);
+    if (clock == 0) {
+        return false;
+    }
+    t.pixelClockKHz = clock * 10;
+    t.hActive = d[2] | ((d[4] & 0xF0) << 4);
+    t.hBlank = d[3] | ((d[4] & 0x0F) << 8);
+    t.vActive = d[5] | ((d[7] & 0xF0) << 4);
+    t.vBlank = d[6] | ((d[7] & 0x0F) << 8);
+    t.widthMM = d[12] | ((d[14] & 0xF0) << 4);
+    t.heightMM = d[13] | ((d[14] & 0x0F) << 8);
+    t.interlaced = (d[17] & 0x80) != 0;
+    t.refreshMilliHz = RefreshMilliHz(t.pixelClockKHz, t.hActive + t.hBlank, t.vActive + t.vBlank);
+    return true;
+}
+
+static void ParseRangeLimits(const unsigned char* d, EDIDRangeLimits& r) {
+    // Offset flags add 255 to the limits in EDID 1.4
+    uint8_t flags = d[4];
+    r.minVerticalHz = d[5] + ((flags & 0x03) == 0x03 ? 255 : 0);
+    r.maxVerticalHz = d[6] + ((flags & 0x02) ? 255 : 0);
+    r.minHorizontalKHz = d[7] + ((flags & 0x0C) == 0x0C ? 255 : 0);
+    r.maxHorizontalKHz = d[8] + ((flags & 0x08) ? 255 : 0);
+    r.maxPixelClockMHz = d[9] * 10;
+}
+
+static void ParseBaseBlock(const unsigned char* b, EDIDInfo& info) {
+    uint32_t id = (b[8] << 8) | b[9];
+    for (int i = 0; i < 3; i++) {
+        uint32_t letter = (id >> (10 - 5 * i)) & 0x1F;
+        info.manufacturer[i] = (letter >= 1 && letter <= 26) ? (char)('A' + letter - 1) : '?';
+    }
+    info.manufacturer[3] = '\0';
+    info.productCode = (uint16_t)Le16(b + 10);
+    info.serialNumber = Le32(b + 12);
+    info.modelYear = (b[16] == 0xFF);
+    info.week = info.modelYear ? 0 : b[16];
+    info.year = 1990 + b[17];
+    info.version = b[18];
+    info.revision = b[19];
+    info.digital = (b[20] & 0x80) != 0;
+
+    for (int i = 0; i < 4; i++) {
+        const unsigned char* d = b + 54 + i * 18;
+        EDIDTiming timing;
+        if (ParseDTD(d, timing)) {
+            // The first detailed timing is the preferred one
+            if (!info.hasPreferredTiming) {
+                info.preferredTiming = timing;
+                info.hasPreferredTiming = true;
+            }
+            continue;
+        }
+        switch (d[3]) {
+            case 0xFC:
+                CopyDescriptorText(d + 5, 13, info.name, sizeof(info.name));
+                break;
+            case 0xFF:
+                CopyDescriptorText(d + 5, 13, info.serialText, sizeof(info.serialText));
+                break;
+            case 0xFD:
+                ParseRangeLimits(d, info.rangeLimits);
+                info.hasRangeLimits = true;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void ParseCTABlock(const unsigned char* b, EDIDInfo& info, EDIDTiming& firstDTD, bool& haveDTD) {
+    EDIDCTA& cta = info.cta;
+    cta.revision = b[1];
+    uint8_t dtdOffset = b[2];
+    if (cta.revision >= 2) {
+        cta.underscan = (b[3] & 0x80) != 0;
+        cta.basicAudio = (b[3] & 0x40) != 0;
+        cta.ycbcr444 = (b[3] & 0x20) != 0;
+        cta.ycbcr422 = (b[3] & 0x10) != 0;
+        cta.nativeTimings = b[3] & 0x0F;
+    }
+    if (dtdOffset == 0 || dtdOffset > EDID_BLOCK_SIZE - 1) {
+        // No DTDs and no data blocks
+        return;
+    }
+
+    // Data block collection, revision 3 and later
+    size_t pos = 4;
+    while (cta.revision >= 3 && pos < dtdOffset) {
+        uint8_t header = b[pos];
+        uint8_t tag = header >> 5;
+        size_t len = header & 0x1F;
+        const unsigned char* p = b + pos + 1;
+        if (pos + 1 + len > dtdOffset) {
+            break;
+        }
+        if (tag == 2) {
+            // Video data block, one short video descriptor per byte
+            for (size_t i = 0; i < len; i++) {
+                uint8_t svd = p[i];
+                // Bit 7 marks a native VIC for VICs 1-64 only
+                if (cta.nativeVIC == 0 && (svd & 0x80) && (svd & 0x7F) <= 64) {
+                    cta.nativeVIC = svd & 0x7F;
+                }
+            }
+            cta.vicCount += (int32_t)len;
+        } else if (tag == 3 && len >= 3 && Le24(p) == 0x000C03) {
+            // HDMI Licensing LLC vendor specific data block
+            cta.hdmi = true;
+            if (len >= 7) {
+                cta.maxTMDSMHz = p[6] * 5;
+            }
+        } else if (tag == 7 && len >= 3 && p[0] == 6) {
+            // Extended tag 6, HDR static metadata
+            cta.hdrEOTFs = p[1] & 0x3F;
+        }
+        pos += 1 + len;
+    }
+
+    for (size_t off = dtdOffset; off + 18 <= EDID_BLOCK_SIZE - 1; off += 18) {
+        EDIDTiming timing;
+        if (!ParseDTD(b + off, timing)) {
+            break;
+        }
+        if (!haveDTD) {
+            firstDTD = timing;
+            haveDTD = true;
+        }
+    }
+}
+
+// DisplayID type I (1.x, 10 kHz units) and type VII (2.x, 1 kHz units)
+// timings share one 20 byte layout
+static void ParseDisplayIDTiming(const unsigned char* p, uint32_t clockUnitKHz, EDIDTiming& t, bool& preferred) {
+    t.pixelClockKHz = (Le24(p) + 1) * clockUnitKHz;
+    preferred = (p[3] & 0x80) != 0;
+    t.interlaced = (p[3] & 0x10) != 0;
+    t.hActive = (int32_t)Le16(p + 4) + 1;
+    t.hBlank = (int32_t)Le16(p + 6) + 1;
+    t.vActive = (int32_t)Le16(p + 12) + 1;
+    t.vBlank = (int32_t)Le16(p + 14) + 1;
+    t.widthMM = 0;
+    t.heightMM = 0;
+    t.refreshMilliHz = RefreshMilliHz(t.pixelClockKHz, t.hActive + t.hBlank, t.vActive + t.vBlank);
+}
+
+static void ParseDisplayIDBlock(const unsigned char* b, EDIDInfo& info, EDIDTiming& timing, bool& haveTiming) {
+    EDIDDisplayID& did = info.displayID;
+    did.version = b[1];
+    did.productType = b[3];
+    bool v2 = did.version >= 0x20;
+
+    // The section runs from byte 1 with a 4 byte header, its payload
+    // length in b[2] and a checksum after it. It must fit in the block.
+    size_t end = 5 + (size_t)b[2];
+    if (end > EDID_BLOCK_SIZE - 1) {
+        end = EDID_BLOCK_SIZE - 1;
+    }
+
+    size_t pos = 5;
+    while (pos + 3 <= end) {
+        uint8_t tag = b[pos];
+        uint8_t rev = b[pos + 1];
+        size_t len = b[pos + 2];
+        const unsigned char* p = b + pos + 3;
+        if (pos + 3 + len > end) {
+            break;
+        }
+        if (tag == 0 && len == 0 && rev == 0) {
+            break; // padding
+        }
+
+        if ((tag == 0x00 || tag == 0x20) && len >= 12) {
+            // Product identification, only the name is used when the base
+            // block had none
+            size_t nameLen = p[11];
+            if (info.name[0] == '\0' && 12 + nameLen <= len) {
+                CopyDescriptorText(p + 12, nameLen, info.name, sizeof(info.name));
+            }
+        } else if ((tag == 0x01 || tag == 0x21) && len >= 4) {
+            // Display parameters, image size in 0.1 mm (or 1 mm in 2.x
+            // when bit 7 of the revision byte is set)
+            int32_t w = (int32_t)Le16(p);
+            int32_t h = (int32_t)Le16(p + 2);
+            if (v2 && (rev & 0x80)) {
+                did.widthMM = w;
+                did.heightMM = h;
+            } else {
+                did.widthMM = (w + 5) / 10;
+                did.heightMM = (h + 5) / 10;
+            }
+        } else if ((tag == 0x03 || tag == 0x22) && len >= 20) {
+            uint32_t unit = (tag == 0x22) ? 1 : 10;
+            for (size_t off = 0; off + 20 <= len; off += 20) {
+                EDIDTiming t;
+                bool preferred;
+                ParseDisplayIDTiming(p + off, unit, t, preferred);
+                // Take the one flagged preferred, else the first
+                if (!haveTiming || preferred) {
+                    timing = t;
+                    haveTiming = true;
+                }
+                if (preferred) {
+                    break;
+                }
+            }
+        } else if ((tag == 0x12 || tag == 0x28) && len >= 4) {
+            // Tiled display topology, e.g. one half of a 5K MST monitor or
+            // a panel in a video wall
+            did.tilesH = (((p[1] >> 4) & 0x0F) | (((p[3] >> 6) & 0x03) << 4)) + 1;
+            did.tilesV = ((p[1] & 0x0F) | (((p[3] >> 4) & 0x03) << 4)) + 1;
+            did.tileX = ((p[2] >> 4) & 0x0F) | (((p[3] >> 2) & 0x03) << 4);
+            did.tileY = (p[2] & 0x0F) | ((p[3] & 0x03) << 4);
+        }
+        pos += 3 + len;
+    }
+}
+
+bool rezol_edid_parse(const unsigned char* data, size_t size, EDIDInfo& info) {
+    memset(&info, 0, sizeof(info));
+    if (data == nullptr || size < EDID_BLOCK_SIZE || memcmp(data, EDIDHeader, sizeof(EDIDHeader)) != 0) {
+        return false;
+    }
+    info.checksumValid = BlockChecksumValid(data);
+    ParseBaseBlock(data, info);
+
+    // Extensions that were actually handed to us, whatever byte 126 says
+    size_t blocks = size / EDID_BLOCK_SIZE;
+    size_t declared = (size_t)data[126] + 1;
+    if (blocks > declared) {
+        blocks = declared;
+    }
+    info.extensionCount = (int32_t)blocks - 1;
+
+    EDIDTiming ctaTiming = {}, didTiming = {};
+    bool haveCTATiming = false, haveDIDTiming = false;
+    for (size_t i = 1; i < blocks; i++) {
+        const unsigned char* block = data + i * EDID_BLOCK_SIZE;
+        if (!BlockChecksumValid(block)) {
+            info.checksumValid = false;
+        }
+        if (block[0] == 0x02 && !info.hasCTA) {
+            info.hasCTA = true;
+            ParseCTABlock(block, info, ctaTiming, haveCTATiming);
+        } else if (block[0] == 0x70 && !info.hasDisplayID) {
+            info.hasDisplayID = true;
+            ParseDisplayIDBlock(block, info, didTiming, haveDIDTiming);
+        }
+    }
+
+    if (!info.hasPreferredTiming) {
+        if (haveCTATiming) {
+            info.preferredTiming = ctaTiming;
+            info.hasPreferredTiming = true;
+        } else if (haveDIDTiming) {
+            info.preferredTiming = didTiming;
+            info.hasPreferredTiming = true;
+        }
+    }
+
+    // Physical size: the preferred timing's image size is in mm, the basic
+    // display parameters only in cm
+    if (info.hasPreferredTiming && info.preferredTiming.widthMM > 0 && info.preferredTiming.heightMM > 0) {
+        info.widthMM = info.preferredTiming.widthMM;
+        info.heightMM = info.preferredTiming.heightMM;
+    } else if (info.displayID.widthMM > 0 && info.displayID.heightMM > 0) {
+        info.widthMM = info.displayID.widthMM;
+        info.heightMM = info.displayID.heightMM;
+    } else {
+        info.widthMM = data[21] * 10;
+        info.heightMM = data[22] * 10;
+    }
+    return true;
+}
+
+int32_t rezol_edid_refresh_rate(const EDIDInfo& info, int32_t width, int32_t height) {
+    if (!info.hasPreferredTiming || info.preferredTiming.hActive != width || info.preferredTiming.vActive != height) {
+        return 0;
+    }
+    return (info.preferredTiming.refreshMilliHz + 500) / 1000;
+}
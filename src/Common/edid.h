@@ -0,0 +1,122 @@
+#ifndef EDID_H
+#define EDID_H
+
+#include <cstddef>
+#include <cstdint>
+
+// EDID parser shared by every backend. It reads a raw blob in place, the
+// base block plus any CTA-861 and DisplayID extension blocks, into a fixed
+// size EDIDInfo. Nothing is allocated, so it is cheap enough to run on
+// every enumeration.
+
+constexpr size_t EDID_BLOCK_SIZE = 128;
+constexpr size_t EDID_NAME_SIZE = 64;
+
+// One detailed timing descriptor (base block, CTA) or DisplayID timing
+struct EDIDTiming {
+    uint32_t pixelClockKHz;
+    int32_t  hActive;
+    int32_t  hBlank;
+    int32_t  vActive;
+    int32_t  vBlank;
+    int32_t  widthMM;          // image size, 0 if not given
+    int32_t  heightMM;
+    bool     interlaced;
+    int32_t  refreshMilliHz;
+};
+
+// Display range limits descriptor (0xFD)
+struct EDIDRangeLimits {
+    int32_t minVerticalHz;
+    int32_t maxVerticalHz;
+    int32_t minHorizontalKHz;
+    int32_t maxHorizontalKHz;
+    int32_t maxPixelClockMHz;  // 0 if not given
+};
+
+// CTA-861 extension block (tag 0x02)
+struct EDIDCTA {
+    uint8_t  revision;
+    bool     underscan;
+    bool     basicAudio;
+    bool     ycbcr444;
+    bool     ycbcr422;
+    int32_t  nativeTimings;    // how many DTDs are native formats
+    int32_t  vicCount;         // short video descriptors
+    uint8_t  nativeVIC;        // first VIC flagged native, else 0
+    bool     hdmi;             // HDMI vendor specific data block present
+    int32_t  maxTMDSMHz;       // from the HDMI VSDB, 0 if not given
+    uint8_t  hdrEOTFs;         // HDR static metadata EOTF bits, 0 without HDR
+};
+
+// DisplayID extension block (tag 0x70), version 1.x or 2.x
+struct EDIDDisplayID {
+    uint8_t  version;          // 0x12, 0x13, 0x20...
+    uint8_t  productType;
+    int32_t  widthMM;          // display parameters block, 0 if not given
+    int32_t  heightMM;
+    int32_t  tilesH;           // tiled display topology, 0 if not tiled
+    int32_t  tilesV;
+    int32_t  tileX;
+    int32_t  tileY;
+};
+
+struct EDIDInfo {
+    char     manufacturer[4];  // three letter PNP id
+    uint16_t productCode;
+    uint32_t serialNumber;
+    char     serialText[14];   // serial number descriptor (0xFF), may be empty
+    char     name[EDID_NAME_SIZE]; // product name descriptor (0xFC), else DisplayID, may be empty
+    int32_t  week;             // 0 when not given
+    int32_t  year;
+    bool     modelYear;        // year is a model year rather than manufacture date
+    uint8_t  version;
+    uint8_t  revision;
+    bool     digital;
+    bool     checksumValid;    // every block present has a good checksum
+    int32_t  widthMM;          // best physical size: preferred DTD, then DisplayID, then the cm fields
+    int32_t  heightMM;
+
+    bool            hasPreferredTiming;
+    EDIDTiming      preferredTiming;
+    bool            hasRangeLimits;
+    EDIDRangeLimits rangeLimits;
+
+    int32_t         extensionCount;  // extension blocks actually present
+    bool            hasCTA;
+    EDIDCTA         cta;
+    bool            hasDisplayID;
+    EDIDDisplayID   displayID;
+};
+
+// Parse size bytes at data. Returns false if there is no valid base block;
+// bad checksums and truncated extensions are tolerated and flagged.
+bool rezol_edid_parse(const unsigned char* data, size_t size, EDIDInfo& info);
+
+// Refresh rate in Hz of the preferred timing if it is width x height,
+// otherwise 0
+int32_t rezol_edid_refresh_rate(const EDIDInfo& info, int32_t width, int32_t height);
+
+// --- Parsed EDID cache ---
+
+// Enumerations keep seeing the same few monitors, so parsed results are
+// kept keyed by a hash of the raw bytes. A hit is one hash, one compare
+// and a copy, and allocates nothing.
+constexpr size_t EDID_CACHE_ENTRIES = 16;
+constexpr size_t EDID_CACHE_MAX_BLOCKS = 4;  // bigger blobs are parsed every time
+
+struct EDIDCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    int32_t  entries;
+};
+
+// Same as rezol_edid_parse, through the cache. Safe from any thread.
+bool rezol_edid_parse_cached(const unsigned char* data, size_t size, EDIDInfo& info);
+
+EDIDCacheStats rezol_edid_cache_stats();
+
+// Empty the cache and zero the counters
+void rezol_edid_cache_clear();
+
+#endif // EDID_H
@@ -0,0 +1,101 @@
+#include "edid.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+constexpr size_t EDID_CACHE_MAX_BYTES = EDID_CACHE_MAX_BLOCKS * EDID_BLOCK_SIZE;
+
+struct EDIDCacheEntry {
+    uint64_t      hash;
+    uint64_t      lastUsed;   // 0 while the slot is empty
+    size_t        size;
+    bool          valid;      // what rezol_edid_parse returned
+    EDIDInfo      info;
+    unsigned char raw[EDID_CACHE_MAX_BYTES];
+};
+
+// Fixed storage, so neither a hit nor a miss allocates
+static EDIDCacheEntry cache[EDID_CACHE_ENTRIES];
+static uint64_t useClock = 0;
+static mutex cacheLock;
+static atomic<uint64_t> cacheHits(0);
+static atomic<uint64_t> cacheMisses(0);
+
+// Eight bytes per step multiply-xorshift hash; EDIDs are a multiple of
+// 128 bytes so the tail loop is rarely taken
+static uint64_t HashBytes(const unsigned char* data, size_t size) {
+    const uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t h = size * k;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, 8);
+        h = (h ^ v) * k;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) {
+        h = (h ^ data[i]) * k;
+    }
+    return h ^ (h >> 32);
+}
+
+bool rezol_edid_parse_cached(const unsigned char* data, size_t size, EDIDInfo& info) {
+    if (data == nullptr || size > EDID_CACHE_MAX_BYTES) {
+        cacheMisses++;
+        return rezol_edid_parse(data, size, info);
+    }
+    uint64_t hash = HashBytes(data, size);
+
+    lock_guard<mutex> lock(cacheLock);
+    EDIDCacheEntry* victim = &cache[0];
+    for (EDIDCacheEntry& entry : cache) {
+        // The bytes are compared too, a hash collision must not hand back
+        // another monitor's name
+        if (entry.lastUsed != 0 && entry.hash == hash && entry.size == size &&
+            memcmp(entry.raw, data, size) == 0) {
+            entry.lastUsed = ++useClock;
+            info = entry.info;
+            cacheHits++;
+            return entry.valid;
+        }
+        if (entry.lastUsed < victim->lastUsed) {
+            victim = &entry;
+        }
+    }
+
+    // Miss, replace the least recently used entry
+    cacheMisses++;
+    victim->valid = rezol_edid_parse(data, size, victim->info);
+    victim->hash = hash;
+    victim->size = size;
+    memcpy(victim->raw, data, size);
+    victim->lastUsed = ++useClock;
+    info = victim->info;
+    return victim->valid;
+}
+
+EDIDCacheStats rezol_edid_cache_stats() {
+    EDIDCacheStats stats;
+    stats.hits = cacheHits.load();
+    stats.misses = cacheMisses.load();
+    stats.entries = 0;
+    lock_guard<mutex> lock(cacheLock);
+    for (const EDIDCacheEntry& entry : cache) {
+        if (entry.lastUsed != 0) {
+            stats.entries++;
+        }
+    }
+    return stats;
+}
+
+void rezol_edid_cache_clear() {
+    lock_guard<mutex> lock(cacheLock);
+    for (EDIDCacheEntry& entry : cache) {
+        entry.lastUsed = 0;
+    }
+    useClock = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef SCREEN_BACKEND_H
+#define SCREEN_BACKEND_H
+
+#include "screen_utils.h"
+#include <vector>
+
+// Internal interface between the portable core (screen_utils.cpp) and the
+// per-platform enumeration code. None of this is exported to GML.
+
+// Implemented once per platform (win_screens.cpp, linux_screens.cpp).
+// Fills info->screen[] up to info->maxCount and returns non-zero on success.
+int32_t rezol_platform_get_virtual_screens(ScreenInfo* info);
+
+// Start watching for display configuration changes, calling onChange from
+// any thread whenever the OS reports one. Returns false when the platform
+// has no way to watch, in which case every query re-enumerates.
+// Stopping is left to rezol_topology_shutdown, which runs on unload.
+bool rezol_platform_watch_start(void (*onChange)());
+void rezol_platform_watch_stop();
+
+// Frame-inclusive outer rect and client area of a top-level window, both
+// in desktop coordinates. window is the native handle GML passed (HWND,
+// X11 Window). Returns non-zero on success.
+int32_t rezol_platform_get_window_chrome(uintptr_t window, WindowChrome* chrome);
+
+// Run an enumeration with a growing array until every monitor fits
+int32_t rezol_enumerate_all(int32_t (*enumerate)(ScreenInfo* info),
+                            std::vector<PhysicalScreen>& screens, int32_t& autoHideTaskbar);
+
+// Append a finished record to info, setting info->more instead of
+// overflowing when the caller's array is already full.
+bool rezol_add_screen(ScreenInfo* info, const PhysicalScreen& screen);
+
+#endif // SCREEN_BACKEND_H
@@ -0,0 +1,112 @@
+#include "screen_topology.h"
+#include "screen_schema.h"
+#include "screen_stats.h"
+#include "screen_trace.h"
+#include <cstring>
+
+// Bit mask of the field groups that differ between two records
+static uint16_t ChangedGroups(const PhysicalScreen& before, const PhysicalScreen& after) {
+    const char* a = reinterpret_cast<const char*>(&before);
+    const char* b = reinterpret_cast<const char*>(&after);
+    uint16_t mask = 0;
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        size_t offset = rezol_schema_group_offset(g);
+        if (memcmp(a + offset, b + offset, rezol_schema_group_size(g)) != 0) {
+            mask |= (uint16_t)(1u << g);
+        }
+    }
+    return mask;
+}
+
+// Bytes of field data a record with this mask carries
+static size_t MaskSize(uint16_t mask) {
+    size_t size = 0;
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        if (mask & (1u << g)) {
+            size += rezol_schema_group_size(g);
+        }
+    }
+    return size;
+}
+
+static char* WriteRecord(char* out, uint8_t kind, uint16_t mask, int32_t index, const PhysicalScreen* screen) {
+    WireChangeRecord record;
+    record.kind = kind;
+    record.reserved = 0;
+    record.mask = mask;
+    record.index = index;
+    memcpy(out, &record, SCHEMA_CHANGE_RECORD_SIZE);
+    out += SCHEMA_CHANGE_RECORD_SIZE;
+    const char* fields = reinterpret_cast<const char*>(screen);
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        if (mask & (1u << g)) {
+            memcpy(out, fields + rezol_schema_group_offset(g), rezol_schema_group_size(g));
+            out += rezol_schema_group_size(g);
+        }
+    }
+    return out;
+}
+
+size_t rezol_write_screen_changes(char* buf, size_t size, const TopologySnapshot* since,
+                                  const TopologySnapshot& now, double sinceGeneration) {
+    REZOL_STAT_SCOPE(STAT_SERIALIZE);
+    REZOL_TRACE_SCOPE("serialize_screen_changes");
+    if (buf == nullptr || !now.result) {
+        return 0;
+    }
+    // Without the old snapshot every monitor is reported as added
+    static const TopologySnapshot empty = {};
+    const TopologySnapshot& before = since ? *since : empty;
+    size_t oldCount = before.screens.size();
+    size_t newCount = now.screens.size();
+
+    // Size everything first so nothing is written unless it all fits
+    size_t total = SCHEMA_CHANGES_HEADER_SIZE + SCHEMA_FOURCC_SIZE;
+    size_t records = 0;
+    for (size_t i = 0; i < newCount || i < oldCount; i++) {
+        uint16_t mask;
+        if (i >= oldCount) {
+            mask = SCHEMA_GROUP_ALL;
+        } else if (i >= newCount) {
+            mask = 0;
+        } else {
+            mask = ChangedGroups(before.screens[i], now.screens[i]);
+            if (mask == 0) {
+                continue;
+            }
+        }
+        total += SCHEMA_CHANGE_RECORD_SIZE + MaskSize(mask);
+        records++;
+    }
+    if (total > size || records > UINT16_MAX) {
+        return 0;
+    }
+
+    WireChangesHeader header;
+    header.magic = WIRE_MAGIC_CHANGES;
+    header.full = since ? 0 : 1;
+    header.taskbarChanged = (before.autoHideTaskbar != now.autoHideTaskbar) ? 1 : 0;
+    header.recordCount = (uint16_t)records;
+    header.screenCount = (int32_t)newCount;
+    header.autoHideTaskbar = now.autoHideTaskbar;
+    header.sinceGeneration = sinceGeneration;
+    header.generation = (double)now.generation;
+    header.totalSize = (uint32_t)total;
+    memcpy(buf, &header, SCHEMA_CHANGES_HEADER_SIZE);
+
+    char* out = buf + SCHEMA_CHANGES_HEADER_SIZE;
+    for (size_t i = 0; i < newCount || i < oldCount; i++) {
+        if (i >= oldCount) {
+            out = WriteRecord(out, CHANGE_ADDED, SCHEMA_GROUP_ALL, (int32_t)i, &now.screens[i]);
+        } else if (i >= newCount) {
+            out = WriteRecord(out, CHANGE_REMOVED, 0, (int32_t)i, nullptr);
+        } else {
+            uint16_t mask = ChangedGroups(before.screens[i], now.screens[i]);
+            if (mask != 0) {
+                out = WriteRecord(out, CHANGE_MODIFIED, mask, (int32_t)i, &now.screens[i]);
+            }
+        }
+    }
+    memcpy(out, &GMEX, SCHEMA_FOURCC_SIZE);
+    return total;
+}
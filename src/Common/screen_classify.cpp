@@ -0,0 +1,364 @@
+#include "screen_classify.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+// --- Scalar ---
+
+static void ClassifyScalar(const ScreenIndex& index, const int32_t* points, int32_t* out, size_t count) {
+    size_t screens = index.left.size();
+    for (size_t p = 0; p < count; p++) {
+        int32_t x = points[2 * p];
+        int32_t y = points[2 * p + 1];
+        int32_t found = -1;
+        for (size_t i = 0; i < screens; i++) {
+            if (x >= index.left[i] && x < index.right[i] && y >= index.top[i] && y < index.bottom[i]) {
+                found = (int32_t)i;
+                break;
+            }
+        }
+        out[p] = found;
+    }
+}
+
+// Largest overlap of r with monitors from onwards, only replacing best on a
+// strictly larger area so the lowest index wins a tie
+static void OverlapScalar(const ScreenIndex& index, size_t from, const GMSRect& r, int32_t& screen, int64_t& best) {
+    for (size_t i = from; i < index.left.size(); i++) {
+        int64_t w = (int64_t)min(r.right, index.right[i]) - max(r.left, index.left[i]);
+        int64_t h = (int64_t)min(r.bottom, index.bottom[i]) - max(r.top, index.top[i]);
+        int64_t area = (w > 0 && h > 0) ? w * h : 0;
+        if (area > best) {
+            best = area;
+            screen = (int32_t)i;
+        }
+    }
+}
+
+// Lane results of a vector kernel, lane j having seen monitors j, j + width, ...
+static void ReduceLanes(const int32_t* areas, const int32_t* screens, size_t width, int32_t& screen, int64_t& best) {
+    for (size_t j = 0; j < width; j++) {
+        if (areas[j] > best || (areas[j] == best && screens[j] < screen)) {
+            best = areas[j];
+            screen = screens[j];
+        }
+    }
+}
+
+#ifdef GMS_X86_SIMD
+
+// --- SSE2, 4 points at a time ---
+
+GMS_TARGET_SSE2
+static void ClassifySSE2(const ScreenIndex& index, const int32_t* points, int32_t* out, size_t count) {
+    size_t screens = index.left.size();
+    const __m128i none = _mm_set1_epi32(-1);
+    size_t p = 0;
+    for (; p + 4 <= count; p += 4) {
+        // x0 y0 x1 y1 | x2 y2 x3 y3 -> x0 x1 x2 x3 | y0 y1 y2 y3
+        __m128i a = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(points + 2 * p)), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i b = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(points + 2 * p + 4)), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i x = _mm_unpacklo_epi64(a, b);
+        __m128i y = _mm_unpackhi_epi64(a, b);
+        __m128i found = none;
+        for (size_t i = 0; i < screens; i++) {
+            // Inside is !(left > x || top > y) && right > x && bottom > y
+            __m128i leftTop = _mm_or_si128(_mm_cmpgt_epi32(_mm_set1_epi32(index.left[i]), x),
+                                           _mm_cmpgt_epi32(_mm_set1_epi32(index.top[i]), y));
+            __m128i rightBottom = _mm_and_si128(_mm_cmpgt_epi32(_mm_set1_epi32(index.right[i]), x),
+                                                _mm_cmpgt_epi32(_mm_set1_epi32(index.bottom[i]), y));
+            __m128i inside = _mm_andnot_si128(leftTop, rightBottom);
+            __m128i take = _mm_and_si128(inside, _mm_cmpeq_epi32(found, none));
+            found = _mm_or_si128(_mm_andnot_si128(take, found), _mm_and_si128(take, _mm_set1_epi32((int32_t)i)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(found, none)) == 0) {
+                break;
+            }
+        }
+        _mm_storeu_si128((__m128i*)(out + p), found);
+    }
+    ClassifyScalar(index, points + 2 * p, out + p, count - p);
+}
+
+// --- AVX2, 8 points at a time ---
+
+GMS_TARGET_AVX2
+static void ClassifyAVX2(const ScreenIndex& index, const int32_t* points, int32_t* out, size_t count) {
+    size_t screens = index.left.size();
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    size_t p = 0;
+    for (; p + 8 <= count; p += 8) {
+        // Four pairs per load become x0..x3 y0..y3, then the halves are swapped into place
+        __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(points + 2 * p)), split);
+        __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(points + 2 * p + 8)), split);
+        __m256i x = _mm256_permute2x128_si256(a, b, 0x20);
+        __m256i y = _mm256_permute2x128_si256(a, b, 0x31);
+        __m256i found = none;
+        for (size_t i = 0; i < screens; i++) {
+            // Inside is !(left > x || top > y) && right > x && bottom > y
+            __m256i leftTop = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(index.left[i]), x),
+                                              _mm256_cmpgt_epi32(_mm256_set1_epi32(index.top[i]), y));
+            __m256i rightBottom = _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(index.right[i]), x),
+                                                   _mm256_cmpgt_epi32(_mm256_set1_epi32(index.bottom[i]), y));
+            __m256i inside = _mm256_andnot_si256(leftTop, rightBottom);
+            __m256i take = _mm256_and_si256(inside, _mm256_cmpeq_epi32(found, none));
+            found = _mm256_blendv_epi8(found, _mm256_set1_epi32((int32_t)i), take);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(found, none)) == 0) {
+                break;
+            }
+        }
+        _mm256_storeu_si256((__m256i*)(out + p), found);
+    }
+    ClassifySSE2(index, points + 2 * p, out + p, count - p);
+}
+
+// SSE2 has no 32 bit min, max or multiply, these build them
+
+GMS_TARGET_SSE2
+static inline __m128i Min32(__m128i a, __m128i b) {
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+}
+
+GMS_TARGET_SSE2
+static inline __m128i Max32(__m128i a, __m128i b) {
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+}
+
+GMS_TARGET_SSE2
+static inline __m128i Mul32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// r against 4 monitors at a time. The caller has clamped r to just outside
+// the desktop and checked no overlap can pass INT32_MAX.
+GMS_TARGET_SSE2
+static void OverlapSSE2(const ScreenIndex& index, const GMSRect& r, int32_t& screen, int64_t& best) {
+    size_t screens = index.left.size() & ~(size_t)3;
+    __m128i left = _mm_set1_epi32(r.left), top = _mm_set1_epi32(r.top);
+    __m128i right = _mm_set1_epi32(r.right), bottom = _mm_set1_epi32(r.bottom);
+    __m128i zero = _mm_setzero_si128();
+    __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i bestArea = _mm_set1_epi32(-1), bestScreen = lane;
+    for (size_t i = 0; i < screens; i += 4) {
+        __m128i w = _mm_sub_epi32(Min32(right, _mm_loadu_si128((const __m128i*)&index.right[i])),
+                                  Max32(left, _mm_loadu_si128((const __m128i*)&index.left[i])));
+        __m128i h = _mm_sub_epi32(Min32(bottom, _mm_loadu_si128((const __m128i*)&index.bottom[i])),
+                                  Max32(top, _mm_loadu_si128((const __m128i*)&index.top[i])));
+        __m128i area = Mul32(Max32(w, zero), Max32(h, zero));
+        __m128i better = _mm_cmpgt_epi32(area, bestArea);
+        bestArea = _mm_or_si128(_mm_and_si128(better, area), _mm_andnot_si128(better, bestArea));
+        bestScreen = _mm_or_si128(_mm_and_si128(better, lane), _mm_andnot_si128(better, bestScreen));
+        lane = _mm_add_epi32(lane, _mm_set1_epi32(4));
+    }
+    if (screens > 0) {
+        int32_t areas[4], lanes[4];
+        _mm_storeu_si128((__m128i*)areas, bestArea);
+        _mm_storeu_si128((__m128i*)lanes, bestScreen);
+        ReduceLanes(areas, lanes, 4, screen, best);
+    }
+    OverlapScalar(index, screens, r, screen, best);
+}
+
+// The same, 8 monitors at a time
+GMS_TARGET_AVX2
+static void OverlapAVX2(const ScreenIndex& index, const GMSRect& r, int32_t& screen, int64_t& best) {
+    size_t screens = index.left.size() & ~(size_t)7;
+    __m256i left = _mm256_set1_epi32(r.left), top = _mm256_set1_epi32(r.top);
+    __m256i right = _mm256_set1_epi32(r.right), bottom = _mm256_set1_epi32(r.bottom);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i bestArea = _mm256_set1_epi32(-1), bestScreen = lane;
+    for (size_t i = 0; i < screens; i += 8) {
+        __m256i w = _mm256_sub_epi32(_mm256_min_epi32(right, _mm256_loadu_si256((const __m256i*)&index.right[i])),
+                                     _mm256_max_epi32(left, _mm256_loadu_si256((const __m256i*)&index.left[i])));
+        __m256i h = _mm256_sub_epi32(_mm256_min_epi32(bottom, _mm256_loadu_si256((const __m256i*)&index.bottom[i])),
+                                     _mm256_max_epi32(top, _mm256_loadu_si256((const __m256i*)&index.top[i])));
+        __m256i area = _mm256_mullo_epi32(_mm256_max_epi32(w, zero), _mm256_max_epi32(h, zero));
+        __m256i better = _mm256_cmpgt_epi32(area, bestArea);
+        bestArea = _mm256_blendv_epi8(bestArea, area, better);
+        bestScreen = _mm256_blendv_epi8(bestScreen, lane, better);
+        lane = _mm256_add_epi32(lane, _mm256_set1_epi32(8));
+    }
+    if (screens > 0) {
+        int32_t areas[8], lanes[8];
+        _mm256_storeu_si256((__m256i*)areas, bestArea);
+        _mm256_storeu_si256((__m256i*)lanes, bestScreen);
+        ReduceLanes(areas, lanes, 8, screen, best);
+    }
+    OverlapScalar(index, screens, r, screen, best);
+}
+
+static bool CPUHas(int32_t kernel) {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    if (kernel == SIMD_SSE2) {
+        return (info[3] & (1 << 26)) != 0;
+    }
+    // AVX2 also needs the OS to save the ymm registers
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return kernel == SIMD_SSE2 ? __builtin_cpu_supports("sse2") : __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // GMS_X86_SIMD
+
+bool rezol_simd_supported(int32_t kernel) {
+    switch (kernel) {
+        case SIMD_SCALAR:
+            return true;
+#ifdef GMS_X86_SIMD
+        case SIMD_SSE2:
+        case SIMD_AVX2: {
+            // cpuid once per kernel
+            static const bool sse2 = CPUHas(SIMD_SSE2);
+            static const bool avx2 = CPUHas(SIMD_AVX2);
+            return kernel == SIMD_SSE2 ? sse2 : avx2;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+static int32_t PickKernel() {
+    const char* name = getenv("GMS_SIMD");
+    if (name != nullptr) {
+        int32_t asked = strcmp(name, "avx2") == 0 ? SIMD_AVX2 : strcmp(name, "sse2") == 0 ? SIMD_SSE2 : SIMD_SCALAR;
+        if (rezol_simd_supported(asked)) {
+            return asked;
+        }
+    }
+    if (rezol_simd_supported(SIMD_AVX2)) {
+        return SIMD_AVX2;
+    }
+    return rezol_simd_supported(SIMD_SSE2) ? SIMD_SSE2 : SIMD_SCALAR;
+}
+
+int32_t rezol_simd_best() {
+    static const int32_t best = PickKernel();
+    return best;
+}
+
+void rezol_classify_points(int32_t kernel, const ScreenIndex& index, const int32_t* points,
+                           int32_t* out, size_t count) {
+    if (!rezol_simd_supported(kernel)) {
+        kernel = SIMD_SCALAR;
+    }
+    switch (kernel) {
+#ifdef GMS_X86_SIMD
+        case SIMD_AVX2:
+            ClassifyAVX2(index, points, out, count);
+            break;
+        case SIMD_SSE2:
+            ClassifySSE2(index, points, out, count);
+            break;
+#endif
+        default:
+            ClassifyScalar(index, points, out, count);
+            break;
+    }
+}
+
+// --- Rect placement ---
+
+// Nearest monitor to a rect on none of them, first one wins a tie
+static int32_t NearestToRect(const vector<PhysicalScreen>& screens, const GMSRect& r) {
+    int32_t found = -1;
+    int64_t best = INT64_MAX;
+    for (size_t i = 0; i < screens.size(); i++) {
+        const GMSRect& m = screens[i].virtualRect;
+        if (m.right <= m.left || m.bottom <= m.top) {
+            continue;
+        }
+        int64_t dx = max<int64_t>({ 0, (int64_t)m.left - r.right, (int64_t)r.left - m.right });
+        int64_t dy = max<int64_t>({ 0, (int64_t)m.top - r.bottom, (int64_t)r.top - m.bottom });
+        if (dx * dx + dy * dy < best) {
+            best = dx * dx + dy * dy;
+            found = (int32_t)i;
+        }
+    }
+    return found;
+}
+
+// Keep the size where it fits and move the rect inside, else shrink it
+static GMSRect FitRect(const GMSRect& r, const GMSRect& work) {
+    int64_t width = max<int64_t>(0, min<int64_t>((int64_t)r.right - r.left, (int64_t)work.right - work.left));
+    int64_t height = max<int64_t>(0, min<int64_t>((int64_t)r.bottom - r.top, (int64_t)work.bottom - work.top));
+    int64_t left = max<int64_t>(work.left, min<int64_t>(r.left, work.right - width));
+    int64_t top = max<int64_t>(work.top, min<int64_t>(r.top, work.bottom - height));
+    return { (int32_t)left, (int32_t)top, (int32_t)(left + width), (int32_t)(top + height) };
+}
+
+void rezol_place_rects(int32_t kernel, const ScreenIndex& index, const vector<PhysicalScreen>& screens,
+                       const GMSRect* rects, WireRectPlacement* out, size_t count) {
+    if (!rezol_simd_supported(kernel)) {
+        kernel = SIMD_SCALAR;
+    }
+
+    // The vector kernels work in int32, fine for any real desktop. Rects are
+    // clamped to one pixel past it, which changes no overlap.
+    int64_t minLeft = INT32_MAX, minTop = INT32_MAX, maxRight = INT32_MIN, maxBottom = INT32_MIN;
+    bool narrow = true;
+    for (size_t i = 0; i < index.left.size(); i++) {
+        minLeft = min<int64_t>(minLeft, index.left[i]);
+        minTop = min<int64_t>(minTop, index.top[i]);
+        maxRight = max<int64_t>(maxRight, index.right[i]);
+        maxBottom = max<int64_t>(maxBottom, index.bottom[i]);
+        int64_t w = (int64_t)index.right[i] - index.left[i];
+        int64_t h = (int64_t)index.bottom[i] - index.top[i];
+        narrow = narrow && w * h <= INT32_MAX;
+    }
+    narrow = narrow && maxRight - minLeft < (1 << 30) && maxBottom - minTop < (1 << 30);
+    if (!narrow) {
+        kernel = SIMD_SCALAR;
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        GMSRect r;
+        memcpy(&r, rects + n, sizeof(r));
+        int32_t screen = -1;
+        int64_t best = 0;
+        if (kernel != SIMD_SCALAR) {
+            GMSRect clamped = {
+                (int32_t)max<int64_t>(minLeft - 1, min<int64_t>(r.left, maxRight + 1)),
+                (int32_t)max<int64_t>(minTop - 1, min<int64_t>(r.top, maxBottom + 1)),
+                (int32_t)max<int64_t>(minLeft - 1, min<int64_t>(r.right, maxRight + 1)),
+                (int32_t)max<int64_t>(minTop - 1, min<int64_t>(r.bottom, maxBottom + 1))
+            };
+#ifdef GMS_X86_SIMD
+            if (kernel == SIMD_AVX2) {
+                OverlapAVX2(index, clamped, screen, best);
+            } else {
+                OverlapSSE2(index, clamped, screen, best);
+            }
+#endif
+        } else {
+            OverlapScalar(index, 0, r, screen, best);
+        }
+
+        WireRectPlacement placement;
+        if (best == 0) {
+            screen = NearestToRect(screens, r);
+        }
+        placement.screen = screen;
+        placement.nearest = (best == 0 && screen >= 0) ? 1 : 0;
+        placement.area = (double)best;
+        placement.rect = (screen >= 0) ? FitRect(r, screens[screen].workingRect) : r;
+        memcpy(out + n, &placement, sizeof(placement));
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef SCREEN_CLASSIFY_H
+#define SCREEN_CLASSIFY_H
+
+#include "screen_index.h"
+#include "screen_simd.h"
+#include "screen_wire.h"
+#include <cstddef>
+
+// Batched point and rect to monitor queries. Points are tested against every
+// monitor's virtualRect, several points per instruction, with the same rules
+// as rezol_index_find: left and top edges are inside, right and bottom are
+// not, the lowest index wins and points on no monitor get -1. The kernel is
+// picked at runtime from what the CPU supports.
+
+// Classify count (x, y) int32 pairs into count int32 monitor indices.
+// Neither buffer needs any particular alignment.
+void rezol_classify_points(int32_t kernel, const ScreenIndex& index, const int32_t* points,
+                           int32_t* out, size_t count);
+
+// For each of count rects, the monitor its virtualRect overlaps most (the
+// lowest index on a tie, the nearest monitor when it overlaps none, as
+// MonitorFromRect does) and the rect fitted into that monitor's workingRect.
+// Placements are written unaligned.
+void rezol_place_rects(int32_t kernel, const ScreenIndex& index, const std::vector<PhysicalScreen>& screens,
+                       const GMSRect* rects, WireRectPlacement* out, size_t count);
+
+#endif // SCREEN_CLASSIFY_H
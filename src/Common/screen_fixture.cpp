@@ -0,0 +1,201 @@
+#include "screen_fixture.h"
+#include "screen_backend.h"
+#include "screen_topology.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// A mapped fixture file, unmapped when the last reference goes. The
+// watcher thread can be enumerating from one while GML loads another, so
+// readers take a reference and the mapping outlives the swap until they
+// are done with it.
+struct FixtureMapping {
+    const char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+
+    FixtureMapping() = default;
+    FixtureMapping(const FixtureMapping&) = delete;
+    FixtureMapping& operator=(const FixtureMapping&) = delete;
+    ~FixtureMapping() {
+#ifdef _WIN32
+        if (base) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+#else
+        if (base) {
+            munmap(const_cast<char*>(base), size);
+        }
+#endif
+    }
+};
+
+// The currently loaded fixture, if any, swapped under fixtureLock
+static mutex fixtureLock;
+static shared_ptr<const FixtureMapping> fixture;
+
+static atomic<bool> fixtureEnvChecked(false);
+
+static shared_ptr<const FixtureMapping> CurrentFixture() {
+    lock_guard<mutex> lock(fixtureLock);
+    return fixture;
+}
+
+static bool FixtureValid(const char* base, size_t size) {
+    if (size < sizeof(FixtureHeader)) {
+        return false;
+    }
+    FixtureHeader header;
+    memcpy(&header, base, sizeof(header));
+    return header.magic == GMSF && header.version == FixtureVersion &&
+           header.recordSize == sizeof(PhysicalScreen) && header.count >= 0 &&
+           size >= sizeof(FixtureHeader) + (size_t)header.count * sizeof(PhysicalScreen);
+}
+
+void rezol_fixture_unload() {
+    shared_ptr<const FixtureMapping> previous;
+    {
+        lock_guard<mutex> lock(fixtureLock);
+        previous.swap(fixture);
+    }
+    if (previous == nullptr) {
+        return;
+    }
+    // Unmapped here, or by an enumeration still reading it once it ends
+    previous.reset();
+    rezol_topology_invalidate();
+}
+
+bool rezol_fixture_load(const char* path) {
+    fixtureEnvChecked = true;
+    shared_ptr<FixtureMapping> next = make_shared<FixtureMapping>();
+#ifdef _WIN32
+    next->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (next->file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(next->file, &fileSize) && fileSize.QuadPart > 0) {
+        next->mapping = CreateFileMappingA(next->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (next->mapping) {
+            next->base = static_cast<const char*>(MapViewOfFile(next->mapping, FILE_MAP_READ, 0, 0, 0));
+            next->size = (size_t)fileSize.QuadPart;
+        }
+    }
+    if (next->base == nullptr) {
+        return false;
+    }
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    next->base = static_cast<const char*>(base);
+    next->size = st.st_size;
+#endif
+    // A malformed file is unmapped again as next goes out of scope
+    if (!FixtureValid(next->base, next->size)) {
+        return false;
+    }
+    shared_ptr<const FixtureMapping> previous;
+    {
+        lock_guard<mutex> lock(fixtureLock);
+        previous = fixture;
+        fixture = next;
+    }
+    previous.reset();
+    rezol_topology_invalidate();
+    return true;
+}
+
+bool rezol_fixture_active() {
+    if (!fixtureEnvChecked.exchange(true)) {
+        const char* path = getenv("GMS_SCREEN_FIXTURE");
+        if (path != nullptr && *path != '\0') {
+            rezol_fixture_load(path);
+        }
+    }
+    return CurrentFixture() != nullptr;
+}
+
+int32_t rezol_fixture_get_virtual_screens(ScreenInfo* info) {
+    // Held until the records are copied out
+    shared_ptr<const FixtureMapping> mapped = CurrentFixture();
+    if (mapped == nullptr) {
+        return 0;
+    }
+    FixtureHeader header;
+    memcpy(&header, mapped->base, sizeof(header));
+    info->autoHideTaskbar = header.autoHideTaskbar;
+
+    const char* record = mapped->base + sizeof(FixtureHeader);
+    for (int32_t i = 0; i < header.count; i++) {
+        if (info->count >= info->maxCount) {
+            info->more = true;
+            break;
+        }
+        memcpy(&info->screen[info->count], record, sizeof(PhysicalScreen));
+        info->count++;
+        record += sizeof(PhysicalScreen);
+    }
+    return 1;
+}
+
+bool rezol_fixture_write(const char* path, const PhysicalScreen* screens, int32_t count, int32_t autoHideTaskbar) {
+    FILE* out = fopen(path, "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    FixtureHeader header;
+    header.magic = GMSF;
+    header.version = FixtureVersion;
+    header.recordSize = sizeof(PhysicalScreen);
+    header.count = count;
+    header.autoHideTaskbar = autoHideTaskbar;
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    if (ok && count > 0) {
+        ok = fwrite(screens, sizeof(PhysicalScreen), count, out) == (size_t)count;
+    }
+    return (fclose(out) == 0) && ok;
+}
+
+bool rezol_fixture_record(const char* path) {
+    vector<PhysicalScreen> screens;
+    int32_t autoHideTaskbar = 0;
+    if (!rezol_enumerate_all(&rezol_platform_get_virtual_screens, screens, autoHideTaskbar)) {
+        return false;
+    }
+    return rezol_fixture_write(path, screens.data(), (int32_t)screens.size(), autoHideTaskbar);
+}
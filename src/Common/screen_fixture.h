@@ -0,0 +1,45 @@
+#ifndef SCREEN_FIXTURE_H
+#define SCREEN_FIXTURE_H
+
+#include "screen_utils.h"
+
+// Recorded display topologies. A fixture file is a FixtureHeader followed
+// by header.count raw PhysicalScreen records, little-endian as written by
+// every platform we build for. Loading maps the file and serves the
+// records straight out of the mapping, nothing is parsed or allocated.
+
+constexpr uint32_t GMSF = 0x46534D47; // "GMSF" read as little-endian bytes
+constexpr uint16_t FixtureVersion = 2;
+
+struct FixtureHeader {
+    uint32_t magic;           // GMSF
+    uint16_t version;         // FixtureVersion
+    uint16_t recordSize;      // sizeof(PhysicalScreen) when written
+    int32_t  count;
+    int32_t  autoHideTaskbar;
+};
+
+static_assert(sizeof(FixtureHeader) == 16, "FixtureHeader must stay 16 bytes");
+static_assert(sizeof(PhysicalScreen) % 4 == 0, "PhysicalScreen records must stay 4 byte aligned");
+
+// Map a fixture so __internal_get_virtual_screens serves it instead of the
+// OS. Returns false (and leaves any previous fixture loaded) if the file is
+// missing or malformed. The GMS_SCREEN_FIXTURE environment variable loads
+// one automatically on the first query. Loading and unloading are safe
+// while another thread enumerates; a replaced fixture stays mapped until
+// that enumeration has copied its records out.
+bool rezol_fixture_load(const char* path);
+void rezol_fixture_unload();
+bool rezol_fixture_active();
+
+// Serve the loaded fixture the same way a platform backend would
+int32_t rezol_fixture_get_virtual_screens(ScreenInfo* info);
+
+// Write records to a fixture file
+bool rezol_fixture_write(const char* path, const PhysicalScreen* screens, int32_t count, int32_t autoHideTaskbar);
+
+// Run the live platform backend, ignoring any loaded fixture, and save
+// its result
+bool rezol_fixture_record(const char* path);
+
+#endif // SCREEN_FIXTURE_H
@@ -0,0 +1,149 @@
+#include "screen_index.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+static bool HasArea(const GMSRect& r) {
+    return r.right > r.left && r.bottom > r.top;
+}
+
+void rezol_index_build(ScreenIndex& index, const vector<PhysicalScreen>& screens) {
+    index.edges.clear();
+    index.slabStart.clear();
+    index.spans.clear();
+    index.left.clear();
+    index.top.clear();
+    index.right.clear();
+    index.bottom.clear();
+    for (const PhysicalScreen& s : screens) {
+        index.left.push_back(s.virtualRect.left);
+        index.top.push_back(s.virtualRect.top);
+        index.right.push_back(s.virtualRect.right);
+        index.bottom.push_back(s.virtualRect.bottom);
+    }
+
+    for (const PhysicalScreen& s : screens) {
+        if (HasArea(s.virtualRect)) {
+            index.edges.push_back(s.virtualRect.left);
+            index.edges.push_back(s.virtualRect.right);
+        }
+    }
+    sort(index.edges.begin(), index.edges.end());
+    index.edges.erase(unique(index.edges.begin(), index.edges.end()), index.edges.end());
+
+    vector<int32_t> rows;
+    for (size_t slab = 0; slab + 1 < index.edges.size(); slab++) {
+        index.slabStart.push_back((uint32_t)index.spans.size());
+        int32_t left = index.edges[slab];
+        int32_t right = index.edges[slab + 1];
+
+        // Row edges of every monitor crossing this slab
+        rows.clear();
+        for (const PhysicalScreen& s : screens) {
+            const GMSRect& r = s.virtualRect;
+            if (HasArea(r) && r.left <= left && r.right >= right) {
+                rows.push_back(r.top);
+                rows.push_back(r.bottom);
+            }
+        }
+        sort(rows.begin(), rows.end());
+        rows.erase(unique(rows.begin(), rows.end()), rows.end());
+
+        // Lowest index covering each row, neighbours with the same owner merged
+        for (size_t row = 0; row + 1 < rows.size(); row++) {
+            int32_t owner = -1;
+            for (size_t i = 0; i < screens.size() && owner < 0; i++) {
+                const GMSRect& r = screens[i].virtualRect;
+                if (HasArea(r) && r.left <= left && r.right >= right && r.top <= rows[row] && r.bottom >= rows[row + 1]) {
+                    owner = (int32_t)i;
+                }
+            }
+            if (owner < 0) {
+                continue;
+            }
+            if (index.spans.size() > index.slabStart.back() && index.spans.back().screen == owner &&
+                index.spans.back().bottom == rows[row]) {
+                index.spans.back().bottom = rows[row + 1];
+            } else {
+                index.spans.push_back({ rows[row], rows[row + 1], owner });
+            }
+        }
+    }
+    index.slabStart.push_back((uint32_t)index.spans.size());
+}
+
+int32_t rezol_index_find(const ScreenIndex& index, int32_t x, int32_t y) {
+    auto edge = upper_bound(index.edges.begin(), index.edges.end(), x);
+    if (edge == index.edges.begin() || edge == index.edges.end()) {
+        return -1;
+    }
+    size_t slab = (edge - index.edges.begin()) - 1;
+    auto first = index.spans.begin() + index.slabStart[slab];
+    auto last = index.spans.begin() + index.slabStart[slab + 1];
+    auto span = upper_bound(first, last, y, [](int32_t v, const ScreenSpan& s) { return v < s.top; });
+    if (span == first) {
+        return -1;
+    }
+    --span;
+    return (y < span->bottom) ? span->screen : -1;
+}
+
+// Keep the span nearer to the point, or the lower monitor index on a tie
+static void Closer(int64_t dx, int64_t dy, int32_t screen, int64_t& best, int32_t& found) {
+    int64_t distance = dx * dx + dy * dy;
+    if (distance < best || (distance == best && screen < found)) {
+        best = distance;
+        found = screen;
+    }
+}
+
+// Try the spans of one slab: the last one starting at or above y and the
+// first one starting below it, the only two that can be nearest
+static void NearestInSlab(const ScreenIndex& index, size_t slab, int64_t dx, int32_t y,
+                          int64_t& best, int32_t& found) {
+    auto first = index.spans.begin() + index.slabStart[slab];
+    auto last = index.spans.begin() + index.slabStart[slab + 1];
+    auto below = upper_bound(first, last, y, [](int32_t v, const ScreenSpan& s) { return v < s.top; });
+    if (below != last) {
+        Closer(dx, (int64_t)below->top - y, below->screen, best, found);
+    }
+    if (below != first) {
+        auto above = below - 1;
+        Closer(dx, (y < above->bottom) ? 0 : (int64_t)y - (above->bottom - 1), above->screen, best, found);
+    }
+}
+
+// Spans only record the lowest index covering each pixel. The nearest
+// pixel of the monitor a scan would pick is never covered by a lower
+// index (that one would be as near and win the tie), so the nearest span
+// with the lowest owner on a tie is the same answer.
+int32_t rezol_index_find_nearest(const ScreenIndex& index, int32_t x, int32_t y) {
+    int32_t found = rezol_index_find(index, x, y);
+    if (found >= 0 || index.edges.size() < 2) {
+        return found;
+    }
+    size_t slabs = index.edges.size() - 1;
+    // The slab under x, or the outermost one on that side
+    size_t start = upper_bound(index.edges.begin(), index.edges.end(), x) - index.edges.begin();
+    start = (start == 0) ? 0 : min(start - 1, slabs - 1);
+
+    int64_t best = INT64_MAX;
+    for (size_t slab = start + 1; slab-- > 0;) {
+        // Distance to the nearest column of the slab, growing to the left
+        int64_t dx = (x >= index.edges[slab + 1]) ? (int64_t)x - (index.edges[slab + 1] - 1)
+                   : (x < index.edges[slab]) ? (int64_t)index.edges[slab] - x : 0;
+        if (dx * dx > best) {
+            break;
+        }
+        NearestInSlab(index, slab, dx, y, best, found);
+    }
+    for (size_t slab = start + 1; slab < slabs; slab++) {
+        int64_t dx = (x < index.edges[slab]) ? (int64_t)index.edges[slab] - x : 0;
+        if (dx * dx > best) {
+            break;
+        }
+        NearestInSlab(index, slab, dx, y, best, found);
+    }
+    return found;
+}
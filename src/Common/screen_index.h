@@ -0,0 +1,42 @@
+#ifndef SCREEN_INDEX_H
+#define SCREEN_INDEX_H
+
+#include "screen_utils.h"
+#include <vector>
+
+// Point-to-monitor lookup over virtualRect, built once per topology
+// snapshot. The virtual desktop is cut into vertical slabs at every
+// monitor's left and right edge, and each slab holds the sorted, disjoint
+// vertical spans of the monitors crossing it, so a lookup is two binary
+// searches. Rects contain their left and top edges but not their right and
+// bottom ones, and where monitors overlap (mirroring) the lower index wins,
+// as with MonitorFromPoint.
+
+struct ScreenSpan {
+    int32_t top;
+    int32_t bottom;
+    int32_t screen;
+};
+
+struct ScreenIndex {
+    std::vector<int32_t>    edges;     // slab i runs from edges[i] to edges[i + 1]
+    std::vector<uint32_t>   slabStart; // spans of slab i are spans[slabStart[i]..slabStart[i + 1])
+    std::vector<ScreenSpan> spans;
+    // virtualRect as columns, for the batched kernels in screen_classify.h
+    std::vector<int32_t>    left, top, right, bottom;
+};
+
+void rezol_index_build(ScreenIndex& index, const std::vector<PhysicalScreen>& screens);
+
+// Monitor containing the point, or -1
+int32_t rezol_index_find(const ScreenIndex& index, int32_t x, int32_t y);
+
+// Monitor containing the point, else the one nearest to it like
+// MONITOR_DEFAULTTONEAREST, or -1 when there are no monitors. Off every
+// monitor the slabs are walked outwards from x, each with one binary
+// search, until they are further away than the best span so far. A point
+// in a gap or on a bezel stops after a few slabs. One far above or below
+// the desktop can visit every slab nearer than the distance it is off.
+int32_t rezol_index_find_nearest(const ScreenIndex& index, int32_t x, int32_t y);
+
+#endif // SCREEN_INDEX_H
@@ -0,0 +1,93 @@
+#include "screen_mirror.h"
+#include "screen_wire.h"
+#include "screen_trace.h"
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// The sequence is updated in place inside the GML buffer
+static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "atomic<uint32_t> must be a plain 32 bit word");
+
+static mutex mirrorLock;
+static char* mirrorBuf = nullptr;
+static uint64_t mirrorGeneration = 0;
+static vector<char> mirrorStaging;
+static atomic<bool> mirrorActive(false);
+
+static atomic<uint32_t>* Sequence(char* buf) {
+    return reinterpret_cast<atomic<uint32_t>*>(buf + offsetof(MirrorHeader, sequence));
+}
+
+// Serialize outside the odd window into the staging buffer so the reader
+// only ever waits out one memcpy. Called with mirrorLock held, which also
+// makes this the only writer.
+static void WriteMirror(const TopologySnapshot& topology) {
+    size_t written = rezol_write_screen_info(mirrorStaging.data(), mirrorStaging.size(), topology, 0, INT32_MAX,
+                                             rezol_wire_format());
+    if (written == 0) {
+        return;
+    }
+    double generation = (double)topology.generation;
+    uint32_t size = (uint32_t)written;
+
+    atomic<uint32_t>* sequence = Sequence(mirrorBuf);
+    uint32_t seq = sequence->load(memory_order_relaxed);
+    sequence->store(seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    memcpy(mirrorBuf + offsetof(MirrorHeader, size), &size, sizeof(size));
+    memcpy(mirrorBuf + offsetof(MirrorHeader, generation), &generation, sizeof(generation));
+    memcpy(mirrorBuf + sizeof(MirrorHeader), mirrorStaging.data(), written);
+
+    sequence->store(seq + 2, memory_order_release);
+    mirrorGeneration = topology.generation;
+}
+
+bool rezol_mirror_register(char* buf, size_t size) {
+    // Room for at least the SCREENINFO header and fourcc
+    size_t minimum = (size_t)rezol_ext_get_buffer_size(SCREENINFOHEADER) + sizeof(uint32_t);
+    if (buf == nullptr || size < sizeof(MirrorHeader) + minimum) {
+        return false;
+    }
+    size_t payload = size - sizeof(MirrorHeader);
+    // Enumerate before taking the lock, the topology publishes with its
+    // own lock held and then takes ours
+    TopologyRef topology = rezol_topology_current();
+
+    lock_guard<mutex> lock(mirrorLock);
+    mirrorBuf = buf;
+    mirrorGeneration = 0;
+    mirrorStaging.assign(payload, 0);
+    Sequence(mirrorBuf)->store(0, memory_order_relaxed);
+    mirrorActive = true;
+    WriteMirror(*topology);
+    return true;
+}
+
+void rezol_mirror_unregister() {
+    lock_guard<mutex> lock(mirrorLock);
+    mirrorActive = false;
+    mirrorBuf = nullptr;
+    mirrorGeneration = 0;
+}
+
+bool rezol_mirror_active() {
+    return mirrorActive;
+}
+
+void rezol_mirror_publish(const TopologySnapshot& topology) {
+    if (!mirrorActive) {
+        return;
+    }
+    REZOL_TRACE_SCOPE("mirror_publish");
+    lock_guard<mutex> lock(mirrorLock);
+    // A snapshot taken before a newer one was already mirrored
+    if (mirrorBuf == nullptr || topology.generation < mirrorGeneration) {
+        return;
+    }
+    WriteMirror(topology);
+}
@@ -0,0 +1,40 @@
+#ifndef SCREEN_MIRROR_H
+#define SCREEN_MIRROR_H
+
+#include "screen_utils.h"
+#include "screen_topology.h"
+
+// A GML buffer registered once and kept up to date by the library. Every
+// new topology is written straight into it, so reading the monitors each
+// frame needs no extension call at all.
+//
+// Layout: a MirrorHeader followed by the SCREENINFO payload exactly as
+// rezol_ext_get_screen_info writes it. Writes are guarded seqlock style:
+// the sequence is odd while a write is in progress and bumped again when
+// it is done. A reader peeks the sequence, copies what it needs, peeks it
+// again and retries unless both were the same even number.
+
+struct MirrorHeader {
+    uint32_t sequence;    // odd while the payload is being written
+    uint32_t size;        // bytes of payload written after the header
+    double   generation;  // generation of the topology in the payload
+};
+
+static_assert(sizeof(MirrorHeader) == 16, "MirrorHeader must stay 16 bytes");
+
+// Start mirroring into buf, writing the current topology straight away.
+// A buffer too small for every monitor gets as many as fit with more set,
+// size it with rezol_ext_get_buffer_size(SCREENMIRROR). Returns false if
+// size cannot even hold the headers. Registering again replaces the
+// previous buffer.
+bool rezol_mirror_register(char* buf, size_t size);
+
+// Stop writing. Once this returns the buffer can be freed.
+void rezol_mirror_unregister();
+bool rezol_mirror_active();
+
+// Write a snapshot into the registered buffer, if any. Older generations
+// than the one already mirrored are ignored.
+void rezol_mirror_publish(const TopologySnapshot& topology);
+
+#endif // SCREEN_MIRROR_H
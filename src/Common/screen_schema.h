@@ -0,0 +1,474 @@
+#ifndef SCREEN_SCHEMA_H
+#define SCREEN_SCHEMA_H
+
+#include "screen_utils.h"
+#include "screen_mirror.h"
+#include "screen_wire.h"
+#include "screen_stats.h"
+#include <cstddef>
+
+// The one description of every buffer GML reads. Offsets and sizes are
+// worked out at compile time from the field lists below, the structs the
+// library writes are checked against them, and GMSSchemaGen turns the
+// same lists into a GML decode script of fixed buffer_peek offsets. To
+// change a layout, change it here and in the struct; the build fails
+// until both agree.
+
+enum SchemaType {
+    SCHEMA_U8,
+    SCHEMA_U16,
+    SCHEMA_S32,
+    SCHEMA_U32,
+    SCHEMA_F64,
+    SCHEMA_STRING    // fixed size, nul terminated char array
+};
+
+struct SchemaField {
+    const char* name;
+    SchemaType  type;
+    size_t      count;   // bytes for SCHEMA_STRING, else 1
+};
+
+constexpr size_t rezol_schema_type_size(SchemaType type) {
+    return (type == SCHEMA_U8) ? 1 :
+           (type == SCHEMA_U16) ? 2 :
+           (type == SCHEMA_F64) ? 8 :
+           (type == SCHEMA_STRING) ? 1 : 4;
+}
+
+constexpr size_t rezol_schema_field_size(const SchemaField& field) {
+    return rezol_schema_type_size(field.type) * field.count;
+}
+
+// Byte offset of field index in a packed record
+template<size_t N>
+constexpr size_t rezol_schema_offset(const SchemaField (&fields)[N], size_t index) {
+    size_t offset = 0;
+    for (size_t i = 0; i < index && i < N; i++) {
+        offset += rezol_schema_field_size(fields[i]);
+    }
+    return offset;
+}
+
+template<size_t N>
+constexpr size_t rezol_schema_size(const SchemaField (&fields)[N]) {
+    return rezol_schema_offset(fields, N);
+}
+
+constexpr bool rezol_schema_same_name(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Index of a field (or group) by name, N if there is none
+template<typename Entry, size_t N>
+constexpr size_t rezol_schema_index(const Entry (&fields)[N], const char* name) {
+    for (size_t i = 0; i < N; i++) {
+        if (rezol_schema_same_name(fields[i].name, name)) {
+            return i;
+        }
+    }
+    return N;
+}
+
+template<size_t N>
+constexpr size_t rezol_schema_offset(const SchemaField (&fields)[N], const char* name) {
+    return rezol_schema_offset(fields, rezol_schema_index(fields, name));
+}
+
+// --- Layouts ---
+
+constexpr SchemaField PhysicalScreenSchema[] = {
+    { "errorCode",     SCHEMA_S32, 1 },
+    { "refreshRate",   SCHEMA_S32, 1 },
+    { "isPrimary",     SCHEMA_S32, 1 },
+    { "pixelWidth",    SCHEMA_S32, 1 },
+    { "pixelHeight",   SCHEMA_S32, 1 },
+    { "virtualLeft",   SCHEMA_S32, 1 },
+    { "virtualTop",    SCHEMA_S32, 1 },
+    { "virtualRight",  SCHEMA_S32, 1 },
+    { "virtualBottom", SCHEMA_S32, 1 },
+    { "workingLeft",   SCHEMA_S32, 1 },
+    { "workingTop",    SCHEMA_S32, 1 },
+    { "workingRight",  SCHEMA_S32, 1 },
+    { "workingBottom", SCHEMA_S32, 1 },
+    { "physWidth",     SCHEMA_S32, 1 },
+    { "physHeight",    SCHEMA_S32, 1 },
+    { "physDiagonal",  SCHEMA_S32, 1 },
+    { "name",          SCHEMA_STRING, MONITOR_NAME_BUFFER_SIZE },
+    { "effectiveDpiX", SCHEMA_S32, 1 },
+    { "effectiveDpiY", SCHEMA_S32, 1 },
+    { "rawDpiX",       SCHEMA_S32, 1 },
+    { "rawDpiY",       SCHEMA_S32, 1 },
+    { "scale",         SCHEMA_F64, 1 }
+};
+
+constexpr SchemaField ScreenInfoV1Schema[] = {
+    { "count",           SCHEMA_S32, 1 },
+    { "maxCount",        SCHEMA_S32, 1 },
+    { "fromScreen",      SCHEMA_S32, 1 },
+    { "pageNum",         SCHEMA_S32, 1 },
+    { "autoHideTaskbar", SCHEMA_S32, 1 },
+    { "more",            SCHEMA_U8,  1 },
+    { "versionMajor",    SCHEMA_U8,  1 },
+    { "versionMinor",    SCHEMA_U8,  1 },
+    { "versionBuild",    SCHEMA_U8,  1 }
+};
+
+constexpr SchemaField ScreenInfoV2Schema[] = {
+    { "magic",           SCHEMA_U32, 1 },
+    { "format",          SCHEMA_U16, 1 },
+    { "headerSize",      SCHEMA_U16, 1 },
+    { "recordSize",      SCHEMA_U16, 1 },
+    { "reserved",        SCHEMA_U16, 1 },
+    { "count",           SCHEMA_S32, 1 },
+    { "maxCount",        SCHEMA_S32, 1 },
+    { "fromScreen",      SCHEMA_S32, 1 },
+    { "pageNum",         SCHEMA_S32, 1 },
+    { "autoHideTaskbar", SCHEMA_S32, 1 },
+    { "more",            SCHEMA_U8,  1 },
+    { "versionMajor",    SCHEMA_U8,  1 },
+    { "versionMinor",    SCHEMA_U8,  1 },
+    { "versionBuild",    SCHEMA_U8,  1 },
+    { "totalSize",       SCHEMA_U32, 1 }
+};
+
+constexpr SchemaField WindowChromeSchema[] = {
+    { "outerLeft",   SCHEMA_S32, 1 },
+    { "outerTop",    SCHEMA_S32, 1 },
+    { "outerRight",  SCHEMA_S32, 1 },
+    { "outerBottom", SCHEMA_S32, 1 },
+    { "innerLeft",   SCHEMA_S32, 1 },
+    { "innerTop",    SCHEMA_S32, 1 },
+    { "innerRight",  SCHEMA_S32, 1 },
+    { "innerBottom", SCHEMA_S32, 1 },
+    { "fourcc",      SCHEMA_U32, 1 }
+};
+
+constexpr SchemaField MirrorHeaderSchema[] = {
+    { "sequence",   SCHEMA_U32, 1 },
+    { "size",       SCHEMA_U32, 1 },
+    { "generation", SCHEMA_F64, 1 }
+};
+
+constexpr SchemaField ScreenChangesSchema[] = {
+    { "magic",           SCHEMA_U32, 1 },
+    { "full",            SCHEMA_U8,  1 },
+    { "taskbarChanged",  SCHEMA_U8,  1 },
+    { "recordCount",     SCHEMA_U16, 1 },
+    { "screenCount",     SCHEMA_S32, 1 },
+    { "autoHideTaskbar", SCHEMA_S32, 1 },
+    { "sinceGeneration", SCHEMA_F64, 1 },
+    { "generation",      SCHEMA_F64, 1 },
+    { "totalSize",       SCHEMA_U32, 1 }
+};
+
+constexpr SchemaField ScreenChangeRecordSchema[] = {
+    { "kind",     SCHEMA_U8,  1 },
+    { "reserved", SCHEMA_U8,  1 },
+    { "mask",     SCHEMA_U16, 1 },
+    { "index",    SCHEMA_S32, 1 }
+};
+
+constexpr SchemaField RectPlacementSchema[] = {
+    { "screen",  SCHEMA_S32, 1 },
+    { "nearest", SCHEMA_S32, 1 },
+    { "area",    SCHEMA_F64, 1 },
+    { "left",    SCHEMA_S32, 1 },
+    { "top",     SCHEMA_S32, 1 },
+    { "right",   SCHEMA_S32, 1 },
+    { "bottom",  SCHEMA_S32, 1 }
+};
+
+constexpr SchemaField StatsHeaderSchema[] = {
+    { "magic",      SCHEMA_U32, 1 },
+    { "enabled",    SCHEMA_U8,  1 },
+    { "stageCount", SCHEMA_U8,  1 },
+    { "recordSize", SCHEMA_U16, 1 }
+};
+
+constexpr SchemaField StageStatsSchema[] = {
+    { "calls",   SCHEMA_F64, 1 },
+    { "totalUs", SCHEMA_F64, 1 },
+    { "lastUs",  SCHEMA_F64, 1 },
+    { "maxUs",   SCHEMA_F64, 1 }
+};
+
+// A change record carries whole groups of PhysicalScreen fields, bit i of
+// its mask standing for group i. Each group is a run of fields.
+struct SchemaGroup {
+    const char* name;
+    const char* firstField;
+    size_t      fieldCount;
+};
+
+constexpr SchemaGroup ScreenChangeGroups[] = {
+    { "errorCode",   "errorCode",   1 },
+    { "refreshRate", "refreshRate", 1 },
+    { "isPrimary",   "isPrimary",   1 },
+    { "pixelBox",    "pixelWidth",  2 },
+    { "virtualRect", "virtualLeft", 4 },
+    { "workingRect", "workingLeft", 4 },
+    { "physSize",    "physWidth",   3 },
+    { "name",        "name",        1 },
+    { "dpi",         "effectiveDpiX", 4 },
+    { "scale",       "scale",       1 }
+};
+
+constexpr size_t SCHEMA_GROUP_COUNT = sizeof(ScreenChangeGroups) / sizeof(ScreenChangeGroups[0]);
+constexpr uint16_t SCHEMA_GROUP_ALL = (uint16_t)((1u << SCHEMA_GROUP_COUNT) - 1);
+
+constexpr size_t rezol_schema_group_offset(size_t group) {
+    return rezol_schema_offset(PhysicalScreenSchema, ScreenChangeGroups[group].firstField);
+}
+
+constexpr size_t rezol_schema_group_size(size_t group) {
+    return rezol_schema_offset(PhysicalScreenSchema,
+                               rezol_schema_index(PhysicalScreenSchema, ScreenChangeGroups[group].firstField) +
+                               ScreenChangeGroups[group].fieldCount) -
+           rezol_schema_group_offset(group);
+}
+
+// The groups must cover the record end to end, in order
+constexpr bool rezol_schema_groups_cover_record() {
+    size_t offset = 0;
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        if (rezol_schema_group_offset(g) != offset) {
+            return false;
+        }
+        offset += rezol_schema_group_size(g);
+    }
+    return offset == rezol_schema_size(PhysicalScreenSchema);
+}
+
+static_assert(SCHEMA_GROUP_COUNT <= 16, "change mask is 16 bits");
+static_assert(rezol_schema_groups_cover_record(), "ScreenChangeGroups must cover PhysicalScreen in order");
+
+// Trailer after the last record of a SCREENINFO buffer
+constexpr size_t SCHEMA_FOURCC_SIZE = sizeof(uint32_t);
+// V2 offset table entry
+constexpr size_t SCHEMA_OFFSET_SIZE = sizeof(uint32_t);
+
+// --- Checks against the structs the library writes ---
+
+// Where a named field of a layout really is in the struct written for it
+struct SchemaMember {
+    const char* name;
+    size_t      offset;
+    size_t      size;
+};
+
+#define SCHEMA_MEMBER(type, member) \
+    { #member, offsetof(type, member), sizeof(type::member) }
+#define SCHEMA_NESTED(name, type, member, inner, field) \
+    { name, offsetof(type, member) + offsetof(inner, field), sizeof(inner::field) }
+
+// Every field of a layout against the struct member of the same name, in
+// order, so adding, dropping, moving or renaming a field on either side
+// fails the build
+template<size_t N, size_t M>
+constexpr bool rezol_schema_matches(const SchemaField (&fields)[N], const SchemaMember (&members)[M], size_t size) {
+    if (N != M || rezol_schema_size(fields) != size) {
+        return false;
+    }
+    for (size_t i = 0; i < N; i++) {
+        if (!rezol_schema_same_name(fields[i].name, members[i].name) ||
+            rezol_schema_offset(fields, i) != members[i].offset ||
+            rezol_schema_field_size(fields[i]) != members[i].size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr SchemaMember PhysicalScreenMembers[] = {
+    SCHEMA_MEMBER(PhysicalScreen, errorCode),
+    SCHEMA_MEMBER(PhysicalScreen, refreshRate),
+    SCHEMA_MEMBER(PhysicalScreen, isPrimary),
+    SCHEMA_NESTED("pixelWidth", PhysicalScreen, pixelBox, GMSBox, width),
+    SCHEMA_NESTED("pixelHeight", PhysicalScreen, pixelBox, GMSBox, height),
+    SCHEMA_NESTED("virtualLeft", PhysicalScreen, virtualRect, GMSRect, left),
+    SCHEMA_NESTED("virtualTop", PhysicalScreen, virtualRect, GMSRect, top),
+    SCHEMA_NESTED("virtualRight", PhysicalScreen, virtualRect, GMSRect, right),
+    SCHEMA_NESTED("virtualBottom", PhysicalScreen, virtualRect, GMSRect, bottom),
+    SCHEMA_NESTED("workingLeft", PhysicalScreen, workingRect, GMSRect, left),
+    SCHEMA_NESTED("workingTop", PhysicalScreen, workingRect, GMSRect, top),
+    SCHEMA_NESTED("workingRight", PhysicalScreen, workingRect, GMSRect, right),
+    SCHEMA_NESTED("workingBottom", PhysicalScreen, workingRect, GMSRect, bottom),
+    SCHEMA_NESTED("physWidth", PhysicalScreen, physSize, PhysicalSize, width),
+    SCHEMA_NESTED("physHeight", PhysicalScreen, physSize, PhysicalSize, height),
+    SCHEMA_NESTED("physDiagonal", PhysicalScreen, physSize, PhysicalSize, diagonal),
+    SCHEMA_MEMBER(PhysicalScreen, name),
+    SCHEMA_NESTED("effectiveDpiX", PhysicalScreen, dpi, ScreenDPI, effectiveX),
+    SCHEMA_NESTED("effectiveDpiY", PhysicalScreen, dpi, ScreenDPI, effectiveY),
+    SCHEMA_NESTED("rawDpiX", PhysicalScreen, dpi, ScreenDPI, rawX),
+    SCHEMA_NESTED("rawDpiY", PhysicalScreen, dpi, ScreenDPI, rawY),
+    SCHEMA_MEMBER(PhysicalScreen, scale)
+};
+
+constexpr SchemaMember WireHeaderV1Members[] = {
+    SCHEMA_MEMBER(WireHeaderV1, count),
+    SCHEMA_MEMBER(WireHeaderV1, maxCount),
+    SCHEMA_MEMBER(WireHeaderV1, fromScreen),
+    SCHEMA_MEMBER(WireHeaderV1, pageNum),
+    SCHEMA_MEMBER(WireHeaderV1, autoHideTaskbar),
+    SCHEMA_MEMBER(WireHeaderV1, more),
+    SCHEMA_MEMBER(WireHeaderV1, versionMajor),
+    SCHEMA_MEMBER(WireHeaderV1, versionMinor),
+    SCHEMA_MEMBER(WireHeaderV1, versionBuild)
+};
+
+constexpr SchemaMember WireHeaderV2Members[] = {
+    SCHEMA_MEMBER(WireHeaderV2, magic),
+    SCHEMA_MEMBER(WireHeaderV2, format),
+    SCHEMA_MEMBER(WireHeaderV2, headerSize),
+    SCHEMA_MEMBER(WireHeaderV2, recordSize),
+    SCHEMA_MEMBER(WireHeaderV2, reserved),
+    SCHEMA_MEMBER(WireHeaderV2, count),
+    SCHEMA_MEMBER(WireHeaderV2, maxCount),
+    SCHEMA_MEMBER(WireHeaderV2, fromScreen),
+    SCHEMA_MEMBER(WireHeaderV2, pageNum),
+    SCHEMA_MEMBER(WireHeaderV2, autoHideTaskbar),
+    SCHEMA_MEMBER(WireHeaderV2, more),
+    SCHEMA_MEMBER(WireHeaderV2, versionMajor),
+    SCHEMA_MEMBER(WireHeaderV2, versionMinor),
+    SCHEMA_MEMBER(WireHeaderV2, versionBuild),
+    SCHEMA_MEMBER(WireHeaderV2, totalSize)
+};
+
+constexpr SchemaMember WindowChromeMembers[] = {
+    SCHEMA_NESTED("outerLeft", WindowChrome, outerRect, GMSRect, left),
+    SCHEMA_NESTED("outerTop", WindowChrome, outerRect, GMSRect, top),
+    SCHEMA_NESTED("outerRight", WindowChrome, outerRect, GMSRect, right),
+    SCHEMA_NESTED("outerBottom", WindowChrome, outerRect, GMSRect, bottom),
+    SCHEMA_NESTED("innerLeft", WindowChrome, innerRect, GMSRect, left),
+    SCHEMA_NESTED("innerTop", WindowChrome, innerRect, GMSRect, top),
+    SCHEMA_NESTED("innerRight", WindowChrome, innerRect, GMSRect, right),
+    SCHEMA_NESTED("innerBottom", WindowChrome, innerRect, GMSRect, bottom),
+    SCHEMA_MEMBER(WindowChrome, fourcc)
+};
+
+constexpr SchemaMember MirrorHeaderMembers[] = {
+    SCHEMA_MEMBER(MirrorHeader, sequence),
+    SCHEMA_MEMBER(MirrorHeader, size),
+    SCHEMA_MEMBER(MirrorHeader, generation)
+};
+
+constexpr SchemaMember WireChangesHeaderMembers[] = {
+    SCHEMA_MEMBER(WireChangesHeader, magic),
+    SCHEMA_MEMBER(WireChangesHeader, full),
+    SCHEMA_MEMBER(WireChangesHeader, taskbarChanged),
+    SCHEMA_MEMBER(WireChangesHeader, recordCount),
+    SCHEMA_MEMBER(WireChangesHeader, screenCount),
+    SCHEMA_MEMBER(WireChangesHeader, autoHideTaskbar),
+    SCHEMA_MEMBER(WireChangesHeader, sinceGeneration),
+    SCHEMA_MEMBER(WireChangesHeader, generation),
+    SCHEMA_MEMBER(WireChangesHeader, totalSize)
+};
+
+constexpr SchemaMember WireChangeRecordMembers[] = {
+    SCHEMA_MEMBER(WireChangeRecord, kind),
+    SCHEMA_MEMBER(WireChangeRecord, reserved),
+    SCHEMA_MEMBER(WireChangeRecord, mask),
+    SCHEMA_MEMBER(WireChangeRecord, index)
+};
+
+constexpr SchemaMember WireRectPlacementMembers[] = {
+    SCHEMA_MEMBER(WireRectPlacement, screen),
+    SCHEMA_MEMBER(WireRectPlacement, nearest),
+    SCHEMA_MEMBER(WireRectPlacement, area),
+    SCHEMA_NESTED("left", WireRectPlacement, rect, GMSRect, left),
+    SCHEMA_NESTED("top", WireRectPlacement, rect, GMSRect, top),
+    SCHEMA_NESTED("right", WireRectPlacement, rect, GMSRect, right),
+    SCHEMA_NESTED("bottom", WireRectPlacement, rect, GMSRect, bottom)
+};
+
+constexpr SchemaMember WireStatsHeaderMembers[] = {
+    SCHEMA_MEMBER(WireStatsHeader, magic),
+    SCHEMA_MEMBER(WireStatsHeader, enabled),
+    SCHEMA_MEMBER(WireStatsHeader, stageCount),
+    SCHEMA_MEMBER(WireStatsHeader, recordSize)
+};
+
+constexpr SchemaMember WireStageStatsMembers[] = {
+    SCHEMA_MEMBER(WireStageStats, calls),
+    SCHEMA_MEMBER(WireStageStats, totalUs),
+    SCHEMA_MEMBER(WireStageStats, lastUs),
+    SCHEMA_MEMBER(WireStageStats, maxUs)
+};
+
+#undef SCHEMA_MEMBER
+#undef SCHEMA_NESTED
+
+static_assert(rezol_schema_matches(PhysicalScreenSchema, PhysicalScreenMembers, sizeof(PhysicalScreen)),
+              "PhysicalScreen differs from its schema");
+static_assert(rezol_schema_matches(ScreenInfoV1Schema, WireHeaderV1Members, sizeof(WireHeaderV1)),
+              "WireHeaderV1 differs from its schema");
+static_assert(rezol_schema_matches(ScreenInfoV2Schema, WireHeaderV2Members, sizeof(WireHeaderV2)),
+              "WireHeaderV2 differs from its schema");
+static_assert(rezol_schema_matches(WindowChromeSchema, WindowChromeMembers, sizeof(WindowChrome)),
+              "WindowChrome differs from its schema");
+static_assert(rezol_schema_matches(MirrorHeaderSchema, MirrorHeaderMembers, sizeof(MirrorHeader)),
+              "MirrorHeader differs from its schema");
+static_assert(rezol_schema_matches(ScreenChangesSchema, WireChangesHeaderMembers, sizeof(WireChangesHeader)),
+              "WireChangesHeader differs from its schema");
+static_assert(rezol_schema_matches(ScreenChangeRecordSchema, WireChangeRecordMembers, sizeof(WireChangeRecord)),
+              "WireChangeRecord differs from its schema");
+static_assert(rezol_schema_matches(RectPlacementSchema, WireRectPlacementMembers, sizeof(WireRectPlacement)),
+              "WireRectPlacement differs from its schema");
+static_assert(rezol_schema_matches(StatsHeaderSchema, WireStatsHeaderMembers, sizeof(WireStatsHeader)),
+              "WireStatsHeader differs from its schema");
+static_assert(rezol_schema_matches(StageStatsSchema, WireStageStatsMembers, sizeof(WireStageStats)),
+              "WireStageStats differs from its schema");
+
+// --- Buffer sizes ---
+
+constexpr size_t SCHEMA_RECORD_SIZE = rezol_schema_size(PhysicalScreenSchema);
+
+// Format 1 records stop before the DPI fields, so they stay the 128 bytes
+// older readers step by. Only format 2, whose header gives the record
+// size, carries the whole PhysicalScreen.
+constexpr size_t SCHEMA_RECORD_V1_FIELDS = rezol_schema_index(PhysicalScreenSchema, "effectiveDpiX");
+constexpr size_t SCHEMA_RECORD_V1_SIZE = rezol_schema_offset(PhysicalScreenSchema, SCHEMA_RECORD_V1_FIELDS);
+static_assert(SCHEMA_RECORD_V1_SIZE == 128, "format 1 records are frozen at 128 bytes");
+
+constexpr size_t rezol_schema_record_size(int32_t format) {
+    return (format == WIRE_FORMAT_V2) ? SCHEMA_RECORD_SIZE : SCHEMA_RECORD_V1_SIZE;
+}
+constexpr size_t SCHEMA_HEADER_V1_SIZE = rezol_schema_size(ScreenInfoV1Schema);
+constexpr size_t SCHEMA_HEADER_V2_SIZE = rezol_schema_size(ScreenInfoV2Schema);
+
+// Bytes a SCREENINFO buffer of count records takes in a format
+constexpr size_t rezol_schema_screen_info_size(int32_t format, size_t count) {
+    return (format == WIRE_FORMAT_V2)
+        ? SCHEMA_HEADER_V2_SIZE + count * (SCHEMA_OFFSET_SIZE + SCHEMA_RECORD_SIZE) + SCHEMA_FOURCC_SIZE
+        : SCHEMA_HEADER_V1_SIZE + count * SCHEMA_RECORD_V1_SIZE + SCHEMA_FOURCC_SIZE;
+}
+
+// The fixed buffer the screen info exports without a size have always
+// written into: eight format 1 records. They never write more than this,
+// and no SCREENINFO size is reported below it.
+constexpr size_t SCHEMA_SCREEN_INFO_LEGACY_SIZE = rezol_schema_screen_info_size(WIRE_FORMAT_V1, SCREENS_PER_PAGE);
+
+constexpr size_t SCHEMA_CHANGES_HEADER_SIZE = rezol_schema_size(ScreenChangesSchema);
+constexpr size_t SCHEMA_CHANGE_RECORD_SIZE = rezol_schema_size(ScreenChangeRecordSchema);
+
+// Bytes a SCREENCHANGES buffer needs for up to count records
+constexpr size_t rezol_schema_screen_changes_size(size_t count) {
+    return SCHEMA_CHANGES_HEADER_SIZE + count * (SCHEMA_CHANGE_RECORD_SIZE + SCHEMA_RECORD_SIZE) + SCHEMA_FOURCC_SIZE;
+}
+
+// The most rezol_ext_get_screen_changes writes without a size: a page of
+// monitors. No SCREENCHANGES size is reported below it.
+constexpr size_t SCHEMA_SCREEN_CHANGES_LEGACY_SIZE = rezol_schema_screen_changes_size(SCREENS_PER_PAGE);
+
+constexpr size_t SCHEMA_STATS_HEADER_SIZE = rezol_schema_size(StatsHeaderSchema);
+constexpr size_t SCHEMA_STAGE_RECORD_SIZE = rezol_schema_size(StageStatsSchema);
+
+// Bytes a STATS buffer takes, one record per stage
+constexpr size_t SCHEMA_STATS_SIZE = SCHEMA_STATS_HEADER_SIZE + STAT_STAGE_COUNT * SCHEMA_STAGE_RECORD_SIZE + SCHEMA_FOURCC_SIZE;
+
+#endif // SCREEN_SCHEMA_H
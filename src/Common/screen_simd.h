@@ -0,0 +1,38 @@
+#ifndef SCREEN_SIMD_H
+#define SCREEN_SIMD_H
+
+#include <cstdint>
+
+// Runtime choice between the scalar, SSE2 and AVX2 versions of the batched
+// kernels (screen_classify.h, screen_transform.h).
+
+enum REZOL_SIMD_KERNEL {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2   = 1,
+    SIMD_AVX2   = 2
+};
+
+// Whether this build and CPU can run a kernel
+bool rezol_simd_supported(int32_t kernel);
+
+// Widest supported kernel, unless GMS_SIMD names another (scalar, sse2, avx2)
+int32_t rezol_simd_best();
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GMS_X86_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC lets any function use AVX2 intrinsics, GCC and Clang need telling
+#if defined(GMS_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define GMS_TARGET_SSE2 __attribute__((target("sse2")))
+#define GMS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GMS_TARGET_SSE2
+#define GMS_TARGET_AVX2
+#endif
+
+#endif // SCREEN_SIMD_H
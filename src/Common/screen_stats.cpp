@@ -0,0 +1,74 @@
+#include "screen_stats.h"
+#include <cstring>
+
+#ifdef GMS_HAVE_STATS
+
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+// Relaxed atomics: enumeration runs under the topology lock, but a
+// serialization can land from any thread at the same time
+struct StageCounters {
+    atomic<uint64_t> calls;
+    atomic<uint64_t> totalNs;
+    atomic<uint64_t> lastNs;
+    atomic<uint64_t> maxNs;
+    atomic<uint64_t> pendingNs; // so far in the enumeration under way
+};
+
+static StageCounters counters[STAT_STAGE_COUNT];
+
+uint64_t rezol_stats_now() {
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void rezol_stats_add(int32_t stage, uint64_t ns) {
+    if (stage < 0 || stage >= STAT_STAGE_COUNT) {
+        return;
+    }
+    StageCounters& c = counters[stage];
+    c.calls.fetch_add(1, memory_order_relaxed);
+    c.totalNs.fetch_add(ns, memory_order_relaxed);
+    uint64_t longest = c.maxNs.load(memory_order_relaxed);
+    while (ns > longest && !c.maxNs.compare_exchange_weak(longest, ns, memory_order_relaxed)) {
+    }
+
+    switch (stage) {
+        case STAT_ENUMERATE:
+            // The stages inside it report what this enumeration spent
+            for (int32_t inner = STAT_NAMES; inner <= STAT_PHYSSIZE; inner++) {
+                counters[inner].lastNs.store(counters[inner].pendingNs.exchange(0, memory_order_relaxed),
+                                             memory_order_relaxed);
+            }
+            c.lastNs.store(ns, memory_order_relaxed);
+            break;
+        case STAT_SERIALIZE:
+            c.lastNs.store(ns, memory_order_relaxed);
+            break;
+        default:
+            c.pendingNs.fetch_add(ns, memory_order_relaxed);
+            break;
+    }
+}
+
+bool rezol_stats_read(StageStats (&stats)[STAT_STAGE_COUNT]) {
+    for (int32_t i = 0; i < STAT_STAGE_COUNT; i++) {
+        stats[i].calls = counters[i].calls.load(memory_order_relaxed);
+        stats[i].totalNs = counters[i].totalNs.load(memory_order_relaxed);
+        stats[i].lastNs = counters[i].lastNs.load(memory_order_relaxed);
+        stats[i].maxNs = counters[i].maxNs.load(memory_order_relaxed);
+    }
+    return true;
+}
+
+#else
+
+bool rezol_stats_read(StageStats (&stats)[STAT_STAGE_COUNT]) {
+    memset(stats, 0, sizeof(stats));
+    return false;
+}
+
+#endif // GMS_HAVE_STATS
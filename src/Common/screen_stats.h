@@ -0,0 +1,64 @@
+#ifndef SCREEN_STATS_H
+#define SCREEN_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Where enumeration time goes, for "it hitches when I plug in my TV".
+// Each stage below is timed with the monotonic clock wherever a backend
+// does that work, and rezol_ext_get_stats hands GML the call count, the
+// total, the longest single call and the time taken by the last
+// enumeration (or last serialization).
+//
+// Only compiled in with GMS_HAVE_STATS, the GMS_WITH_STATS CMake option.
+// Without it REZOL_STAT_SCOPE is empty and nothing is timed at all.
+
+enum REZOL_STAT_STAGE {
+    STAT_ENUMERATE,  // one whole OS enumeration, the next three included
+    STAT_NAMES,      // friendly names: display config, EDID reads and parses
+    STAT_MODES,      // current mode of each monitor
+    STAT_PHYSSIZE,   // physical size where it takes its own query (CreateDC/GetDeviceCaps)
+    STAT_SERIALIZE,  // writing a screen info or screen changes buffer
+    STAT_STAGE_COUNT
+};
+
+struct StageStats {
+    uint64_t calls;
+    uint64_t totalNs;
+    uint64_t lastNs;  // during the last enumeration, or the last call for the outer stages
+    uint64_t maxNs;   // longest single call
+};
+
+// Copy out every stage's counters. Returns false, leaving stats zeroed,
+// when the library was built without them.
+bool rezol_stats_read(StageStats (&stats)[STAT_STAGE_COUNT]);
+
+#ifdef GMS_HAVE_STATS
+
+uint64_t rezol_stats_now();
+void rezol_stats_add(int32_t stage, uint64_t ns);
+
+// Times the rest of the enclosing block
+class StageTimer {
+public:
+    explicit StageTimer(int32_t stage) : stage(stage), start(rezol_stats_now()) {}
+    ~StageTimer() { rezol_stats_add(stage, rezol_stats_now() - start); }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    int32_t  stage;
+    uint64_t start;
+};
+
+#define REZOL_STAT_JOIN2(a, b) a##b
+#define REZOL_STAT_JOIN(a, b) REZOL_STAT_JOIN2(a, b)
+#define REZOL_STAT_SCOPE(stage) StageTimer REZOL_STAT_JOIN(stageTimer, __LINE__)(stage)
+
+#else
+
+#define REZOL_STAT_SCOPE(stage) ((void)0)
+
+#endif // GMS_HAVE_STATS
+
+#endif // SCREEN_STATS_H
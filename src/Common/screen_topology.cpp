@@ -0,0 +1,157 @@
+#include "screen_topology.h"
+#include "screen_backend.h"
+#include "screen_mirror.h"
+#include "screen_stats.h"
+#include "screen_trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+static mutex topologyLock;
+static TopologyRef topology;
+// The last few snapshots, oldest first, for diffing against
+static TopologyRef history[TOPOLOGY_HISTORY];
+static size_t historyNext = 0;
+static atomic<bool> topologyStale(true);
+static atomic<uint64_t> topologyGeneration(0);
+
+static once_flag watcherOnce;
+static atomic<bool> watching(false);
+
+static uint64_t NowNanoseconds() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool SameTopology(const TopologySnapshot& a, const TopologySnapshot& b) {
+    return a.result == b.result && a.autoHideTaskbar == b.autoHideTaskbar &&
+           a.screens.size() == b.screens.size() &&
+           (a.screens.empty() || memcmp(a.screens.data(), b.screens.data(), a.screens.size() * sizeof(PhysicalScreen)) == 0);
+}
+
+// Enumerate and build the next snapshot. An unchanged result keeps the
+// previous snapshot, so its generation does not move.
+static TopologyRef Enumerate(const TopologyRef& previous) {
+    shared_ptr<TopologySnapshot> next = make_shared<TopologySnapshot>();
+    {
+        REZOL_STAT_SCOPE(STAT_ENUMERATE);
+        REZOL_TRACE_SCOPE("enumerate");
+        next->result = rezol_enumerate_all(&__internal_get_virtual_screens, next->screens, next->autoHideTaskbar);
+    }
+
+    if (previous && SameTopology(*previous, *next)) {
+        return previous;
+    }
+    uint64_t now = NowNanoseconds();
+    uint64_t last = previous ? previous->generation : 0;
+    next->generation = (now > last) ? now : last + 1;
+    rezol_index_build(next->index, next->screens);
+    rezol_spaces_build(next->spaces, next->screens);
+    return next;
+}
+
+// Swap in a new snapshot, called with topologyLock held
+static void Replace(const TopologyRef& next) {
+    bool changed = (next != topology);
+    topology = next;
+    topologyGeneration = topology->generation;
+    if (changed) {
+        history[historyNext] = topology;
+        historyNext = (historyNext + 1) % TOPOLOGY_HISTORY;
+        rezol_mirror_publish(*topology);
+    }
+}
+
+// Stops the watcher before the library is unloaded. It is created when
+// the watcher starts, after every static of the platform code, so it is
+// destroyed before them and the watcher thread still has what it needs.
+struct WatcherTeardown {
+    ~WatcherTeardown() { rezol_topology_shutdown(); }
+};
+
+static void StartWatcher() {
+    call_once(watcherOnce, [] {
+        static WatcherTeardown teardown;
+        watching = rezol_platform_watch_start(&rezol_topology_notify_change);
+    });
+}
+
+void rezol_topology_shutdown() {
+    // Queries go back to enumerating before the watcher stops reporting
+    watching = false;
+    rezol_platform_watch_stop();
+}
+
+void rezol_topology_watcher_lost() {
+    REZOL_TRACE_INSTANT("watcher_lost");
+    watching = false;
+    rezol_topology_invalidate();
+}
+
+void rezol_topology_invalidate() {
+    REZOL_TRACE_INSTANT("invalidate");
+    topologyStale = true;
+}
+
+void rezol_topology_notify_change() {
+    REZOL_TRACE_INSTANT("watcher_change");
+    rezol_topology_invalidate();
+    // Nobody has to query for a mirrored buffer to see the change
+    if (rezol_mirror_active()) {
+        rezol_topology_current();
+    }
+}
+
+TopologyRef rezol_topology_current() {
+    REZOL_TRACE_SCOPE("topology_query");
+    StartWatcher();
+    lock_guard<mutex> lock(topologyLock);
+    // Clear the flag before enumerating so a change that lands while we
+    // enumerate is picked up next time
+    bool stale = topologyStale.exchange(false);
+    if (!topology || stale || !watching) {
+        Replace(Enumerate(topology));
+    }
+    return topology;
+}
+
+TopologyRef rezol_topology_refresh() {
+    REZOL_TRACE_SCOPE("topology_refresh");
+    StartWatcher();
+    lock_guard<mutex> lock(topologyLock);
+    topologyStale = false;
+    Replace(Enumerate(topology));
+    return topology;
+}
+
+uint64_t rezol_topology_generation() {
+    StartWatcher();
+    if (watching && !topologyStale && topologyGeneration != 0) {
+        return topologyGeneration;
+    }
+    return rezol_topology_current()->generation;
+}
+
+TopologyRef rezol_topology_find(double generation) {
+    lock_guard<mutex> lock(topologyLock);
+    for (const TopologyRef& snapshot : history) {
+        // GML only ever sees the generation as a double
+        if (snapshot && (double)snapshot->generation == generation) {
+            return snapshot;
+        }
+    }
+    return nullptr;
+}
+
+size_t rezol_topology_history_max_screens() {
+    lock_guard<mutex> lock(topologyLock);
+    size_t most = 0;
+    for (const TopologyRef& snapshot : history) {
+        if (snapshot && snapshot->screens.size() > most) {
+            most = snapshot->screens.size();
+        }
+    }
+    return most;
+}
@@ -0,0 +1,78 @@
+#ifndef SCREEN_TOPOLOGY_H
+#define SCREEN_TOPOLOGY_H
+
+#include "screen_utils.h"
+#include "screen_index.h"
+#include "screen_transform.h"
+#include <memory>
+#include <vector>
+
+// The library keeps the last enumerated topology as an immutable snapshot
+// and only enumerates again when the platform watcher reports a change or
+// a refresh is asked for. Without a watcher every query re-enumerates, but
+// the generation still only moves when the result is different.
+
+struct TopologySnapshot {
+    uint64_t generation;                 // steady clock ns when this content first appeared
+    int32_t  result;                     // what the backend returned
+    int32_t  autoHideTaskbar;
+    std::vector<PhysicalScreen> screens; // every monitor
+    ScreenIndex index;                   // point lookup over screens
+    ScreenSpaces spaces;                 // pixel and millimetre layouts of screens
+};
+
+typedef std::shared_ptr<const TopologySnapshot> TopologyRef;
+
+// How many past snapshots are kept to diff against
+constexpr size_t TOPOLOGY_HISTORY = 16;
+
+// Current snapshot, enumerating first if it is missing or invalidated
+TopologyRef rezol_topology_current();
+
+// Enumerate now regardless of the cache
+TopologyRef rezol_topology_refresh();
+
+// Mark the snapshot stale. Cheap and safe to call from any thread.
+void rezol_topology_invalidate();
+
+// What the platform watcher calls: invalidate, and with a mirrored buffer
+// registered enumerate straight away so it is rewritten in the background.
+// Must not be called while enumerating.
+void rezol_topology_notify_change();
+
+// What the platform watcher calls when it ends without being stopped,
+// e.g. its socket failed. Changes are no longer reported, so every query
+// enumerates again from then on, the same as with no watcher at all.
+void rezol_topology_watcher_lost();
+
+// Stop the platform watcher. Every query enumerates again afterwards and
+// the watcher is not restarted. Runs on its own when the library is
+// unloaded, so nothing else stops the watcher.
+void rezol_topology_shutdown();
+
+// Generation of the current snapshot. With a running watcher this never
+// touches the OS.
+uint64_t rezol_topology_generation();
+
+// One of the last TOPOLOGY_HISTORY snapshots by its generation, as GML
+// passes it back, or nullptr if it is older than that
+TopologyRef rezol_topology_find(double generation);
+
+// Most monitors any remembered snapshot had
+size_t rezol_topology_history_max_screens();
+
+// Serialize a snapshot in a SCREENINFO wire format (screen_wire.h),
+// starting at monitor pageNum * perPage and writing at most perPage
+// records or as many as fit in size bytes. Sets more when monitors were
+// left out. Returns the number of bytes written, 0 on failure.
+size_t rezol_write_screen_info(char* buf, size_t size, const TopologySnapshot& topology,
+                               int32_t pageNum, int32_t perPage, int32_t format);
+
+// Serialize what changed between two snapshots in the SCREENCHANGES
+// layout (screen_wire.h). Monitors are matched by index. With since null
+// every monitor in now is written as added. Returns the number of bytes
+// written, 0 on failure or if the changes do not fit in size bytes.
+size_t rezol_write_screen_changes(char* buf, size_t size, const TopologySnapshot* since,
+                                  const TopologySnapshot& now, double sinceGeneration);
+
+#endif // SCREEN_TOPOLOGY_H
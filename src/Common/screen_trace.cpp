@@ -0,0 +1,119 @@
+#include "screen_trace.h"
+
+#ifdef GMS_HAVE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+
+// Each slot is its own seqlock. A writer claims the next index, marks the
+// slot odd while it fills it in and publishes index * 2 + 2 when done, so
+// a reader can tell a finished event from a torn one or a newer lap. A
+// writer that finds the slot busy or already holding a later lap, because
+// it was preempted while the ring went round, drops its event instead.
+struct TraceSlot {
+    atomic<uint64_t>    sequence;
+    atomic<uint64_t>    timestamp;  // steady clock ns
+    atomic<const char*> name;
+    atomic<uint32_t>    thread;
+    atomic<char>        phase;
+};
+
+static TraceSlot ring[TRACE_RING_SIZE];
+static atomic<uint64_t> head(0);
+
+// The OS thread id, which is what profilers show next to other traces
+static uint32_t ThreadId() {
+    static thread_local uint32_t id = 0;
+    if (id == 0) {
+#ifdef _WIN32
+        id = (uint32_t)GetCurrentThreadId();
+#elif defined(__linux__)
+        id = (uint32_t)syscall(SYS_gettid);
+#else
+        id = (uint32_t)hash<thread::id>()(this_thread::get_id());
+#endif
+    }
+    return id;
+}
+
+void rezol_trace_event(const char* name, char phase) {
+    uint64_t now = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+    uint64_t index = head.fetch_add(1, memory_order_relaxed);
+    TraceSlot& slot = ring[index & (TRACE_RING_SIZE - 1)];
+    uint64_t sequence = slot.sequence.load(memory_order_relaxed);
+    do {
+        if ((sequence & 1) != 0 || sequence > index * 2) {
+            return;
+        }
+    } while (!slot.sequence.compare_exchange_weak(sequence, index * 2 + 1, memory_order_relaxed));
+    atomic_thread_fence(memory_order_release);
+    slot.timestamp.store(now, memory_order_relaxed);
+    slot.name.store(name, memory_order_relaxed);
+    slot.thread.store(ThreadId(), memory_order_relaxed);
+    slot.phase.store(phase, memory_order_relaxed);
+    slot.sequence.store(index * 2 + 2, memory_order_release);
+}
+
+string rezol_trace_json() {
+    string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    uint64_t end = head.load(memory_order_acquire);
+    uint64_t begin = (end > TRACE_RING_SIZE) ? end - TRACE_RING_SIZE : 0;
+    unordered_map<uint32_t, int32_t> depth;
+    bool first = true;
+    for (uint64_t index = begin; index < end; index++) {
+        const TraceSlot& slot = ring[index & (TRACE_RING_SIZE - 1)];
+        uint64_t before = slot.sequence.load(memory_order_acquire);
+        uint64_t timestamp = slot.timestamp.load(memory_order_relaxed);
+        const char* name = slot.name.load(memory_order_relaxed);
+        uint32_t thread = slot.thread.load(memory_order_relaxed);
+        char phase = slot.phase.load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = slot.sequence.load(memory_order_relaxed);
+        // Still being written, or already overwritten by a later lap
+        if (before != index * 2 + 2 || after != before || name == nullptr) {
+            continue;
+        }
+        if (phase == 'B') {
+            depth[thread]++;
+        } else if (phase == 'E') {
+            if (depth[thread] == 0) {
+                continue;
+            }
+            depth[thread]--;
+        }
+
+        char event[TRACE_EVENT_JSON_MAX];
+        snprintf(event, sizeof(event), "%s\n{\"name\":\"%.48s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}",
+                 first ? "" : ",", name, phase, timestamp / 1000.0, thread, (phase == 'i') ? ",\"s\":\"t\"" : "");
+        json += event;
+        first = false;
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+#else
+
+void rezol_trace_event(const char*, char) {
+}
+
+std::string rezol_trace_json() {
+    return std::string();
+}
+
+#endif // GMS_HAVE_TRACE
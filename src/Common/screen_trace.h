@@ -0,0 +1,58 @@
+#ifndef SCREEN_TRACE_H
+#define SCREEN_TRACE_H
+
+#include <cstddef>
+#include <string>
+
+// Timeline of the last TRACE_RING_SIZE events: topology queries and
+// enumerations as begin/end pairs, watcher wakeups and invalidations as
+// instants. Events go into a fixed ring that any thread can write without
+// a lock or an allocation; the oldest are overwritten. rezol_trace_json
+// turns what is left into Chrome trace-event JSON, which chrome://tracing
+// and ui.perfetto.dev both open.
+//
+// Only compiled in with GMS_HAVE_TRACE, the GMS_WITH_TRACE CMake option.
+// Without it the macros are empty and the ring is never written.
+
+constexpr size_t TRACE_RING_SIZE = 1024;  // a power of two
+
+// Longest JSON one event takes, names included, and the whole document
+constexpr size_t TRACE_EVENT_JSON_MAX = 128;
+constexpr size_t TRACE_JSON_MAX = 64 + TRACE_RING_SIZE * TRACE_EVENT_JSON_MAX;
+
+// phase is 'B', 'E' or 'i' as in the trace-event format. Only the name
+// pointer is kept, so it must be a string literal.
+void rezol_trace_event(const char* name, char phase);
+
+// Every complete event still in the ring, oldest first. An end whose
+// begin was already overwritten is left out. Empty when built without
+// GMS_HAVE_TRACE.
+std::string rezol_trace_json();
+
+#ifdef GMS_HAVE_TRACE
+
+// A begin event now and the matching end when the block is left
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name) { rezol_trace_event(name, 'B'); }
+    ~TraceScope() { rezol_trace_event(name, 'E'); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+};
+
+#define REZOL_TRACE_JOIN2(a, b) a##b
+#define REZOL_TRACE_JOIN(a, b) REZOL_TRACE_JOIN2(a, b)
+#define REZOL_TRACE_SCOPE(name) TraceScope REZOL_TRACE_JOIN(traceScope, __LINE__)(name)
+#define REZOL_TRACE_INSTANT(name) rezol_trace_event(name, 'i')
+
+#else
+
+#define REZOL_TRACE_SCOPE(name) ((void)0)
+#define REZOL_TRACE_INSTANT(name) ((void)0)
+
+#endif // GMS_HAVE_TRACE
+
+#endif // SCREEN_TRACE_H
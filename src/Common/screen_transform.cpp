@@ -0,0 +1,324 @@
+#include "screen_transform.h"
+#include <cstring>
+
+using namespace std;
+
+// --- Layout ---
+
+// Origins of every monitor in one space, the primary first and each
+// neighbour sharing an edge with a placed monitor put against it
+static void Layout(const vector<PhysicalScreen>& screens, SpaceColumns& c) {
+    size_t n = screens.size();
+    vector<bool> placed(n, false);
+    vector<size_t> queue;
+    for (;;) {
+        // The primary, then whatever was not connected to it
+        size_t root = n;
+        for (size_t i = 0; i < n; i++) {
+            if (!placed[i] && (root == n || (screens[i].isPrimary && !screens[root].isPrimary))) {
+                root = i;
+            }
+        }
+        if (root == n) {
+            break;
+        }
+        placed[root] = true;
+        c.originX[root] = screens[root].virtualRect.left * c.scaleX[root];
+        c.originY[root] = screens[root].virtualRect.top * c.scaleY[root];
+        queue.assign(1, root);
+
+        for (size_t q = 0; q < queue.size(); q++) {
+            size_t a = queue[q];
+            const GMSRect& A = screens[a].virtualRect;
+            for (size_t b = 0; b < n; b++) {
+                if (placed[b]) {
+                    continue;
+                }
+                const GMSRect& B = screens[b].virtualRect;
+                bool rows = B.top < A.bottom && B.bottom > A.top;
+                bool cols = B.left < A.right && B.right > A.left;
+                if (rows && B.left == A.right) {
+                    c.originX[b] = c.originX[a] + (A.right - A.left) * c.scaleX[a];
+                    c.originY[b] = c.originY[a] + (B.top - A.top) * c.scaleY[a];
+                } else if (rows && B.right == A.left) {
+                    c.originX[b] = c.originX[a] - (B.right - B.left) * c.scaleX[b];
+                    c.originY[b] = c.originY[a] + (B.top - A.top) * c.scaleY[a];
+                } else if (cols && B.top == A.bottom) {
+                    c.originX[b] = c.originX[a] + (B.left - A.left) * c.scaleX[a];
+                    c.originY[b] = c.originY[a] + (A.bottom - A.top) * c.scaleY[a];
+                } else if (cols && B.bottom == A.top) {
+                    c.originX[b] = c.originX[a] + (B.left - A.left) * c.scaleX[a];
+                    c.originY[b] = c.originY[a] - (B.bottom - B.top) * c.scaleY[b];
+                } else {
+                    continue;
+                }
+                placed[b] = true;
+                queue.push_back(b);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const GMSRect& r = screens[i].virtualRect;
+        c.left[i] = c.originX[i];
+        c.top[i] = c.originY[i];
+        c.right[i] = c.originX[i] + (r.right - r.left) * c.scaleX[i];
+        c.bottom[i] = c.originY[i] + (r.bottom - r.top) * c.scaleY[i];
+    }
+}
+
+void rezol_spaces_build(ScreenSpaces& spaces, const vector<PhysicalScreen>& screens) {
+    size_t n = screens.size();
+    for (SpaceColumns& c : spaces.space) {
+        for (vector<double>* column : { &c.originX, &c.originY, &c.scaleX, &c.scaleY, &c.left, &c.top, &c.right, &c.bottom }) {
+            column->assign(n, 0);
+        }
+    }
+    SpaceColumns& logical = spaces.space[SPACE_LOGICAL];
+    SpaceColumns& pixels = spaces.space[SPACE_PIXELS];
+    SpaceColumns& mm = spaces.space[SPACE_MM];
+    for (size_t i = 0; i < n; i++) {
+        const PhysicalScreen& s = screens[i];
+        double w = (double)s.virtualRect.right - s.virtualRect.left;
+        double h = (double)s.virtualRect.bottom - s.virtualRect.top;
+        logical.scaleX[i] = 1;
+        logical.scaleY[i] = 1;
+        pixels.scaleX[i] = (w > 0 && s.pixelBox.width > 0) ? s.pixelBox.width / w : 1;
+        pixels.scaleY[i] = (h > 0 && s.pixelBox.height > 0) ? s.pixelBox.height / h : 1;
+        mm.scaleX[i] = (w > 0 && s.physSize.width > 0) ? s.physSize.width / w : pixels.scaleX[i] * 25.4 / 96;
+        mm.scaleY[i] = (h > 0 && s.physSize.height > 0) ? s.physSize.height / h : pixels.scaleY[i] * 25.4 / 96;
+    }
+    for (SpaceColumns& c : spaces.space) {
+        Layout(screens, c);
+    }
+}
+
+// --- Scalar ---
+
+static int32_t Nearest(const SpaceColumns& c, double x, double y) {
+    int32_t found = -1;
+    double best = 0;
+    for (size_t i = 0; i < c.left.size(); i++) {
+        if (!(c.right[i] > c.left[i] && c.bottom[i] > c.top[i])) {
+            continue;
+        }
+        double dx = (x < c.left[i]) ? c.left[i] - x : (x >= c.right[i]) ? x - c.right[i] : 0;
+        double dy = (y < c.top[i]) ? c.top[i] - y : (y >= c.bottom[i]) ? y - c.bottom[i] : 0;
+        if (found < 0 || dx * dx + dy * dy < best) {
+            best = dx * dx + dy * dy;
+            found = (int32_t)i;
+        }
+    }
+    return found;
+}
+
+static void OwnersScalar(const SpaceColumns& c, const double* points, int32_t* owners, size_t count) {
+    size_t screens = c.left.size();
+    for (size_t p = 0; p < count; p++) {
+        double x = points[2 * p];
+        double y = points[2 * p + 1];
+        int32_t found = -1;
+        for (size_t i = 0; i < screens; i++) {
+            if (x >= c.left[i] && x < c.right[i] && y >= c.top[i] && y < c.bottom[i]) {
+                found = (int32_t)i;
+                break;
+            }
+        }
+        owners[p] = (found >= 0) ? found : Nearest(c, x, y);
+    }
+}
+
+static void ApplyScalar(const SpaceColumns& f, const SpaceColumns& t, const int32_t* owners,
+                        const double* points, double* out, size_t count) {
+    for (size_t p = 0; p < count; p++) {
+        double x = points[2 * p];
+        double y = points[2 * p + 1];
+        int32_t o = owners[p];
+        if (o >= 0) {
+            x = t.originX[o] + (x - f.originX[o]) * (t.scaleX[o] / f.scaleX[o]);
+            y = t.originY[o] + (y - f.originY[o]) * (t.scaleY[o] / f.scaleY[o]);
+        }
+        out[2 * p] = x;
+        out[2 * p + 1] = y;
+    }
+}
+
+#ifdef GMS_X86_SIMD
+
+// --- SSE2, one (x, y) pair per vector ---
+
+GMS_TARGET_SSE2
+static void OwnersSSE2(const SpaceColumns& c, const double* points, int32_t* owners, size_t count) {
+    size_t screens = c.left.size();
+    for (size_t p = 0; p < count; p++) {
+        __m128d xy = _mm_loadu_pd(points + 2 * p);
+        int32_t found = -1;
+        for (size_t i = 0; i < screens; i++) {
+            __m128d inside = _mm_and_pd(_mm_cmpge_pd(xy, _mm_setr_pd(c.left[i], c.top[i])),
+                                        _mm_cmplt_pd(xy, _mm_setr_pd(c.right[i], c.bottom[i])));
+            if (_mm_movemask_pd(inside) == 3) {
+                found = (int32_t)i;
+                break;
+            }
+        }
+        owners[p] = (found >= 0) ? found : Nearest(c, points[2 * p], points[2 * p + 1]);
+    }
+}
+
+GMS_TARGET_SSE2
+static void ApplySSE2(const SpaceColumns& f, const SpaceColumns& t, const int32_t* owners,
+                      const double* points, double* out, size_t count) {
+    for (size_t p = 0; p < count; p++) {
+        __m128d xy = _mm_loadu_pd(points + 2 * p);
+        int32_t o = owners[p];
+        if (o >= 0) {
+            __m128d ratio = _mm_div_pd(_mm_setr_pd(t.scaleX[o], t.scaleY[o]), _mm_setr_pd(f.scaleX[o], f.scaleY[o]));
+            __m128d moved = _mm_mul_pd(_mm_sub_pd(xy, _mm_setr_pd(f.originX[o], f.originY[o])), ratio);
+            xy = _mm_add_pd(_mm_setr_pd(t.originX[o], t.originY[o]), moved);
+        }
+        _mm_storeu_pd(out + 2 * p, xy);
+    }
+}
+
+// --- AVX2, four points at a time ---
+
+// x0 y0 x1 y1 | x2 y2 x3 y3 -> x0 x1 x2 x3 | y0 y1 y2 y3
+GMS_TARGET_AVX2
+static inline void Split(const double* points, __m256d& x, __m256d& y) {
+    __m256d a = _mm256_loadu_pd(points);
+    __m256d b = _mm256_loadu_pd(points + 4);
+    x = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    y = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+GMS_TARGET_AVX2
+static inline void Join(__m256d x, __m256d y, double* out) {
+    x = _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 1, 2, 0));
+    y = _mm256_permute4x64_pd(y, _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_pd(out, _mm256_unpacklo_pd(x, y));
+    _mm256_storeu_pd(out + 4, _mm256_unpackhi_pd(x, y));
+}
+
+GMS_TARGET_AVX2
+static void OwnersAVX2(const SpaceColumns& c, const double* points, int32_t* owners, size_t count) {
+    size_t screens = c.left.size();
+    const __m256d none = _mm256_set1_pd(-1);
+    size_t p = 0;
+    for (; p + 4 <= count; p += 4) {
+        __m256d x, y;
+        Split(points + 2 * p, x, y);
+        __m256d found = none;
+        for (size_t i = 0; i < screens; i++) {
+            __m256d inside = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(c.left[i]), _CMP_GE_OQ),
+                              _mm256_cmp_pd(x, _mm256_set1_pd(c.right[i]), _CMP_LT_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(y, _mm256_set1_pd(c.top[i]), _CMP_GE_OQ),
+                              _mm256_cmp_pd(y, _mm256_set1_pd(c.bottom[i]), _CMP_LT_OQ)));
+            __m256d take = _mm256_and_pd(inside, _mm256_cmp_pd(found, none, _CMP_EQ_OQ));
+            found = _mm256_blendv_pd(found, _mm256_set1_pd((double)i), take);
+            if (_mm256_movemask_pd(_mm256_cmp_pd(found, none, _CMP_EQ_OQ)) == 0) {
+                break;
+            }
+        }
+        _mm_storeu_si128((__m128i*)(owners + p), _mm256_cvtpd_epi32(found));
+        for (size_t k = p; k < p + 4; k++) {
+            if (owners[k] < 0) {
+                owners[k] = Nearest(c, points[2 * k], points[2 * k + 1]);
+            }
+        }
+    }
+    OwnersScalar(c, points + 2 * p, owners + p, count - p);
+}
+
+GMS_TARGET_AVX2
+static void ApplyAVX2(const SpaceColumns& f, const SpaceColumns& t, const int32_t* owners,
+                      const double* points, double* out, size_t count) {
+    size_t p = 0;
+    for (; p + 4 <= count; p += 4) {
+        __m128i o = _mm_loadu_si128((const __m128i*)(owners + p));
+        if (_mm_movemask_ps(_mm_castsi128_ps(o)) != 0) {
+            // A point with no owner, only when there are no monitors
+            ApplyScalar(f, t, owners + p, points + 2 * p, out + 2 * p, 4);
+            continue;
+        }
+        __m256d x, y;
+        Split(points + 2 * p, x, y);
+        __m256d ratioX = _mm256_div_pd(_mm256_i32gather_pd(t.scaleX.data(), o, 8), _mm256_i32gather_pd(f.scaleX.data(), o, 8));
+        __m256d ratioY = _mm256_div_pd(_mm256_i32gather_pd(t.scaleY.data(), o, 8), _mm256_i32gather_pd(f.scaleY.data(), o, 8));
+        x = _mm256_add_pd(_mm256_i32gather_pd(t.originX.data(), o, 8),
+                          _mm256_mul_pd(_mm256_sub_pd(x, _mm256_i32gather_pd(f.originX.data(), o, 8)), ratioX));
+        y = _mm256_add_pd(_mm256_i32gather_pd(t.originY.data(), o, 8),
+                          _mm256_mul_pd(_mm256_sub_pd(y, _mm256_i32gather_pd(f.originY.data(), o, 8)), ratioY));
+        Join(x, y, out + 2 * p);
+    }
+    ApplyScalar(f, t, owners + p, points + 2 * p, out + 2 * p, count - p);
+}
+
+#endif // GMS_X86_SIMD
+
+void rezol_space_owners(int32_t kernel, const ScreenSpaces& spaces, int32_t space, const double* points,
+                        int32_t* owners, size_t count) {
+    const SpaceColumns& c = spaces.space[space];
+    if (!rezol_simd_supported(kernel)) {
+        kernel = SIMD_SCALAR;
+    }
+    switch (kernel) {
+#ifdef GMS_X86_SIMD
+        case SIMD_AVX2:
+            OwnersAVX2(c, points, owners, count);
+            break;
+        case SIMD_SSE2:
+            OwnersSSE2(c, points, owners, count);
+            break;
+#endif
+        default:
+            OwnersScalar(c, points, owners, count);
+            break;
+    }
+}
+
+void rezol_space_apply(int32_t kernel, const ScreenSpaces& spaces, int32_t from, int32_t to,
+                       const int32_t* owners, const double* points, double* out, size_t count) {
+    const SpaceColumns& f = spaces.space[from];
+    const SpaceColumns& t = spaces.space[to];
+    if (!rezol_simd_supported(kernel)) {
+        kernel = SIMD_SCALAR;
+    }
+    switch (kernel) {
+#ifdef GMS_X86_SIMD
+        case SIMD_AVX2:
+            ApplyAVX2(f, t, owners, points, out, count);
+            break;
+        case SIMD_SSE2:
+            ApplySSE2(f, t, owners, points, out, count);
+            break;
+#endif
+        default:
+            ApplyScalar(f, t, owners, points, out, count);
+            break;
+    }
+}
+
+void rezol_space_transform_points(const ScreenSpaces& spaces, int32_t from, int32_t to, const double* points,
+                                  double* out, size_t count) {
+    vector<int32_t> owners(count);
+    rezol_space_owners(rezol_simd_best(), spaces, from, points, owners.data(), count);
+    rezol_space_apply(rezol_simd_best(), spaces, from, to, owners.data(), points, out, count);
+}
+
+void rezol_space_transform_rects(const ScreenSpaces& spaces, int32_t from, int32_t to, const double* rects,
+                                 double* out, size_t count) {
+    // A rect is two corners, both owned by the monitor under its centre
+    vector<double> centres(2 * count);
+    for (size_t r = 0; r < count; r++) {
+        centres[2 * r] = (rects[4 * r] + rects[4 * r + 2]) / 2;
+        centres[2 * r + 1] = (rects[4 * r + 1] + rects[4 * r + 3]) / 2;
+    }
+    vector<int32_t> owners(2 * count);
+    rezol_space_owners(rezol_simd_best(), spaces, from, centres.data(), owners.data(), count);
+    for (size_t r = count; r-- > 0;) {
+        owners[2 * r + 1] = owners[r];
+        owners[2 * r] = owners[r];
+    }
+    rezol_space_apply(rezol_simd_best(), spaces, from, to, owners.data(), rects, out, 2 * count);
+}
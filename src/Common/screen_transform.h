@@ -0,0 +1,60 @@
+#ifndef SCREEN_TRANSFORM_H
+#define SCREEN_TRANSFORM_H
+
+#include "screen_utils.h"
+#include "screen_simd.h"
+#include <cstddef>
+#include <vector>
+
+// Coordinate spaces a point on the desktop can be given in:
+//   SPACE_LOGICAL  virtualRect coordinates, what the OS positions windows in
+//   SPACE_PIXELS   native panel pixels (pixelBox)
+//   SPACE_MM       millimetres on the glass (physSize)
+// Within a monitor each space is the logical one scaled, so converting is
+// origin + (v - origin) * scale per axis. The pixel and millimetre desktops
+// are laid out by walking monitors that share an edge in logical space and
+// putting them edge to edge, starting from the primary, so a point keeps
+// its real distance to its neighbours on mixed DPI desktops. Monitors with
+// no physical size are taken as 96 pixels to the inch.
+
+enum REZOL_SPACE {
+    SPACE_LOGICAL = 0,
+    SPACE_PIXELS  = 1,
+    SPACE_MM      = 2,
+    SPACE_COUNT
+};
+
+// One space as columns, one entry per monitor
+struct SpaceColumns {
+    std::vector<double> originX, originY; // where the monitor's top left corner is
+    std::vector<double> scaleX, scaleY;   // units per logical pixel
+    std::vector<double> left, top, right, bottom;
+};
+
+struct ScreenSpaces {
+    SpaceColumns space[SPACE_COUNT];
+};
+
+void rezol_spaces_build(ScreenSpaces& spaces, const std::vector<PhysicalScreen>& screens);
+
+// Monitor owning each point in a space: the one holding it (lowest index
+// on overlap, left and top edges inside), else the nearest, else -1 with no
+// monitors. Points are count (x, y) f64 pairs.
+void rezol_space_owners(int32_t kernel, const ScreenSpaces& spaces, int32_t space, const double* points,
+                        int32_t* owners, size_t count);
+
+// Convert count (x, y) f64 pairs between spaces through their owners from
+// rezol_space_owners. Points with no owner are copied. out may be points.
+void rezol_space_apply(int32_t kernel, const ScreenSpaces& spaces, int32_t from, int32_t to,
+                       const int32_t* owners, const double* points, double* out, size_t count);
+
+// Both of the above with the best kernel
+void rezol_space_transform_points(const ScreenSpaces& spaces, int32_t from, int32_t to, const double* points,
+                                  double* out, size_t count);
+
+// count (left, top, right, bottom) f64 rects, both corners converted through
+// the monitor owning the centre
+void rezol_space_transform_rects(const ScreenSpaces& spaces, int32_t from, int32_t to, const double* rects,
+                                 double* out, size_t count);
+
+#endif // SCREEN_TRANSFORM_H
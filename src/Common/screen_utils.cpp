@@ -0,0 +1,463 @@
+#include "screen_utils.h"
+#include "screen_backend.h"
+#include "edid.h"
+#include "screen_fixture.h"
+#include "screen_mirror.h"
+#include "screen_topology.h"
+#include "screen_schema.h"
+#include "screen_classify.h"
+#include "screen_stats.h"
+#include "screen_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <string> // For stoull
+#include <cstring>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+// Layout written to GML buffers, see screen_wire.h
+static atomic<int32_t> wireFormat(WIRE_FORMAT_V1);
+
+int32_t rezol_wire_format() {
+    return wireFormat;
+}
+
+static inline size_t rezol_get_buffer_size(int32_t which) {
+    size_t buff_size;
+    int32_t format = wireFormat;
+    
+    switch(which) {
+        case SCREENINFOHEADER:
+            buff_size = (format == WIRE_FORMAT_V2) ? SCHEMA_HEADER_V2_SIZE : SCHEMA_HEADER_V1_SIZE;
+            break;
+        case SCREENINFO: {
+            // Room for the monitors there are now, and never less than a
+            // page or the fixed size the unsized exports write into
+            size_t count = rezol_topology_current()->screens.size();
+            count = max(count, (size_t)SCREENS_PER_PAGE);
+            buff_size = max(rezol_schema_screen_info_size(format, count), SCHEMA_SCREEN_INFO_LEGACY_SIZE);
+            break;
+        }
+        case PHYSICALSCREEN:
+            buff_size = rezol_schema_record_size(format);
+            break;
+        case WINDOWCHROME:
+            buff_size = rezol_schema_size(WindowChromeSchema);
+            break;
+        case SCREENMIRROR: {
+            size_t count = rezol_topology_current()->screens.size();
+            buff_size = rezol_schema_size(MirrorHeaderSchema) + rezol_schema_screen_info_size(format, count);
+            break;
+        }
+        case SCREENCHANGES: {
+            // Worst case is every monitor of the largest remembered topology
+            size_t count = rezol_topology_current()->screens.size();
+            count = max(count, rezol_topology_history_max_screens());
+            buff_size = max(rezol_schema_screen_changes_size(count), SCHEMA_SCREEN_CHANGES_LEGACY_SIZE);
+            break;
+        }
+        case RECTPLACEMENT:
+            // One record, rezol_ext_monitors_from_rects writes one per rect
+            buff_size = rezol_schema_size(RectPlacementSchema);
+            break;
+        case STATS:
+            buff_size = SCHEMA_STATS_SIZE;
+            break;
+        case TRACE:
+            // JSON text and its nul, for every event the ring can hold
+            buff_size = TRACE_JSON_MAX + 1;
+            break;
+        default:
+            buff_size = 0;
+            break;
+    }
+    
+    return buff_size;
+}
+
+char* getGMSBuffAddress(char* _GMSBuffPtrStr) {
+    /*
+        @description    Converts a GMS buffer address string to a usable pointer in C++.
+        @params         {char*} _GMSBuffPtrStr - The ptr to a GMS buffer as a string.
+        @return         {char*} The pointer to the buffer. Now functions like memcpy will work.
+    */
+    size_t GMSBuffLongPointer = stoull(_GMSBuffPtrStr, NULL, 16);//Gets the ptr string into and int64_t.
+    return (char*)GMSBuffLongPointer;//Casts the int64_t pointer to char* and returns it so the buffer can be now operated in C++.
+}
+
+bool rezol_add_screen(ScreenInfo* info, const PhysicalScreen& screen) {
+    if (info->count >= info->maxCount) {
+        info->more = true;
+        return false;
+    }
+    info->screen[info->count] = screen;
+    info->count++;
+    return true;
+}
+
+int32_t rezol_enumerate_all(int32_t (*enumerate)(ScreenInfo* info),
+                            std::vector<PhysicalScreen>& screens, int32_t& autoHideTaskbar) {
+    screens.resize(SCREENS_PER_PAGE);
+    for (;;) {
+        ScreenInfo info;
+        info.screen = screens.data();
+        info.count = 0;
+        info.maxCount = (int32_t)screens.size();
+        info.fromScreen = 0;
+        info.pageNum = 0;
+        info.autoHideTaskbar = 0;
+        info.more = false;
+        int32_t result = enumerate(&info);
+        if (!result || !info.more) {
+            screens.resize(result ? info.count : 0);
+            autoHideTaskbar = info.autoHideTaskbar;
+            return result;
+        }
+        screens.resize(screens.size() * 2);
+    }
+}
+
+// --- Implementation of Exported Functions ---
+
+int32_t __internal_get_virtual_screens(ScreenInfo* info) {
+  // A loaded fixture replaces the OS for tests and benchmarks
+  if (rezol_fixture_active()) {
+    return rezol_fixture_get_virtual_screens(info);
+  }
+  return rezol_platform_get_virtual_screens(info);
+}
+
+size_t rezol_write_screen_info(char* buf, size_t size, const TopologySnapshot& topology,
+                               int32_t pageNum, int32_t perPage, int32_t format) {
+    REZOL_STAT_SCOPE(STAT_SERIALIZE);
+    REZOL_TRACE_SCOPE("serialize_screen_info");
+    if(buf == nullptr || !topology.result || size < rezol_schema_screen_info_size(format, 0)) {
+        return 0;
+    }
+    int32_t total = (int32_t)topology.screens.size();
+    size_t perRecord = rezol_schema_screen_info_size(format, 1) - rezol_schema_screen_info_size(format, 0);
+    size_t fit = (size - rezol_schema_screen_info_size(format, 0)) / perRecord;
+    int32_t room = (fit < (size_t)INT32_MAX) ? (int32_t)fit : INT32_MAX;
+
+    ScreenInfo info;
+    info.maxCount = (perPage < room) ? perPage : room;
+    info.fromScreen = pageNum * perPage;
+    info.pageNum = pageNum;
+    info.autoHideTaskbar = topology.autoHideTaskbar;
+    // Records are copied straight from the snapshot
+    info.screen = nullptr;
+    info.count = 0;
+    if (info.fromScreen < total) {
+        info.count = (total - info.fromScreen < info.maxCount) ? total - info.fromScreen : info.maxCount;
+    }
+    info.more = (info.fromScreen + info.count) < total;
+
+    // Everything is known to fit from here on
+    size_t written = rezol_schema_screen_info_size(format, info.count);
+    const PhysicalScreen* screens = topology.screens.data() + info.fromScreen;
+    size_t recordSize = rezol_schema_record_size(format);
+    char* records;
+
+    if (format == WIRE_FORMAT_V2) {
+        WireHeaderV2 header;
+        header.magic = WIRE_MAGIC_V2;
+        header.format = WIRE_FORMAT_V2;
+        header.headerSize = SCHEMA_HEADER_V2_SIZE;
+        header.recordSize = (uint16_t)recordSize;
+        header.reserved = 0;
+        header.count = info.count;
+        header.maxCount = info.maxCount;
+        header.fromScreen = info.fromScreen;
+        header.pageNum = info.pageNum;
+        header.autoHideTaskbar = info.autoHideTaskbar;
+        header.more = info.more ? 1 : 0;
+        header.versionMajor = info.versionMajor;
+        header.versionMinor = info.versionMinor;
+        header.versionBuild = info.versionBuild;
+        header.totalSize = (uint32_t)written;
+        memcpy(buf, &header, SCHEMA_HEADER_V2_SIZE);
+
+        // Offset table, so a reader can go straight to any monitor
+        char* table = buf + SCHEMA_HEADER_V2_SIZE;
+        records = table + info.count * SCHEMA_OFFSET_SIZE;
+        for (int32_t i = 0; i < info.count; i++) {
+            uint32_t offset = (uint32_t)((records - buf) + i * recordSize);
+            memcpy(table + i * SCHEMA_OFFSET_SIZE, &offset, SCHEMA_OFFSET_SIZE);
+        }
+    } else {
+        WireHeaderV1 header;
+        header.count = info.count;
+        header.maxCount = info.maxCount;
+        header.fromScreen = info.fromScreen;
+        header.pageNum = info.pageNum;
+        header.autoHideTaskbar = info.autoHideTaskbar;
+        header.more = info.more ? 1 : 0;
+        header.versionMajor = info.versionMajor;
+        header.versionMinor = info.versionMinor;
+        header.versionBuild = info.versionBuild;
+        memcpy(buf, &header, SCHEMA_HEADER_V1_SIZE);
+        records = buf + SCHEMA_HEADER_V1_SIZE;
+    }
+
+    // A PhysicalScreen is its own wire record, cut short in format 1
+    for (int32_t i = 0; i < info.count; i++) {
+        memcpy(records + i * recordSize, &screens[i], recordSize);
+    }
+    memcpy(records + info.count * recordSize, &info.fourcc, SCHEMA_FOURCC_SIZE);
+    return written;
+}
+
+double get_screen_info(char* inbuf, size_t size, int32_t pageNum, int32_t perPage) {
+    char* buf = getGMSBuffAddress(inbuf);//Interpret the string address form GMS so it can be managed by C++
+
+    // Served from the cached snapshot, which only re-enumerates on change
+    TopologyRef topology = rezol_topology_current();
+    if (rezol_write_screen_info(buf, size, *topology, pageNum, perPage, wireFormat) != 0) {
+        // buf is fine, return 0
+        return 0;
+    }
+    
+    // buf is bad, return 1
+    return 1;
+}
+
+static bool ValidSize(double size) {
+    return size >= 0 && size <= (double)UINT32_MAX;
+}
+
+static bool ValidPage(double pageNum) {
+    return pageNum >= 0 && pageNum <= INT32_MAX / SCREENS_PER_PAGE;
+}
+
+double rezol_ext_get_screen_info(char* inbuf) {
+    // Without a size only the fixed buffer the export always had is safe
+    return get_screen_info(inbuf, SCHEMA_SCREEN_INFO_LEGACY_SIZE, 0, INT32_MAX);
+}
+
+double rezol_ext_get_screen_info_page(char* buf, double pageNum) {
+    if (!ValidPage(pageNum)) {
+        return 1;
+    }
+    return get_screen_info(buf, SCHEMA_SCREEN_INFO_LEGACY_SIZE, (int32_t)pageNum, SCREENS_PER_PAGE);
+}
+
+double rezol_ext_get_screen_info_sized(char* buf, double size) {
+    // Every monitor that fits in the buffer
+    if (!ValidSize(size)) {
+        return 1;
+    }
+    return get_screen_info(buf, (size_t)size, 0, INT32_MAX);
+}
+
+double rezol_ext_get_screen_info_page_sized(char* buf, double size, double pageNum) {
+    if (!ValidSize(size) || !ValidPage(pageNum)) {
+        return 1;
+    }
+    return get_screen_info(buf, (size_t)size, (int32_t)pageNum, SCREENS_PER_PAGE);
+}
+
+double rezol_ext_get_window_chrome(char* buf, char* handle) {
+    // The handle arrives as a pointer string, the same as a buffer address
+    if (handle == nullptr || *handle == '\0') {
+        return 1;
+    }
+    WindowChrome chrome;
+    if (!rezol_platform_get_window_chrome((uintptr_t)getGMSBuffAddress(handle), &chrome)) {
+        return 1;
+    }
+    memcpy(getGMSBuffAddress(buf), &chrome, sizeof(chrome));
+    return 0;
+}
+
+
+double rezol_ext_get_buffer_size(double which) {
+    return rezol_get_buffer_size(which);
+}
+
+double rezol_ext_load_fixture(char* path) {
+    // An empty path goes back to querying the OS
+    if (path == nullptr || *path == '\0') {
+        rezol_fixture_unload();
+        rezol_topology_notify_change();
+        return 0;
+    }
+    if (!rezol_fixture_load(path)) {
+        return 1;
+    }
+    rezol_topology_notify_change();
+    return 0;
+}
+
+double rezol_ext_record_fixture(char* path) {
+    return rezol_fixture_record(path) ? 0 : 1;
+}
+
+double rezol_ext_get_topology_generation() {
+    return (double)rezol_topology_generation();
+}
+
+double rezol_ext_refresh_topology() {
+    return (double)rezol_topology_refresh()->generation;
+}
+
+double rezol_ext_mirror_register(char* buf, double size) {
+    return rezol_mirror_register(getGMSBuffAddress(buf), (size_t)size) ? 0 : 1;
+}
+
+double rezol_ext_mirror_unregister() {
+    rezol_mirror_unregister();
+    return 0;
+}
+
+double rezol_ext_get_edid_cache_hits() {
+    return (double)rezol_edid_cache_stats().hits;
+}
+
+double rezol_ext_get_edid_cache_misses() {
+    return (double)rezol_edid_cache_stats().misses;
+}
+
+double rezol_ext_set_wire_format(double format) {
+    if (format != WIRE_FORMAT_V1 && format != WIRE_FORMAT_V2) {
+        return 1;
+    }
+    wireFormat = (int32_t)format;
+    return 0;
+}
+
+static double get_screen_changes(char* buf, size_t size, double sinceGeneration) {
+    // An unknown or expired generation gets the full topology back
+    TopologyRef now = rezol_topology_current();
+    TopologyRef since = rezol_topology_find(sinceGeneration);
+    if (rezol_write_screen_changes(getGMSBuffAddress(buf), size, since.get(), *now, sinceGeneration) != 0) {
+        return 0;
+    }
+    return 1;
+}
+
+double rezol_ext_get_screen_changes(char* buf, double sinceGeneration) {
+    // Without a size only the smallest buffer ever reported is safe
+    return get_screen_changes(buf, SCHEMA_SCREEN_CHANGES_LEGACY_SIZE, sinceGeneration);
+}
+
+double rezol_ext_get_screen_changes_sized(char* buf, double size, double sinceGeneration) {
+    if (!ValidSize(size)) {
+        return 1;
+    }
+    return get_screen_changes(buf, (size_t)size, sinceGeneration);
+}
+
+double rezol_ext_monitor_from_point(double x, double y) {
+    // Off every monitor the nearest one is returned, -1 only with none
+    if (isnan(x) || isnan(y)) {
+        return -1;
+    }
+    int32_t px = (int32_t)floor(min(max(x, (double)INT32_MIN), (double)INT32_MAX));
+    int32_t py = (int32_t)floor(min(max(y, (double)INT32_MIN), (double)INT32_MAX));
+    TopologyRef topology = rezol_topology_current();
+    return rezol_index_find_nearest(topology->index, px, py);
+}
+
+double rezol_ext_monitors_from_points(char* points, char* indices, double count) {
+    // count int32 (x, y) pairs in, count int32 indices out, -1 on no monitor
+    if (!(count >= 0 && count <= INT32_MAX)) {
+        return 1;
+    }
+    TopologyRef topology = rezol_topology_current();
+    rezol_classify_points(rezol_simd_best(), topology->index, (const int32_t*)getGMSBuffAddress(points),
+                          (int32_t*)getGMSBuffAddress(indices), (size_t)count);
+    return 0;
+}
+
+double rezol_ext_monitors_from_rects(char* rects, char* placements, double count) {
+    // count GMSRects in, count RECTPLACEMENT records out
+    if (!(count >= 0 && count <= INT32_MAX)) {
+        return 1;
+    }
+    TopologyRef topology = rezol_topology_current();
+    rezol_place_rects(rezol_simd_best(), topology->index, topology->screens, (const GMSRect*)getGMSBuffAddress(rects),
+                      (WireRectPlacement*)getGMSBuffAddress(placements), (size_t)count);
+    return 0;
+}
+
+static bool ValidSpace(double space) {
+    return space == SPACE_LOGICAL || space == SPACE_PIXELS || space == SPACE_MM;
+}
+
+double rezol_ext_transform_points(char* points, char* out, double count, double from, double to) {
+    // count f64 (x, y) pairs, out may be the same buffer
+    if (!(count >= 0 && count <= INT32_MAX) || !ValidSpace(from) || !ValidSpace(to)) {
+        return 1;
+    }
+    TopologyRef topology = rezol_topology_current();
+    rezol_space_transform_points(topology->spaces, (int32_t)from, (int32_t)to, (const double*)getGMSBuffAddress(points),
+                                 (double*)getGMSBuffAddress(out), (size_t)count);
+    return 0;
+}
+
+double rezol_ext_transform_rects(char* rects, char* out, double count, double from, double to) {
+    // count f64 (left, top, right, bottom) rects, out may be the same buffer
+    if (!(count >= 0 && count <= INT32_MAX) || !ValidSpace(from) || !ValidSpace(to)) {
+        return 1;
+    }
+    TopologyRef topology = rezol_topology_current();
+    rezol_space_transform_rects(topology->spaces, (int32_t)from, (int32_t)to, (const double*)getGMSBuffAddress(rects),
+                                (double*)getGMSBuffAddress(out), (size_t)count);
+    return 0;
+}
+
+double rezol_ext_get_stats(char* buf) {
+    StageStats stats[STAT_STAGE_COUNT];
+    bool enabled = rezol_stats_read(stats);
+
+    char* out = getGMSBuffAddress(buf);
+    WireStatsHeader header;
+    header.magic = WIRE_MAGIC_STATS;
+    header.enabled = enabled ? 1 : 0;
+    header.stageCount = STAT_STAGE_COUNT;
+    header.recordSize = (uint16_t)SCHEMA_STAGE_RECORD_SIZE;
+    memcpy(out, &header, SCHEMA_STATS_HEADER_SIZE);
+    out += SCHEMA_STATS_HEADER_SIZE;
+    for (int32_t i = 0; i < STAT_STAGE_COUNT; i++) {
+        WireStageStats record;
+        record.calls = (double)stats[i].calls;
+        record.totalUs = stats[i].totalNs / 1000.0;
+        record.lastUs = stats[i].lastNs / 1000.0;
+        record.maxUs = stats[i].maxNs / 1000.0;
+        memcpy(out, &record, SCHEMA_STAGE_RECORD_SIZE);
+        out += SCHEMA_STAGE_RECORD_SIZE;
+    }
+    memcpy(out, &GMEX, SCHEMA_FOURCC_SIZE);
+
+    // Still a valid buffer of zeros without stats, but say so
+    return enabled ? 0 : 1;
+}
+
+double rezol_ext_get_trace(char* buf) {
+    string json = rezol_trace_json();
+    if (json.empty() || json.size() > TRACE_JSON_MAX) {
+        return 1;
+    }
+    memcpy(getGMSBuffAddress(buf), json.c_str(), json.size() + 1);
+    return 0;
+}
+
+double rezol_ext_save_trace(char* path) {
+    string json = rezol_trace_json();
+    if (path == nullptr || *path == '\0' || json.empty()) {
+        return 1;
+    }
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return 1;
+    }
+    bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+    ok = (fclose(file) == 0) && ok;
+    return ok ? 0 : 1;
+}
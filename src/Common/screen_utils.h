@@ -0,0 +1,131 @@
+#ifndef SCREEN_UTILS_H
+#define SCREEN_UTILS_H
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstddef> // For size_t
+#include <cstdint> // For int32_t
+
+// This macro handles the keywords for exporting from a DLL
+// and importing into an executable.
+#ifdef _WIN32
+    #ifdef SCREEN_UTILS_EXPORTS
+        #define SCREEN_API __declspec(dllexport)
+    #else
+        #define SCREEN_API __declspec(dllimport)
+    #endif
+#else
+    #define SCREEN_API __attribute__((visibility("default")))
+#endif
+
+// Custom type definition used in the struct
+
+constexpr int     SCREENS_PER_PAGE = 8; // monitors per rezol_ext_get_screen_info_page call
+constexpr uint8_t GMSVersionMajor = 0;
+constexpr uint8_t GMSVersionMinor = 3;
+constexpr uint8_t GMSVersionBuild = 0;
+constexpr uint32_t GMEX = 0x474D4558; // "GMEX"
+constexpr size_t MONITOR_NAME_BUFFER_SIZE = 64;
+
+enum REZOL_DATA_BUFFER {
+    SCREENINFOHEADER,
+    SCREENINFO,
+    PHYSICALSCREEN,
+    WINDOWCHROME,
+    SCREENMIRROR,
+    SCREENCHANGES,
+    RECTPLACEMENT,
+    STATS,
+    TRACE
+};
+
+// Struct definitions that are part of the public API
+struct GMSRect {
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+struct GMSBox {
+    int32_t width;
+    int32_t height;
+};
+
+struct PhysicalSize {
+    int32_t width;
+    int32_t height;
+    int32_t diagonal;
+};
+
+struct ScreenDPI {
+    int32_t effectiveX; // what the desktop renders at, 96 at 100% scale
+    int32_t effectiveY;
+    int32_t rawX;       // native panel pixels per inch, 0 if the size is unknown
+    int32_t rawY;
+};
+
+struct PhysicalScreen {
+    int32_t         errorCode;
+    int32_t         refreshRate;
+    int32_t         isPrimary;
+    GMSBox          pixelBox;
+    GMSRect         virtualRect;
+    GMSRect         workingRect;
+    PhysicalSize    physSize;
+	char   			name[MONITOR_NAME_BUFFER_SIZE];
+    ScreenDPI       dpi;
+    double          scale; // desktop scale factor, native pixels per logical pixel
+};
+
+struct ScreenInfo {
+    int32_t count;
+    int32_t maxCount;
+    int32_t fromScreen;
+    int32_t pageNum;
+    int32_t autoHideTaskbar; // passed to gml as 4 int32_t for 4 byte alignment
+    uint8_t more; // 8 bit
+    uint8_t versionMajor = GMSVersionMajor; // 8 bit
+    uint8_t versionMinor = GMSVersionMinor; // 8 bit
+    uint8_t versionBuild = GMSVersionBuild; // 8 bit
+    PhysicalScreen* screen;
+    uint32_t fourcc      = GMEX;
+};
+
+struct WindowChrome {
+    GMSRect  outerRect;
+    GMSRect  innerRect;
+    uint32_t fourcc = GMEX;
+};
+
+// Declare the functions that the library will export.
+// The SCREEN_API macro marks them for export.
+extern "C" SCREEN_API double rezol_ext_get_buffer_size(double which);
+extern "C" SCREEN_API double rezol_ext_get_screen_info(char* buf);
+extern "C" SCREEN_API double rezol_ext_get_screen_info_page(char* buf, double pageNum);
+extern "C" SCREEN_API double rezol_ext_get_screen_info_sized(char* buf, double size);
+extern "C" SCREEN_API double rezol_ext_get_screen_info_page_sized(char* buf, double size, double pageNum);
+extern "C" SCREEN_API double rezol_ext_get_window_chrome(char* buf, char* handle);
+extern "C" SCREEN_API double rezol_ext_get_topology_generation();
+extern "C" SCREEN_API double rezol_ext_refresh_topology();
+extern "C" SCREEN_API double rezol_ext_load_fixture(char* path);
+extern "C" SCREEN_API double rezol_ext_record_fixture(char* path);
+extern "C" SCREEN_API double rezol_ext_mirror_register(char* buf, double size);
+extern "C" SCREEN_API double rezol_ext_mirror_unregister();
+extern "C" SCREEN_API double rezol_ext_get_edid_cache_hits();
+extern "C" SCREEN_API double rezol_ext_get_edid_cache_misses();
+extern "C" SCREEN_API double rezol_ext_set_wire_format(double format);
+extern "C" SCREEN_API double rezol_ext_get_screen_changes(char* buf, double sinceGeneration);
+extern "C" SCREEN_API double rezol_ext_get_screen_changes_sized(char* buf, double size, double sinceGeneration);
+extern "C" SCREEN_API double rezol_ext_monitor_from_point(double x, double y);
+extern "C" SCREEN_API double rezol_ext_monitors_from_points(char* points, char* indices, double count);
+extern "C" SCREEN_API double rezol_ext_monitors_from_rects(char* rects, char* placements, double count);
+extern "C" SCREEN_API double rezol_ext_transform_points(char* points, char* out, double count, double from, double to);
+extern "C" SCREEN_API double rezol_ext_transform_rects(char* rects, char* out, double count, double from, double to);
+extern "C" SCREEN_API double rezol_ext_get_stats(char* buf);
+extern "C" SCREEN_API double rezol_ext_get_trace(char* buf);
+extern "C" SCREEN_API double rezol_ext_save_trace(char* path);
+extern "C" SCREEN_API int32_t __internal_get_virtual_screens(ScreenInfo* info);
+
+#endif // SCREEN_UTILS_H
@@ -0,0 +1,128 @@
+#ifndef SCREEN_WIRE_H
+#define SCREEN_WIRE_H
+
+#include "screen_utils.h"
+#include <cstddef>
+
+// On-wire layouts of the SCREENINFO buffer. Everything is little-endian
+// with no padding, and a PhysicalScreen in memory already is the wire
+// record, so backends fill records in place during enumeration and
+// serializing is one memcpy per monitor. Buffer sizes come from
+// screen_schema.h.
+//
+// Version 1, the original layout and still the default:
+//   WireHeaderV1, count 128 byte records (each PhysicalScreen up to but
+//   not including dpi), uint32 fourcc "GMEX"
+// Version 2:
+//   WireHeaderV2, count uint32 record offsets (from the start of the
+//   buffer), count PhysicalScreen records, uint32 fourcc "GMEX"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The GML buffer layout is little-endian"
+#endif
+
+enum REZOL_WIRE_FORMAT {
+    WIRE_FORMAT_V1 = 1,
+    WIRE_FORMAT_V2 = 2
+};
+
+constexpr uint32_t WIRE_MAGIC_V2 = 0x32534D47;      // "GMS2"
+constexpr uint32_t WIRE_MAGIC_CHANGES = 0x44534D47; // "GMSD"
+constexpr uint32_t WIRE_MAGIC_STATS = 0x54534D47;   // "GMST"
+
+#pragma pack(push, 1)
+
+struct WireHeaderV1 {
+    int32_t count;
+    int32_t maxCount;
+    int32_t fromScreen;
+    int32_t pageNum;
+    int32_t autoHideTaskbar;
+    uint8_t more;
+    uint8_t versionMajor;
+    uint8_t versionMinor;
+    uint8_t versionBuild;
+};
+
+struct WireHeaderV2 {
+    uint32_t magic;         // WIRE_MAGIC_V2
+    uint16_t format;        // WIRE_FORMAT_V2
+    uint16_t headerSize;    // sizeof(WireHeaderV2), the offset table follows
+    uint16_t recordSize;    // sizeof(PhysicalScreen)
+    uint16_t reserved;
+    int32_t  count;
+    int32_t  maxCount;
+    int32_t  fromScreen;
+    int32_t  pageNum;
+    int32_t  autoHideTaskbar;
+    uint8_t  more;
+    uint8_t  versionMajor;
+    uint8_t  versionMinor;
+    uint8_t  versionBuild;
+    uint32_t totalSize;     // bytes written, fourcc included
+};
+
+// SCREENCHANGES buffer:
+//   WireChangesHeader, recordCount change records, uint32 fourcc "GMEX"
+// Each record is a WireChangeRecord followed by the field groups whose
+// bit is set in its mask, in bit order (see ScreenChangeGroups).
+
+enum REZOL_CHANGE_KIND {
+    CHANGE_ADDED = 1,
+    CHANGE_REMOVED = 2,
+    CHANGE_MODIFIED = 3
+};
+
+struct WireChangesHeader {
+    uint32_t magic;           // WIRE_MAGIC_CHANGES
+    uint8_t  full;            // since was unknown, every monitor is an add
+    uint8_t  taskbarChanged;
+    uint16_t recordCount;
+    int32_t  screenCount;     // monitors in the new topology
+    int32_t  autoHideTaskbar;
+    double   sinceGeneration;
+    double   generation;      // pass this as since next time
+    uint32_t totalSize;       // bytes written, fourcc included
+};
+
+struct WireChangeRecord {
+    uint8_t  kind;            // REZOL_CHANGE_KIND
+    uint8_t  reserved;
+    uint16_t mask;            // field groups that follow
+    int32_t  index;           // monitor index in the new (added, modified) or old (removed) list
+};
+
+// One RECTPLACEMENT record per rect given to rezol_ext_monitors_from_rects
+struct WireRectPlacement {
+    int32_t screen;           // monitor with the largest overlap, -1 with no monitors
+    int32_t nearest;          // 1 when the rect was on no monitor and the nearest one was picked
+    double  area;             // overlap with that monitor's virtualRect in pixels
+    GMSRect rect;             // the rect moved, and shrunk if need be, into its workingRect
+};
+
+// STATS buffer from rezol_ext_get_stats: this header, stageCount
+// WireStageStats records in REZOL_STAT_STAGE order (screen_stats.h), then
+// the uint32 fourcc "GMEX". Times are in microseconds, as get_timer() is.
+struct WireStatsHeader {
+    uint32_t magic;           // WIRE_MAGIC_STATS
+    uint8_t  enabled;         // 0 when the library was built without stats
+    uint8_t  stageCount;
+    uint16_t recordSize;
+};
+
+struct WireStageStats {
+    double calls;
+    double totalUs;
+    double lastUs;            // in the last enumeration, or the last call for enumerate and serialize
+    double maxUs;             // longest single call
+};
+
+#pragma pack(pop)
+
+// Sizes and offsets are checked against the field lists in
+// screen_schema.h; any change to them is a new format version.
+
+// Format written by rezol_ext_get_screen_info and the mirrored buffer
+int32_t rezol_wire_format();
+
+#endif // SCREEN_WIRE_H
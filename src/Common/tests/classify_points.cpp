@@ -0,0 +1,95 @@
+// Checks every batched classification kernel this CPU can run gives the
+// same monitor for every point as the spatial index, on odd batch sizes and
+// misaligned buffers, and that the export reads and writes GML buffers.
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_classify.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+// Edges, one pixel either side, random points and the int32 extremes
+static vector<int32_t> MakePoints(const vector<PhysicalScreen>& screens) {
+    vector<int32_t> points;
+    FixtureRandom next(99);
+    for (const PhysicalScreen& s : screens) {
+        for (int32_t d : { -1, 0, 1 }) {
+            points.insert(points.end(), { s.virtualRect.left + d, s.virtualRect.top + d });
+            points.insert(points.end(), { s.virtualRect.right + d, s.virtualRect.bottom + d });
+            points.insert(points.end(), { s.virtualRect.left + d, s.virtualRect.bottom + d });
+            points.insert(points.end(), { s.virtualRect.right + d, s.virtualRect.top + d });
+        }
+        for (int i = 0; i < 16; i++) {
+            int32_t x = s.virtualRect.left - 50 + next.Below(2100);
+            int32_t y = s.virtualRect.top - 50 + next.Below(1200);
+            points.insert(points.end(), { x, y });
+        }
+    }
+    points.insert(points.end(), { INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX, 0, INT32_MIN, INT32_MAX, 0 });
+    return points;
+}
+
+static void CheckKernel(int32_t kernel, const vector<PhysicalScreen>& screens) {
+    ScreenIndex index;
+    rezol_index_build(index, screens);
+    vector<int32_t> points = MakePoints(screens);
+    size_t count = points.size() / 2;
+
+    // One int32 in, so neither buffer is 16 or 32 byte aligned
+    vector<int32_t> in(1, 0);
+    in.insert(in.end(), points.begin(), points.end());
+    vector<int32_t> out(count + 2, 12345);
+    rezol_classify_points(kernel, index, in.data() + 1, out.data() + 1, count);
+
+    int mismatches = 0;
+    for (size_t p = 0; p < count; p++) {
+        int32_t want = rezol_index_find(index, points[2 * p], points[2 * p + 1]);
+        if (out[p + 1] != want && mismatches++ < 5) {
+            printf("kernel %d, point %d,%d: got %d, want %d\n", kernel, points[2 * p], points[2 * p + 1], out[p + 1], want);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(out[0] == 12345 && out[count + 1] == 12345);
+
+    // Every batch length up to a few vectors, for the scalar tails
+    for (size_t n = 0; n <= 37 && n <= count; n++) {
+        vector<int32_t> part(n + 1, 12345);
+        rezol_classify_points(kernel, index, points.data(), part.data(), n);
+        for (size_t p = 0; p < n; p++) {
+            CHECK(part[p] == out[p + 1]);
+        }
+        CHECK(part[n] == 12345);
+    }
+}
+
+int main() {
+    printf("best kernel: %d\n", rezol_simd_best());
+    CHECK(rezol_simd_supported(SIMD_SCALAR));
+    CHECK(rezol_simd_supported(rezol_simd_best()));
+
+    vector<vector<PhysicalScreen>> layouts = MakeKernelLayouts({ 1, 2, 3, 8, 64, 256 });
+    for (int32_t kernel : { (int32_t)SIMD_SCALAR, (int32_t)SIMD_SSE2, (int32_t)SIMD_AVX2 }) {
+        if (!rezol_simd_supported(kernel)) {
+            printf("kernel %d not supported here, skipped\n", kernel);
+            continue;
+        }
+        for (const vector<PhysicalScreen>& screens : layouts) {
+            CheckKernel(kernel, screens);
+        }
+    }
+
+    // Through the export, on the topology snapshot
+    ScopedFixture fixture("gms_classify_test.gmsf", MakeMixedDPI());
+    CHECK(fixture.loaded);
+    vector<int32_t> points = { 10, 10, 1919, 10, 1920, 10, 5000, 500, -50, -50, 4000, 1079, 4000, 1080, 0, 0, 3840, 0 };
+    vector<int32_t> out(points.size() / 2);
+    BufferAddress in(points.data()), to(out.data());
+    CHECK(rezol_ext_monitors_from_points(in, to, (double)out.size()) == 0);
+    CHECK(out == vector<int32_t>({ 0, 0, 1, 2, -1, 2, -1, 0, 2 }));
+    CHECK(rezol_ext_monitors_from_points(in, to, -1) == 1);
+
+    return TestResult();
+}
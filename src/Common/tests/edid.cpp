@@ -0,0 +1,202 @@
+// Checks the shared EDID parser on base blocks, CTA-861 and DisplayID
+// extensions, and that broken or truncated blobs are rejected or flagged
+// rather than read past.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "edid.h"
+#include "tests/edid_blobs.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static void TestBaseBlock() {
+    EDIDBlob edid = MakeEDID(2560, 1440, 160, 41, 24150, 597, 336, "DELL U2723QE");
+    EDIDSetVendor(edid, "DEL", 0x41B2, 0x12345678, 12, 2022);
+    EDIDSetRangeAndSerial(edid, 48, 75, 30, 140, 600, "7J1QR93");
+
+    EDIDInfo info;
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(strcmp(info.manufacturer, "DEL") == 0);
+    CHECK(info.productCode == 0x41B2);
+    CHECK(info.serialNumber == 0x12345678);
+    CHECK(strcmp(info.serialText, "7J1QR93") == 0);
+    CHECK(strcmp(info.name, "DELL U2723QE") == 0);
+    CHECK(info.week == 12);
+    CHECK(info.year == 2022);
+    CHECK(!info.modelYear);
+    CHECK(info.version == 1 && info.revision == 4);
+    CHECK(info.digital);
+    CHECK(info.checksumValid);
+    CHECK(info.extensionCount == 0);
+    CHECK(!info.hasCTA && !info.hasDisplayID);
+
+    CHECK(info.hasPreferredTiming);
+    CHECK(info.preferredTiming.pixelClockKHz == 241500);
+    CHECK(info.preferredTiming.hActive == 2560 && info.preferredTiming.vActive == 1440);
+    CHECK(info.preferredTiming.hBlank == 160 && info.preferredTiming.vBlank == 41);
+    // 241.5 MHz / (2720 * 1481) = 59.951 Hz
+    CHECK(info.preferredTiming.refreshMilliHz == 59951);
+    CHECK(rezol_edid_refresh_rate(info, 2560, 1440) == 60);
+    CHECK(rezol_edid_refresh_rate(info, 1920, 1080) == 0);
+    CHECK(info.widthMM == 597 && info.heightMM == 336);
+
+    CHECK(info.hasRangeLimits);
+    CHECK(info.rangeLimits.minVerticalHz == 48 && info.rangeLimits.maxVerticalHz == 75);
+    CHECK(info.rangeLimits.minHorizontalKHz == 30 && info.rangeLimits.maxHorizontalKHz == 140);
+    CHECK(info.rangeLimits.maxPixelClockMHz == 600);
+}
+
+static void TestSizeFallback() {
+    // No image size in the DTD, only the cm fields
+    EDIDBlob edid = MakeEDID(1920, 1080, 280, 45, 14850, 0, 0, nullptr);
+    edid[21] = 53;
+    edid[22] = 30;
+    EDIDFinish(edid);
+
+    EDIDInfo info;
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(info.widthMM == 530 && info.heightMM == 300);
+    CHECK(info.name[0] == '\0');
+
+    // A model year instead of a manufacture week
+    edid[16] = 0xFF;
+    EDIDFinish(edid);
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(info.modelYear && info.week == 0);
+}
+
+static void TestCTA() {
+    EDIDBlob edid = MakeEDID(3840, 2160, 560, 90, 59400, 1210, 680, "LG TV");
+    EDIDAppendCTA(edid, { 0x80 | 16, 4, 97 }, true, 1920, 1080, 280, 45, 14850);
+
+    EDIDInfo info;
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(info.checksumValid);
+    CHECK(info.extensionCount == 1);
+    CHECK(info.hasCTA);
+    CHECK(info.cta.revision == 3);
+    CHECK(info.cta.underscan && info.cta.basicAudio);
+    CHECK(info.cta.ycbcr444 && info.cta.ycbcr422);
+    CHECK(info.cta.nativeTimings == 1);
+    CHECK(info.cta.vicCount == 3);
+    CHECK(info.cta.nativeVIC == 16);
+    CHECK(info.cta.hdmi);
+    CHECK(info.cta.maxTMDSMHz == 340);
+    CHECK(info.cta.hdrEOTFs == 0x0F);
+    // The base block DTD stays the preferred timing
+    CHECK(info.preferredTiming.hActive == 3840);
+    CHECK(rezol_edid_refresh_rate(info, 3840, 2160) == 60);
+
+    // Without one in the base block the CTA DTD is used
+    memset(edid.data() + 54, 0, 18);
+    edid[54 + 3] = 0x10; // dummy descriptor
+    EDIDFinish(edid);
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(info.hasPreferredTiming);
+    CHECK(info.preferredTiming.hActive == 1920 && info.preferredTiming.vActive == 1080);
+    CHECK(info.widthMM == 1210 && info.heightMM == 680);
+}
+
+static void TestDisplayID() {
+    // One tile of a 2x1 tiled 5K panel, the base block has no timing or name
+    EDIDBlob edid = MakeEDID(2560, 2880, 160, 62, 0, 0, 0, nullptr);
+    EDIDAppendDisplayID(edid, "LG UltraFine", 5970, 3360, 2560, 2880, 160, 62, 48325, 2, 1, 1, 0);
+
+    EDIDInfo info;
+    CHECK(rezol_edid_parse(edid.data(), edid.size(), info));
+    CHECK(info.checksumValid);
+    CHECK(info.hasDisplayID);
+    CHECK(info.displayID.version == 0x13);
+    CHECK(info.displayID.productType == 3);
+    CHECK(strcmp(info.name, "LG UltraFine") == 0);
+    CHECK(info.displayID.widthMM == 597 && info.displayID.heightMM == 336);
+    CHECK(info.widthMM == 597 && info.heightMM == 336);
+    CHECK(info.displayID.tilesH == 2 && info.displayID.tilesV == 1);
+    CHECK(info.displayID.tileX == 1 && info.displayID.tileY == 0);
+    CHECK(info.hasPreferredTiming);
+    CHECK(info.preferredTiming.pixelClockKHz == 483250);
+    CHECK(info.preferredTiming.hActive == 2560 && info.preferredTiming.vActive == 2880);
+    CHECK(rezol_edid_refresh_rate(info, 2560, 2880) == 60);
+
+    // CTA and DisplayID together, both are read
+    EDIDBlob both = MakeEDID(1920, 1080, 280, 45, 14850, 527, 296, "Both");
+    EDIDAppendCTA(both, { 16 }, false, 1280, 720, 370, 30, 7425);
+    EDIDAppendDisplayID(both, "Ignored", 5270, 2960, 1920, 1080, 280, 45, 14850, 1, 1, 0, 0);
+    CHECK(rezol_edid_parse(both.data(), both.size(), info));
+    CHECK(info.extensionCount == 2);
+    CHECK(info.hasCTA && info.hasDisplayID);
+    CHECK(info.cta.hdrEOTFs == 0);
+    CHECK(strcmp(info.name, "Both") == 0);
+}
+
+static void TestBroken() {
+    EDIDInfo info;
+    EDIDBlob edid = MakeEDID(1920, 1080, 280, 45, 14850, 527, 296, "Broken");
+
+    CHECK(!rezol_edid_parse(nullptr, 0, info));
+    CHECK(!rezol_edid_parse(edid.data(), 127, info));
+
+    EDIDBlob badHeader = edid;
+    badHeader[1] = 0;
+    CHECK(!rezol_edid_parse(badHeader.data(), badHeader.size(), info));
+
+    // A bad checksum is flagged but the data is still used
+    EDIDBlob badSum = edid;
+    badSum[127] ^= 1;
+    CHECK(rezol_edid_parse(badSum.data(), badSum.size(), info));
+    CHECK(!info.checksumValid);
+    CHECK(strcmp(info.name, "Broken") == 0);
+
+    // Extensions claimed but not present are not read
+    EDIDBlob truncated = edid;
+    EDIDAppendCTA(truncated, { 16 }, true, 1280, 720, 370, 30, 7425);
+    CHECK(rezol_edid_parse(truncated.data(), 128, info));
+    CHECK(info.extensionCount == 0 && !info.hasCTA);
+
+    // A CTA block whose data blocks and DTD offset run off the end
+    EDIDBlob overrun = truncated;
+    unsigned char* cta = overrun.data() + 128;
+    cta[2] = 127;
+    cta[4] = (2 << 5) | 31;
+    EDIDFinish(overrun);
+    CHECK(rezol_edid_parse(overrun.data(), overrun.size(), info));
+    CHECK(info.hasCTA);
+    CHECK(info.cta.vicCount <= 31);
+
+    // DisplayID section length larger than the block
+    EDIDBlob did = edid;
+    EDIDAppendDisplayID(did, "Long", 5270, 2960, 1920, 1080, 280, 45, 14850, 1, 1, 0, 0);
+    did[128 + 2] = 250;
+    did[128 + 7] = 120;
+    EDIDFinish(did);
+    CHECK(rezol_edid_parse(did.data(), did.size(), info));
+    CHECK(info.hasDisplayID);
+    CHECK(strcmp(info.name, "Broken") == 0);
+
+    // Random garbage after a good header never crashes
+    unsigned seed = 1;
+    for (int round = 0; round < 2000; round++) {
+        EDIDBlob noise(4 * EDID_BLOCK_SIZE);
+        for (unsigned char& c : noise) {
+            seed = seed * 1103515245u + 12345u;
+            c = (unsigned char)(seed >> 16);
+        }
+        memcpy(noise.data(), edid.data(), 8);
+        noise[126] = 3;
+        noise[128] = (round & 1) ? 0x02 : 0x70;
+        noise[256] = (round & 1) ? 0x70 : 0x02;
+        rezol_edid_parse(noise.data(), noise.size(), info);
+        CHECK(info.name[sizeof(info.name) - 1] == '\0');
+        CHECK(info.serialText[sizeof(info.serialText) - 1] == '\0');
+    }
+}
+
+int main() {
+    TestBaseBlock();
+    TestSizeFallback();
+    TestCTA();
+    TestDisplayID();
+    TestBroken();
+    return TestResult();
+}
@@ -0,0 +1,211 @@
+#ifndef EDID_BLOBS_H
+#define EDID_BLOBS_H
+
+// Builders for synthetic EDID blobs, used by the parser test, the DRM
+// sysfs test and the EDID benchmark.
+#include <cstring>
+#include <vector>
+
+typedef std::vector<unsigned char> EDIDBlob;
+
+static inline void EDIDSetChecksum(unsigned char* block) {
+    unsigned char sum = 0;
+    for (int i = 0; i < 127; i++) {
+        sum += block[i];
+    }
+    block[127] = (unsigned char)(256 - sum);
+}
+
+// Fix every block's checksum and the extension count
+static inline void EDIDFinish(EDIDBlob& edid) {
+    edid[126] = (unsigned char)(edid.size() / 128 - 1);
+    for (size_t off = 0; off + 128 <= edid.size(); off += 128) {
+        EDIDSetChecksum(edid.data() + off);
+    }
+}
+
+static inline void EDIDWriteDTD(unsigned char* dtd, int hActive, int vActive, int hBlank, int vBlank,
+                                int clock10kHz, int widthMM, int heightMM) {
+    dtd[0] = clock10kHz & 0xFF;
+    dtd[1] = clock10kHz >> 8;
+    dtd[2] = hActive & 0xFF;
+    dtd[3] = hBlank & 0xFF;
+    dtd[4] = ((hActive >> 8) << 4) | (hBlank >> 8);
+    dtd[5] = vActive & 0xFF;
+    dtd[6] = vBlank & 0xFF;
+    dtd[7] = ((vActive >> 8) << 4) | (vBlank >> 8);
+    dtd[12] = widthMM & 0xFF;
+    dtd[13] = heightMM & 0xFF;
+    dtd[14] = ((widthMM >> 8) << 4) | (heightMM >> 8);
+}
+
+// Display descriptor with up to 13 characters of text (0xFC name, 0xFF serial)
+static inline void EDIDWriteText(unsigned char* descriptor, unsigned char tag, const char* text) {
+    memset(descriptor, 0, 18);
+    descriptor[3] = tag;
+    memset(descriptor + 5, ' ', 13);
+    size_t len = strlen(text);
+    if (len > 13) {
+        len = 13;
+    }
+    memcpy(descriptor + 5, text, len);
+    if (len < 13) {
+        descriptor[5 + len] = 0x0A;
+    }
+}
+
+// 128 byte EDID with one detailed timing and an optional 0xFC name
+static inline EDIDBlob MakeEDID(int hActive, int vActive, int hBlank, int vBlank,
+                                int clock10kHz, int widthMM, int heightMM, const char* name) {
+    EDIDBlob edid(128, 0);
+    const unsigned char header[8] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+    memcpy(edid.data(), header, 8);
+    edid[18] = 1;
+    edid[19] = 4;
+    edid[20] = 0x80; // digital
+    edid[21] = widthMM / 10;
+    edid[22] = heightMM / 10;
+
+    EDIDWriteDTD(edid.data() + 54, hActive, vActive, hBlank, vBlank, clock10kHz, widthMM, heightMM);
+    if (name != nullptr) {
+        EDIDWriteText(edid.data() + 72, 0xFC, name);
+    }
+    EDIDFinish(edid);
+    return edid;
+}
+
+// Manufacturer id, product code, serial and date
+static inline void EDIDSetVendor(EDIDBlob& edid, const char* pnp, int product, unsigned serial, int week, int year) {
+    unsigned id = ((pnp[0] - 'A' + 1) << 10) | ((pnp[1] - 'A' + 1) << 5) | (pnp[2] - 'A' + 1);
+    edid[8] = id >> 8;
+    edid[9] = id & 0xFF;
+    edid[10] = product & 0xFF;
+    edid[11] = product >> 8;
+    for (int i = 0; i < 4; i++) {
+        edid[12 + i] = (serial >> (8 * i)) & 0xFF;
+    }
+    edid[16] = week;
+    edid[17] = year - 1990;
+    EDIDFinish(edid);
+}
+
+// Range limits and serial text in the third and fourth descriptors
+static inline void EDIDSetRangeAndSerial(EDIDBlob& edid, int minV, int maxV, int minH, int maxH,
+                                         int maxClockMHz, const char* serial) {
+    unsigned char* range = edid.data() + 90;
+    memset(range, 0, 18);
+    range[3] = 0xFD;
+    range[5] = minV;
+    range[6] = maxV;
+    range[7] = minH;
+    range[8] = maxH;
+    range[9] = maxClockMHz / 10;
+    EDIDWriteText(edid.data() + 108, 0xFF, serial);
+    EDIDFinish(edid);
+}
+
+// CTA-861 block: VICs (bit 7 marks native), an HDMI VSDB, HDR static
+// metadata and one DTD
+static inline void EDIDAppendCTA(EDIDBlob& edid, const std::vector<unsigned char>& vics, bool hdr,
+                                 int hActive, int vActive, int hBlank, int vBlank, int clock10kHz) {
+    size_t base = edid.size();
+    edid.resize(base + 128, 0);
+    unsigned char* b = edid.data() + base;
+    b[0] = 0x02;
+    b[1] = 3;
+    b[3] = 0x80 | 0x40 | 0x20 | 0x10 | 1; // underscan, audio, 4:4:4, 4:2:2, 1 native DTD
+    size_t pos = 4;
+    b[pos++] = (2 << 5) | (unsigned char)vics.size();
+    for (unsigned char vic : vics) {
+        b[pos++] = vic;
+    }
+    // HDMI VSDB: OUI 00-0C-03, physical address, flags, max TMDS 340 MHz
+    const unsigned char vsdb[] = { 0x03, 0x0C, 0x00, 0x10, 0x00, 0x00, 68 };
+    b[pos++] = (3 << 5) | sizeof(vsdb);
+    memcpy(b + pos, vsdb, sizeof(vsdb));
+    pos += sizeof(vsdb);
+    if (hdr) {
+        // Extended tag 6: SDR, HDR, PQ and HLG, static metadata type 1
+        b[pos++] = (7 << 5) | 3;
+        b[pos++] = 6;
+        b[pos++] = 0x0F;
+        b[pos++] = 0x01;
+    }
+    b[2] = (unsigned char)pos;
+    EDIDWriteDTD(b + pos, hActive, vActive, hBlank, vBlank, clock10kHz, 0, 0);
+    EDIDFinish(edid);
+}
+
+// DisplayID 1.3 block: product id with a name, display parameters in
+// 0.1 mm, one preferred type I timing and a tiled topology
+static inline void EDIDAppendDisplayID(EDIDBlob& edid, const char* name, int widthTenthMM, int heightTenthMM,
+                                       int hActive, int vActive, int hBlank, int vBlank, int clock10kHz,
+                                       int tilesH, int tilesV, int tileX, int tileY) {
+    size_t base = edid.size();
+    edid.resize(base + 128, 0);
+    unsigned char* b = edid.data() + base;
+    b[0] = 0x70;
+    b[1] = 0x13;
+    b[3] = 0x03; // product type
+    size_t pos = 5;
+
+    size_t nameLen = strlen(name);
+    b[pos++] = 0x00;
+    b[pos++] = 0;
+    b[pos++] = (unsigned char)(12 + nameLen);
+    pos += 11; // OUI, product, serial, week, year left zero
+    b[pos++] = (unsigned char)nameLen;
+    memcpy(b + pos, name, nameLen);
+    pos += nameLen;
+
+    b[pos++] = 0x01;
+    b[pos++] = 0;
+    b[pos++] = 12;
+    b[pos] = widthTenthMM & 0xFF;
+    b[pos + 1] = widthTenthMM >> 8;
+    b[pos + 2] = heightTenthMM & 0xFF;
+    b[pos + 3] = heightTenthMM >> 8;
+    b[pos + 4] = hActive & 0xFF;
+    b[pos + 5] = hActive >> 8;
+    b[pos + 6] = vActive & 0xFF;
+    b[pos + 7] = vActive >> 8;
+    pos += 12;
+
+    b[pos++] = 0x03;
+    b[pos++] = 0;
+    b[pos++] = 20;
+    unsigned clock = clock10kHz - 1;
+    b[pos] = clock & 0xFF;
+    b[pos + 1] = (clock >> 8) & 0xFF;
+    b[pos + 2] = clock >> 16;
+    b[pos + 3] = 0x80; // preferred
+    b[pos + 4] = (hActive - 1) & 0xFF;
+    b[pos + 5] = (hActive - 1) >> 8;
+    b[pos + 6] = (hBlank - 1) & 0xFF;
+    b[pos + 7] = (hBlank - 1) >> 8;
+    b[pos + 12] = (vActive - 1) & 0xFF;
+    b[pos + 13] = (vActive - 1) >> 8;
+    b[pos + 14] = (vBlank - 1) & 0xFF;
+    b[pos + 15] = (vBlank - 1) >> 8;
+    pos += 20;
+
+    b[pos++] = 0x12;
+    b[pos++] = 0;
+    b[pos++] = 22;
+    b[pos + 1] = (unsigned char)((((tilesH - 1) & 0x0F) << 4) | ((tilesV - 1) & 0x0F));
+    b[pos + 2] = (unsigned char)(((tileX & 0x0F) << 4) | (tileY & 0x0F));
+    b[pos + 3] = (unsigned char)(((((tilesH - 1) >> 4) & 3) << 6) | ((((tilesV - 1) >> 4) & 3) << 4) |
+                                 (((tileX >> 4) & 3) << 2) | ((tileY >> 4) & 3));
+    pos += 22;
+
+    b[2] = (unsigned char)(pos - 5);
+    // Section checksum covers bytes 1 .. pos - 1
+    unsigned char sum = 0;
+    for (size_t i = 1; i < pos; i++) {
+        sum += b[i];
+    }
+    b[pos] = (unsigned char)(256 - sum);
+    EDIDFinish(edid);
+}
+
+#endif // EDID_BLOBS_H
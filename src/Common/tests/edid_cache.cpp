@@ -0,0 +1,100 @@
+// Checks the parsed EDID cache returns the same results as the parser,
+// counts hits and misses, stays within its size and never confuses two
+// monitors whose EDIDs differ by a single byte.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "edid.h"
+#include "tests/edid_blobs.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static EDIDBlob Monitor(int i) {
+    char name[16];
+    snprintf(name, sizeof(name), "Panel %d", i);
+    EDIDBlob edid = MakeEDID(1920, 1080, 280, 45, 14850, 500 + i, 300, name);
+    EDIDSetVendor(edid, "TST", i, 1000 + i, 1, 2024);
+    return edid;
+}
+
+int main() {
+    rezol_edid_cache_clear();
+    EDIDCacheStats stats = rezol_edid_cache_stats();
+    CHECK(stats.hits == 0 && stats.misses == 0 && stats.entries == 0);
+
+    // A miss then a hit, both matching the uncached parse
+    EDIDBlob tv = MakeEDID(3840, 2160, 560, 90, 59400, 1210, 680, "LG TV");
+    EDIDAppendCTA(tv, { 0x80 | 16, 97 }, true, 1920, 1080, 280, 45, 14850);
+    EDIDInfo direct, cached;
+    CHECK(rezol_edid_parse(tv.data(), tv.size(), direct));
+    for (int i = 0; i < 2; i++) {
+        memset(&cached, 0xCC, sizeof(cached));
+        CHECK(rezol_edid_parse_cached(tv.data(), tv.size(), cached));
+        CHECK(strcmp(cached.name, direct.name) == 0);
+        CHECK(cached.widthMM == direct.widthMM && cached.heightMM == direct.heightMM);
+        CHECK(cached.preferredTiming.refreshMilliHz == direct.preferredTiming.refreshMilliHz);
+        CHECK(cached.hasCTA && cached.cta.nativeVIC == direct.cta.nativeVIC);
+    }
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 1 && stats.hits == 1 && stats.entries == 1);
+
+    // One byte different is another monitor, not a hit
+    EDIDBlob other = tv;
+    other[15] ^= 1;
+    EDIDFinish(other);
+    CHECK(rezol_edid_parse_cached(other.data(), other.size(), cached));
+    CHECK(cached.serialNumber != direct.serialNumber);
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 2 && stats.hits == 1);
+
+    // A failed parse is cached as a failure
+    EDIDBlob junk(128, 0x55);
+    CHECK(!rezol_edid_parse_cached(junk.data(), junk.size(), cached));
+    CHECK(!rezol_edid_parse_cached(junk.data(), junk.size(), cached));
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 3 && stats.hits == 2);
+
+    // Blobs too big to cache are still parsed
+    EDIDBlob big = tv;
+    for (size_t i = 1; i < EDID_CACHE_MAX_BLOCKS; i++) {
+        EDIDAppendDisplayID(big, "Big", 5270, 2960, 1920, 1080, 280, 45, 14850, 1, 1, 0, 0);
+    }
+    CHECK(big.size() > EDID_CACHE_MAX_BLOCKS * EDID_BLOCK_SIZE);
+    CHECK(rezol_edid_parse_cached(big.data(), big.size(), cached));
+    CHECK(strcmp(cached.name, "LG TV") == 0 && cached.hasDisplayID);
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 4 && stats.entries == 3);
+
+    // More monitors than entries: the cache stays at its cap and the
+    // least recently used ones are dropped
+    rezol_edid_cache_clear();
+    const int wall = (int)EDID_CACHE_ENTRIES + 4;
+    for (int i = 0; i < wall; i++) {
+        EDIDBlob edid = Monitor(i);
+        CHECK(rezol_edid_parse_cached(edid.data(), edid.size(), cached));
+        CHECK(cached.productCode == i);
+        CHECK(cached.widthMM == 500 + i);
+    }
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.entries == (int32_t)EDID_CACHE_ENTRIES);
+    CHECK(stats.misses == (uint64_t)wall && stats.hits == 0);
+
+    // The newest EDID_CACHE_ENTRIES are still there
+    for (int i = wall - (int)EDID_CACHE_ENTRIES; i < wall; i++) {
+        EDIDBlob edid = Monitor(i);
+        CHECK(rezol_edid_parse_cached(edid.data(), edid.size(), cached));
+        char name[16];
+        snprintf(name, sizeof(name), "Panel %d", i);
+        CHECK(strcmp(cached.name, name) == 0);
+    }
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.hits == EDID_CACHE_ENTRIES && stats.misses == (uint64_t)wall);
+
+    // The oldest was evicted
+    EDIDBlob first = Monitor(0);
+    CHECK(rezol_edid_parse_cached(first.data(), first.size(), cached));
+    CHECK(rezol_edid_cache_stats().misses == (uint64_t)wall + 1);
+
+    return TestResult();
+}
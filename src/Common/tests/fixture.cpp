@@ -0,0 +1,123 @@
+// Writes synthetic topologies to fixture files, loads them back through
+// __internal_get_virtual_screens and checks every record survives, also
+// while another thread keeps swapping the fixture.
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_fixture_test.gmsf";
+static const char* OtherPath = "gms_fixture_test_other.gmsf";
+
+static void CheckRoundTrip(const vector<PhysicalScreen>& screens) {
+    CHECK(rezol_fixture_write(FixturePath, screens.data(), (int32_t)screens.size(), 1));
+    CHECK(rezol_fixture_load(FixturePath));
+    CHECK(rezol_fixture_active());
+
+    vector<PhysicalScreen> out(screens.size() + 1);
+    ScreenInfo info = {};
+    info.screen = out.data();
+    info.count = 0;
+    info.maxCount = (int32_t)out.size();
+    info.more = false;
+
+    CHECK(__internal_get_virtual_screens(&info) != 0);
+    CHECK(info.count == (int32_t)screens.size());
+    CHECK(info.autoHideTaskbar == 1);
+    CHECK(!info.more);
+    if (info.count == (int32_t)screens.size() && !screens.empty()) {
+        CHECK(memcmp(out.data(), screens.data(), screens.size() * sizeof(PhysicalScreen)) == 0);
+    }
+}
+
+int main() {
+    for (int count : { 1, 8, 64, 256 }) {
+        CheckRoundTrip(MakeVideoWall(count));
+    }
+    CheckRoundTrip(MakeMixedDPI());
+
+    // Capped output still reports that there is more
+    vector<PhysicalScreen> wall = MakeVideoWall(64);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_fixture_load(FixturePath));
+    PhysicalScreen screenArray[SCREENS_PER_PAGE];
+    ScreenInfo info = {};
+    info.screen = screenArray;
+    info.maxCount = SCREENS_PER_PAGE;
+    CHECK(__internal_get_virtual_screens(&info) != 0);
+    CHECK(info.count == SCREENS_PER_PAGE);
+    CHECK(info.more);
+
+    // Malformed files are rejected and the previous fixture stays loaded
+    FILE* bad = fopen(FixturePath, "wb");
+    fputs("not a fixture", bad);
+    fclose(bad);
+    CHECK(!rezol_fixture_load(FixturePath));
+    CHECK(rezol_fixture_active());
+    CHECK(!rezol_fixture_load("does-not-exist.gmsf"));
+
+    // Record whatever the live backend sees and replay it
+    rezol_fixture_unload();
+    CHECK(!rezol_fixture_active());
+    if (rezol_fixture_record(FixturePath)) {
+        vector<PhysicalScreen> live(SCREENS_PER_PAGE);
+        ScreenInfo liveInfo = {};
+        liveInfo.screen = live.data();
+        liveInfo.maxCount = SCREENS_PER_PAGE;
+        __internal_get_virtual_screens(&liveInfo);
+
+        CHECK(rezol_fixture_load(FixturePath));
+        vector<PhysicalScreen> replay(SCREENS_PER_PAGE);
+        ScreenInfo replayInfo = {};
+        replayInfo.screen = replay.data();
+        replayInfo.maxCount = SCREENS_PER_PAGE;
+        CHECK(__internal_get_virtual_screens(&replayInfo) != 0);
+        CHECK(replayInfo.count == liveInfo.count);
+        if (replayInfo.count == liveInfo.count) {
+            CHECK(memcmp(live.data(), replay.data(), liveInfo.count * sizeof(PhysicalScreen)) == 0);
+        }
+    }
+
+    // Enumerating while the fixture is swapped and unmapped underneath
+    vector<PhysicalScreen> small = MakeVideoWall(8);
+    CHECK(rezol_fixture_write(FixturePath, small.data(), (int32_t)small.size(), 0));
+    CHECK(rezol_fixture_write(OtherPath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_fixture_load(FixturePath));
+    atomic<bool> stop(false);
+    atomic<int> torn(0);
+    thread reader([&] {
+        vector<PhysicalScreen> out(wall.size());
+        while (!stop) {
+            ScreenInfo swapped = {};
+            swapped.screen = out.data();
+            swapped.maxCount = (int32_t)out.size();
+            if (__internal_get_virtual_screens(&swapped) == 0) {
+                torn++;
+                continue;
+            }
+            const vector<PhysicalScreen>& expected = (swapped.count == (int32_t)small.size()) ? small : wall;
+            if (swapped.count != (int32_t)expected.size() ||
+                memcmp(out.data(), expected.data(), expected.size() * sizeof(PhysicalScreen)) != 0) {
+                torn++;
+            }
+        }
+    });
+    for (int i = 0; i < 500; i++) {
+        CHECK(rezol_fixture_load((i % 2) ? FixturePath : OtherPath));
+    }
+    stop = true;
+    reader.join();
+    CHECK(torn == 0);
+
+    rezol_fixture_unload();
+    remove(FixturePath);
+    remove(OtherPath);
+    return TestResult();
+}
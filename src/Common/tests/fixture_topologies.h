@@ -0,0 +1,127 @@
+#ifndef FIXTURE_TOPOLOGIES_H
+#define FIXTURE_TOPOLOGIES_H
+
+// Synthetic topologies for tests and benchmarks, the kind we cannot plug
+// together on a dev box. Every generator is deterministic.
+#include <cstdio>
+#include <cmath>
+#include <initializer_list>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+
+// The LCG random points and layouts are drawn from, so a failing case
+// comes back every run
+struct FixtureRandom {
+    uint32_t seed;
+    explicit FixtureRandom(uint32_t start) : seed(start) {}
+    // 0 to range - 1, from the high bits since the low ones cycle quickly
+    int32_t Below(uint32_t range) {
+        seed = seed * 1664525 + 1013904223;
+        return (int32_t)((seed >> 8) % range);
+    }
+};
+
+// DPI fields the way a backend fills them once pixelBox and physSize are set
+static inline void SetFixtureDPI(PhysicalScreen& s, double scale) {
+    int32_t effective = (int32_t)std::lround(96 * scale);
+    s.dpi.effectiveX = effective;
+    s.dpi.effectiveY = effective;
+    s.dpi.rawX = s.physSize.width ? (int32_t)std::lround(s.pixelBox.width * 25.4 / s.physSize.width) : 0;
+    s.dpi.rawY = s.physSize.height ? (int32_t)std::lround(s.pixelBox.height * 25.4 / s.physSize.height) : 0;
+    s.scale = scale;
+}
+
+// A grid of identical 1920x1080 panels, like a signage video wall. Every
+// fourth panel has no EDID, so no name or physical size.
+static inline std::vector<PhysicalScreen> MakeVideoWall(int count) {
+    std::vector<PhysicalScreen> screens(count);
+    int columns = (int)std::ceil(std::sqrt((double)count));
+    for (int i = 0; i < count; i++) {
+        PhysicalScreen& s = screens[i];
+        s = PhysicalScreen();
+        int32_t left = (i % columns) * 1920;
+        int32_t top = (i / columns) * 1080;
+        s.isPrimary = (i == 0);
+        s.refreshRate = 60;
+        s.pixelBox = { 1920, 1080 };
+        s.virtualRect = { left, top, left + 1920, top + 1080 };
+        s.workingRect = s.virtualRect;
+        if (i % 4 == 3) {
+            s.errorCode = 4 | 8;
+            std::snprintf(s.name, MONITOR_NAME_BUFFER_SIZE, "Unknown Monitor");
+        } else {
+            s.physSize = { 1210, 680, 1388 };
+            std::snprintf(s.name, MONITOR_NAME_BUFFER_SIZE, "Wall Panel %d", i);
+        }
+        SetFixtureDPI(s, 1);
+    }
+    return screens;
+}
+
+// A 4K laptop panel at 200% next to two 1080p monitors at 100%
+static inline std::vector<PhysicalScreen> MakeMixedDPI() {
+    std::vector<PhysicalScreen> screens(3);
+    for (PhysicalScreen& s : screens) {
+        s = PhysicalScreen();
+        s.refreshRate = 60;
+    }
+    screens[0].isPrimary = 1;
+    screens[0].pixelBox = { 3840, 2160 };
+    screens[0].virtualRect = { 0, 0, 1920, 1080 };
+    screens[0].workingRect = { 0, 0, 1920, 1040 };
+    screens[0].physSize = { 344, 194, 395 };
+    std::snprintf(screens[0].name, MONITOR_NAME_BUFFER_SIZE, "Internal Display");
+    for (int i = 1; i < 3; i++) {
+        screens[i].pixelBox = { 1920, 1080 };
+        screens[i].virtualRect = { 1920 * i, 0, 1920 * (i + 1), 1080 };
+        screens[i].workingRect = screens[i].virtualRect;
+        screens[i].physSize = { 527, 296, 604 };
+        std::snprintf(screens[i].name, MONITOR_NAME_BUFFER_SIZE, "DELL U2419H");
+    }
+    screens[2].refreshRate = 144;
+    SetFixtureDPI(screens[0], 2);
+    SetFixtureDPI(screens[1], 1);
+    SetFixtureDPI(screens[2], 1);
+    return screens;
+}
+
+// A monitor mirroring across the primary and the second one, higher than both
+static inline std::vector<PhysicalScreen> MakeMirrored() {
+    std::vector<PhysicalScreen> screens = MakeMixedDPI();
+    screens[2].virtualRect = { 960, -200, 2880, 900 };
+    return screens;
+}
+
+// What every kernel is checked on: video walls of the given sizes, the
+// mixed DPI and mirrored desktops, and no monitors at all
+static inline std::vector<std::vector<PhysicalScreen>> MakeKernelLayouts(std::initializer_list<int> wallSizes) {
+    std::vector<std::vector<PhysicalScreen>> layouts;
+    for (int count : wallSizes) {
+        layouts.push_back(MakeVideoWall(count));
+    }
+    layouts.push_back(MakeMixedDPI());
+    layouts.push_back(MakeMirrored());
+    layouts.push_back(std::vector<PhysicalScreen>());
+    return layouts;
+}
+
+// Serves screens as the topology snapshot the exports read, until the end
+// of the scope. Each test passes its own path so ctest -j runs don't clash.
+struct ScopedFixture {
+    const char* path;
+    bool loaded;
+    ScopedFixture(const char* fixturePath, const std::vector<PhysicalScreen>& screens, int32_t autoHideTaskbar = 0)
+        : path(fixturePath) {
+        loaded = rezol_fixture_write(path, screens.data(), (int32_t)screens.size(), autoHideTaskbar) &&
+                 rezol_ext_load_fixture((char*)path) == 0;
+    }
+    ~ScopedFixture() {
+        rezol_ext_load_fixture((char*)"");
+        std::remove(path);
+    }
+    ScopedFixture(const ScopedFixture&) = delete;
+    ScopedFixture& operator=(const ScopedFixture&) = delete;
+};
+
+#endif // FIXTURE_TOPOLOGIES_H
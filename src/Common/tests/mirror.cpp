@@ -0,0 +1,184 @@
+// Hammers a mirrored buffer from a writer thread while the main thread
+// reads it the way GML would, and checks no torn copy is ever accepted.
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_mirror.h"
+#include "screen_topology.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_mirror_test.gmsf";
+
+// Offset of the first PhysicalScreen in a SCREENINFO payload
+static const size_t ScreensOffset = rezol_ext_get_buffer_size(SCREENINFOHEADER);
+static const size_t RecordSize = rezol_ext_get_buffer_size(PHYSICALSCREEN);
+
+static uint32_t PeekSequence(const char* buf) {
+    return reinterpret_cast<const atomic<uint32_t>*>(buf)->load(memory_order_acquire);
+}
+
+// Seqlock read: copy, then accept only if the sequence was even and did
+// not move while copying
+static bool ReadMirror(const char* buf, vector<char>& copy) {
+    uint32_t before = PeekSequence(buf);
+    if (before & 1) {
+        return false;
+    }
+    memcpy(copy.data(), buf, copy.size());
+    atomic_thread_fence(memory_order_acquire);
+    return reinterpret_cast<const atomic<uint32_t>*>(buf)->load(memory_order_relaxed) == before;
+}
+
+// Snapshot k has 1 + k % SCREENS_PER_PAGE monitors, and every field of every
+// record is derived from k, so mixing two writes is always visible
+static TopologySnapshot MakeSnapshot(uint64_t base, uint32_t k) {
+    TopologySnapshot snapshot;
+    snapshot.generation = base + k;
+    snapshot.result = 1;
+    snapshot.autoHideTaskbar = (int32_t)k;
+    snapshot.screens.resize(1 + k % SCREENS_PER_PAGE);
+    for (size_t i = 0; i < snapshot.screens.size(); i++) {
+        PhysicalScreen& s = snapshot.screens[i];
+        int32_t v = (int32_t)(k * 16 + i);
+        s.errorCode = v;
+        s.refreshRate = v;
+        s.isPrimary = v;
+        s.pixelBox = { v, v };
+        s.virtualRect = { v, v, v, v };
+        s.workingRect = { v, v, v, v };
+        s.physSize = { v, v, v };
+        memset(s.name, 'A' + (k % 26), sizeof(s.name) - 1);
+        s.name[sizeof(s.name) - 1] = '\0';
+    }
+    return snapshot;
+}
+
+static bool Consistent(const vector<char>& copy, uint64_t base) {
+    MirrorHeader header;
+    memcpy(&header, copy.data(), sizeof(header));
+    const char* payload = copy.data() + sizeof(MirrorHeader);
+    int32_t count, autoHide;
+    memcpy(&count, payload, sizeof(count));
+    memcpy(&autoHide, payload + 4 * sizeof(int32_t), sizeof(autoHide));
+
+    uint32_t k = (uint32_t)autoHide;
+    TopologySnapshot expected = MakeSnapshot(base, k);
+    if ((uint64_t)header.generation != expected.generation || count != (int32_t)expected.screens.size()) {
+        return false;
+    }
+    for (int32_t i = 0; i < count; i++) {
+        if (memcmp(payload + ScreensOffset + i * RecordSize, &expected.screens[i], RecordSize) != 0) {
+            return false;
+        }
+    }
+    uint32_t fourcc;
+    memcpy(&fourcc, payload + ScreensOffset + count * RecordSize, sizeof(fourcc));
+    return fourcc == GMEX && header.size == ScreensOffset + count * RecordSize + sizeof(fourcc);
+}
+
+int main() {
+    CHECK(rezol_fixture_write(FixturePath, MakeVideoWall(2).data(), 2, 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+
+    size_t size = (size_t)rezol_ext_get_buffer_size(SCREENMIRROR);
+    CHECK(size == sizeof(MirrorHeader) + ScreensOffset + 2 * RecordSize + sizeof(uint32_t));
+
+    // Room for up to SCREENS_PER_PAGE monitors
+    size_t roomy = sizeof(MirrorHeader) + ScreensOffset + SCREENS_PER_PAGE * RecordSize + sizeof(uint32_t);
+    vector<char> gmlBuf(roomy, 0);
+    vector<char> copy(roomy, 0);
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)gmlBuf.data());
+
+    // Too small to hold even the headers
+    CHECK(rezol_ext_mirror_register(address, (double)(sizeof(MirrorHeader) + ScreensOffset)) == 1);
+    CHECK(!rezol_mirror_active());
+
+    // Registering writes the current topology straight away
+    CHECK(rezol_ext_mirror_register(address, (double)roomy) == 0);
+    CHECK(ReadMirror(gmlBuf.data(), copy));
+    int32_t count;
+    memcpy(&count, copy.data() + sizeof(MirrorHeader), sizeof(count));
+    CHECK(count == 2);
+    MirrorHeader header;
+    memcpy(&header, copy.data(), sizeof(header));
+    CHECK(header.sequence == 2);
+    CHECK(header.size == size - sizeof(MirrorHeader));
+    CHECK(header.generation == rezol_ext_get_topology_generation());
+
+    // A topology change is written in without any further call
+    CHECK(rezol_fixture_write(FixturePath, MakeVideoWall(5).data(), 5, 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    CHECK(ReadMirror(gmlBuf.data(), copy));
+    memcpy(&count, copy.data() + sizeof(MirrorHeader), sizeof(count));
+    CHECK(count == 5);
+
+    // A write between the two peeks is caught
+    uint64_t base = (uint64_t)rezol_ext_get_topology_generation() + 1;
+    uint32_t before = PeekSequence(gmlBuf.data());
+    rezol_mirror_publish(MakeSnapshot(base, 0));
+    CHECK(PeekSequence(gmlBuf.data()) != before);
+    CHECK(PeekSequence(gmlBuf.data()) % 2 == 0);
+
+    // So is a read that starts mid write
+    uint32_t stable = PeekSequence(gmlBuf.data());
+    reinterpret_cast<atomic<uint32_t>*>(gmlBuf.data())->store(stable + 1);
+    CHECK(!ReadMirror(gmlBuf.data(), copy));
+    reinterpret_cast<atomic<uint32_t>*>(gmlBuf.data())->store(stable);
+
+    // Older snapshots never overwrite newer ones
+    rezol_mirror_publish(MakeSnapshot(base, 3));
+    rezol_mirror_publish(MakeSnapshot(base, 1));
+    CHECK(ReadMirror(gmlBuf.data(), copy));
+    CHECK(Consistent(copy, base));
+    memcpy(&count, copy.data() + sizeof(MirrorHeader), sizeof(count));
+    CHECK(count == 4);
+
+    // Stress: one writer, one reader, every accepted copy must be whole
+    const uint32_t writes = 20000;
+    atomic<bool> done(false);
+    thread writer([&] {
+        for (uint32_t k = 4; k < 4 + writes; k++) {
+            rezol_mirror_publish(MakeSnapshot(base, k));
+        }
+        done = true;
+    });
+    uint64_t accepted = 0, rejected = 0, torn = 0;
+    while (!done) {
+        if (ReadMirror(gmlBuf.data(), copy)) {
+            accepted++;
+            if (!Consistent(copy, base)) {
+                torn++;
+            }
+        } else {
+            rejected++;
+        }
+    }
+    writer.join();
+    printf("mirror stress: %llu accepted, %llu retried, %llu torn\n",
+           (unsigned long long)accepted, (unsigned long long)rejected, (unsigned long long)torn);
+    CHECK(torn == 0);
+    CHECK(accepted > 0);
+    CHECK(ReadMirror(gmlBuf.data(), copy));
+    CHECK(Consistent(copy, base));
+    memcpy(&header, copy.data(), sizeof(header));
+    CHECK((uint64_t)header.generation == base + 3 + writes);
+
+    // Nothing is written once unregistered
+    rezol_ext_mirror_unregister();
+    CHECK(!rezol_mirror_active());
+    uint32_t last = PeekSequence(gmlBuf.data());
+    rezol_mirror_publish(MakeSnapshot(base, 5 + writes));
+    CHECK(PeekSequence(gmlBuf.data()) == last);
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    return TestResult();
+}
@@ -0,0 +1,120 @@
+// Checks the spatial index answers point lookups exactly like a scan of
+// every monitor rect would, including on edges, in gaps between monitors,
+// where mirrored monitors overlap and off the desktop altogether.
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_index.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+// What MonitorFromPoint with MONITOR_DEFAULTTONEAREST would say
+static int32_t Reference(const vector<PhysicalScreen>& screens, int32_t x, int32_t y) {
+    int32_t nearest = -1;
+    int64_t best = INT64_MAX;
+    for (size_t i = 0; i < screens.size(); i++) {
+        const GMSRect& r = screens[i].virtualRect;
+        if (r.right <= r.left || r.bottom <= r.top) {
+            continue;
+        }
+        int64_t dx = (x < r.left) ? (int64_t)r.left - x : (x >= r.right) ? (int64_t)x - r.right + 1 : 0;
+        int64_t dy = (y < r.top) ? (int64_t)r.top - y : (y >= r.bottom) ? (int64_t)y - r.bottom + 1 : 0;
+        if (dx * dx + dy * dy < best) {
+            best = dx * dx + dy * dy;
+            nearest = (int32_t)i;
+        }
+    }
+    return nearest;
+}
+
+// Every edge of every monitor, one pixel either side, and beyond the desktop.
+// Big walls only check every step-th coordinate to keep the scan quick.
+static void CheckAll(const vector<PhysicalScreen>& screens, size_t step = 1) {
+    ScreenIndex index;
+    rezol_index_build(index, screens);
+    vector<int32_t> xs = { -100000, 100000 };
+    vector<int32_t> ys = { -100000, 100000 };
+    for (const PhysicalScreen& s : screens) {
+        for (int32_t d : { -1, 0, 1 }) {
+            xs.push_back(s.virtualRect.left + d);
+            xs.push_back(s.virtualRect.right + d);
+            xs.push_back((s.virtualRect.left + s.virtualRect.right) / 2 + d);
+            ys.push_back(s.virtualRect.top + d);
+            ys.push_back(s.virtualRect.bottom + d);
+            ys.push_back((s.virtualRect.top + s.virtualRect.bottom) / 2 + d);
+        }
+    }
+    int mismatches = 0;
+    for (size_t i = 0; i < xs.size(); i += step) {
+        for (size_t j = 0; j < ys.size(); j += step) {
+            int32_t x = xs[i], y = ys[j];
+            int32_t got = rezol_index_find_nearest(index, x, y);
+            int32_t want = Reference(screens, x, y);
+            if (got != want && mismatches++ < 5) {
+                printf("point %d,%d: index says %d, scan says %d\n", x, y, got, want);
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main() {
+    for (const vector<PhysicalScreen>& screens : MakeKernelLayouts({ 1, 2, 3, 8, 64 })) {
+        CheckAll(screens);
+    }
+    CheckAll(MakeVideoWall(256), 7);
+
+    // Ragged layout with gaps and monitors left of and above the primary
+    vector<PhysicalScreen> ragged = MakeMixedDPI();
+    ragged[1].virtualRect = { -1080, -600, 0, 1320 };
+    ragged[2].virtualRect = { 2000, 300, 3920, 1380 };
+    CheckAll(ragged);
+
+    // Random layouts with gaps and overlaps, random points near them
+    FixtureRandom next(2024);
+    int mismatches = 0;
+    for (int layout = 0; layout < 200; layout++) {
+        vector<PhysicalScreen> random(1 + next.Below(12));
+        for (PhysicalScreen& s : random) {
+            int32_t left = next.Below(4000) - 1000, top = next.Below(3000) - 1000;
+            s.virtualRect = { left, top, left + 1 + next.Below(1200), top + 1 + next.Below(900) };
+        }
+        ScreenIndex index;
+        rezol_index_build(index, random);
+        for (int p = 0; p < 200; p++) {
+            int32_t x = next.Below(7000) - 2500, y = next.Below(6000) - 2500;
+            if (rezol_index_find_nearest(index, x, y) != Reference(random, x, y)) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+
+    // A mirrored monitor overlapping the primary: the lower index owns it
+    vector<PhysicalScreen> mirrored = MakeMirrored();
+    ScreenIndex index;
+    rezol_index_build(index, mirrored);
+    CHECK(rezol_index_find(index, 1000, 500) == 0);
+    CHECK(rezol_index_find(index, 2000, 500) == 1);
+    CHECK(rezol_index_find(index, 4000, 500) == -1);
+
+    // Nothing to find
+    rezol_index_build(index, vector<PhysicalScreen>());
+    CHECK(rezol_index_find(index, 0, 0) == -1);
+    CHECK(rezol_index_find_nearest(index, 0, 0) == -1);
+
+    // Through the export, on the topology snapshot
+    ScopedFixture fixture("gms_point_test.gmsf", MakeMixedDPI());
+    CHECK(fixture.loaded);
+    CHECK(rezol_ext_monitor_from_point(10, 10) == 0);
+    CHECK(rezol_ext_monitor_from_point(1919.5, 10) == 0);
+    CHECK(rezol_ext_monitor_from_point(1920, 10) == 1);
+    CHECK(rezol_ext_monitor_from_point(5000, 500) == 2);
+    CHECK(rezol_ext_monitor_from_point(-50, -50) == 0);
+    CHECK(rezol_ext_monitor_from_point(1e12, 0) == 2);
+
+    return TestResult();
+}
@@ -0,0 +1,150 @@
+// Checks every rect placement kernel this CPU can run picks the monitor a
+// plain N x M loop over the rects would, with the same overlap area and the
+// same rect fitted into its work area, and that the export uses GML buffers.
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_classify.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+// The loop GML runs today, in 64 bit
+static WireRectPlacement Reference(const vector<PhysicalScreen>& screens, const GMSRect& r) {
+    WireRectPlacement placement = { -1, 0, 0, r };
+    int64_t best = 0;
+    for (size_t i = 0; i < screens.size(); i++) {
+        const GMSRect& m = screens[i].virtualRect;
+        int64_t w = min<int64_t>(r.right, m.right) - max<int64_t>(r.left, m.left);
+        int64_t h = min<int64_t>(r.bottom, m.bottom) - max<int64_t>(r.top, m.top);
+        if (w > 0 && h > 0 && w * h > best) {
+            best = w * h;
+            placement.screen = (int32_t)i;
+        }
+    }
+    if (best == 0) {
+        int64_t nearest = INT64_MAX;
+        for (size_t i = 0; i < screens.size(); i++) {
+            const GMSRect& m = screens[i].virtualRect;
+            if (m.right <= m.left || m.bottom <= m.top) {
+                continue;
+            }
+            int64_t dx = max<int64_t>({ 0, (int64_t)m.left - r.right, (int64_t)r.left - m.right });
+            int64_t dy = max<int64_t>({ 0, (int64_t)m.top - r.bottom, (int64_t)r.top - m.bottom });
+            if (dx * dx + dy * dy < nearest) {
+                nearest = dx * dx + dy * dy;
+                placement.screen = (int32_t)i;
+            }
+        }
+        placement.nearest = (placement.screen >= 0) ? 1 : 0;
+    }
+    placement.area = (double)best;
+    if (placement.screen >= 0) {
+        const GMSRect& work = screens[placement.screen].workingRect;
+        int64_t width = max<int64_t>(0, min<int64_t>((int64_t)r.right - r.left, (int64_t)work.right - work.left));
+        int64_t height = max<int64_t>(0, min<int64_t>((int64_t)r.bottom - r.top, (int64_t)work.bottom - work.top));
+        int64_t left = max<int64_t>(work.left, min<int64_t>(r.left, work.right - width));
+        int64_t top = max<int64_t>(work.top, min<int64_t>(r.top, work.bottom - height));
+        placement.rect = { (int32_t)left, (int32_t)top, (int32_t)(left + width), (int32_t)(top + height) };
+    }
+    return placement;
+}
+
+// Windows of a few sizes dropped all over the desktop, plus odd ones
+static vector<GMSRect> MakeRects(const vector<PhysicalScreen>& screens) {
+    vector<GMSRect> rects = {
+        { INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX },
+        { 0, 0, 0, 0 },
+        { 500, 500, 100, 100 },
+        { -100000, -100000, -99000, -99000 },
+        { 100000, 50, 100800, 650 }
+    };
+    FixtureRandom next(7);
+    for (const PhysicalScreen& s : screens) {
+        for (int i = 0; i < 12; i++) {
+            int32_t x = s.virtualRect.left - 900 + next.Below(2400);
+            int32_t y = s.virtualRect.top - 500 + next.Below(1400);
+            int32_t w = 200 + next.Below(2500);
+            int32_t h = 150 + next.Below(1300);
+            rects.push_back({ x, y, x + w, y + h });
+        }
+        // Exactly on the monitor, and straddling its right edge half and half
+        rects.push_back(s.virtualRect);
+        int32_t mid = s.virtualRect.right;
+        rects.push_back({ mid - 400, s.virtualRect.top + 10, mid + 400, s.virtualRect.top + 300 });
+    }
+    return rects;
+}
+
+static void CheckKernel(int32_t kernel, const vector<PhysicalScreen>& screens) {
+    ScreenIndex index;
+    rezol_index_build(index, screens);
+    vector<GMSRect> rects = MakeRects(screens);
+    vector<WireRectPlacement> out(rects.size() + 1);
+    memset(out.data(), 0x5A, out.size() * sizeof(WireRectPlacement));
+    rezol_place_rects(kernel, index, screens, rects.data(), out.data(), rects.size());
+
+    int mismatches = 0;
+    for (size_t n = 0; n < rects.size(); n++) {
+        WireRectPlacement want = Reference(screens, rects[n]);
+        const WireRectPlacement& got = out[n];
+        bool same = got.screen == want.screen && got.nearest == want.nearest && got.area == want.area &&
+                    memcmp(&got.rect, &want.rect, sizeof(GMSRect)) == 0;
+        if (!same && mismatches++ < 5) {
+            printf("kernel %d, rect %d,%d,%d,%d: got %d (%.0f) %d,%d,%d,%d, want %d (%.0f) %d,%d,%d,%d\n", kernel,
+                   rects[n].left, rects[n].top, rects[n].right, rects[n].bottom,
+                   got.screen, got.area, got.rect.left, got.rect.top, got.rect.right, got.rect.bottom,
+                   want.screen, want.area, want.rect.left, want.rect.top, want.rect.right, want.rect.bottom);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(out.back().screen == 0x5A5A5A5A);
+}
+
+int main() {
+    // Work areas smaller than the monitors, as with a taskbar on each
+    vector<vector<PhysicalScreen>> layouts = MakeKernelLayouts({ 1, 2, 3, 4, 5, 8, 9, 17, 64, 256 });
+    vector<PhysicalScreen> taskbars = MakeVideoWall(9);
+    for (PhysicalScreen& s : taskbars) {
+        s.workingRect.bottom -= 40;
+    }
+    layouts.push_back(taskbars);
+    // Spread too far for the int32 kernels, which fall back to scalar
+    vector<PhysicalScreen> far = MakeMixedDPI();
+    far[2].virtualRect = { 1500000000, 0, 1500001920, 1080 };
+    far[2].workingRect = far[2].virtualRect;
+    layouts.push_back(far);
+
+    for (int32_t kernel : { (int32_t)SIMD_SCALAR, (int32_t)SIMD_SSE2, (int32_t)SIMD_AVX2 }) {
+        if (!rezol_simd_supported(kernel)) {
+            printf("kernel %d not supported here, skipped\n", kernel);
+            continue;
+        }
+        for (const vector<PhysicalScreen>& screens : layouts) {
+            CheckKernel(kernel, screens);
+        }
+    }
+
+    // Through the export: a window mostly on the second monitor is moved
+    // fully onto it, one larger than the work area is shrunk to it
+    ScopedFixture fixture("gms_place_test.gmsf", MakeMixedDPI());
+    CHECK(fixture.loaded);
+    vector<GMSRect> rects = { { 1800, 100, 2600, 700 }, { -10, -10, 3000, 3000 }, { 9000, 0, 9100, 100 } };
+    vector<char> out(rects.size() * (size_t)rezol_ext_get_buffer_size(RECTPLACEMENT));
+    BufferAddress in(rects.data()), to(out.data());
+    CHECK(rezol_ext_monitors_from_rects(in, to, (double)rects.size()) == 0);
+    WireRectPlacement placed[3];
+    memcpy(placed, out.data(), sizeof(placed));
+    CHECK(placed[0].screen == 1 && placed[0].nearest == 0 && placed[0].area == 680.0 * 600);
+    CHECK(placed[0].rect.left == 1920 && placed[0].rect.right == 2720 && placed[0].rect.top == 100);
+    CHECK(placed[1].screen == 0 && placed[1].rect.left == 0 && placed[1].rect.bottom == 1040);
+    CHECK(placed[2].screen == 2 && placed[2].nearest == 1 && placed[2].area == 0);
+    CHECK(placed[2].rect.left == 5660 && placed[2].rect.right == 5760);
+    CHECK(rezol_ext_monitors_from_rects(in, to, -1) == 1);
+
+    return TestResult();
+}
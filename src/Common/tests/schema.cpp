@@ -0,0 +1,158 @@
+// Checks the buffer sizes the library reports come from the schema, that
+// decoding real library output at the schema offsets gives back the
+// monitors, and that the generated GML script peeks at those offsets.
+//   TestSchema path/to/rezol_decode.gml
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_schema.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_schema_test.gmsf";
+
+template<size_t N>
+static int64_t Peek(const char* base, const SchemaField (&fields)[N], const char* name) {
+    size_t i = rezol_schema_index(fields, name);
+    const char* p = base + rezol_schema_offset(fields, i);
+    switch (fields[i].type) {
+        case SCHEMA_U8:  { uint8_t v;  memcpy(&v, p, 1); return v; }
+        case SCHEMA_U16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case SCHEMA_S32: { int32_t v;  memcpy(&v, p, 4); return v; }
+        case SCHEMA_U32: { uint32_t v; memcpy(&v, p, 4); return v; }
+        default: return 0;
+    }
+}
+
+// The body of one generated function
+static string Function(const string& script, const string& name) {
+    size_t start = script.find("function " + name + "(");
+    if (start == string::npos) {
+        return string();
+    }
+    size_t end = script.find("\n}\n", start);
+    return script.substr(start, end == string::npos ? string::npos : end - start);
+}
+
+template<size_t N>
+static void CheckMembers(const string& body, const SchemaField (&fields)[N], size_t count = N) {
+    for (size_t i = 0; i < count; i++) {
+        ostringstream line;
+        line << fields[i].name << ": buffer_peek(_buf, _at + " << rezol_schema_offset(fields, i) << ", ";
+        if (body.find(line.str()) == string::npos) {
+            printf("generated script has no \"%s\"\n", line.str().c_str());
+            CHECK(!"generated offset missing");
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    // Sizes
+    CHECK(rezol_ext_get_buffer_size(PHYSICALSCREEN) == SCHEMA_RECORD_V1_SIZE);
+    CHECK(SCHEMA_RECORD_V1_SIZE == 128 && SCHEMA_RECORD_SIZE == sizeof(PhysicalScreen));
+    CHECK(rezol_ext_get_buffer_size(WINDOWCHROME) == rezol_schema_size(WindowChromeSchema));
+    CHECK(rezol_ext_get_buffer_size(RECTPLACEMENT) == rezol_schema_size(RectPlacementSchema));
+    CHECK(rezol_ext_get_buffer_size(SCREENINFOHEADER) == SCHEMA_HEADER_V1_SIZE);
+    CHECK(SCHEMA_CHANGES_HEADER_SIZE == sizeof(WireChangesHeader));
+    CHECK(rezol_ext_get_buffer_size(STATS) == SCHEMA_STATS_SIZE);
+
+    vector<PhysicalScreen> wall = MakeVideoWall(5);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    CHECK(rezol_ext_get_buffer_size(SCREENINFO) == rezol_schema_screen_info_size(WIRE_FORMAT_V1, SCREENS_PER_PAGE));
+    CHECK(SCHEMA_SCREEN_INFO_LEGACY_SIZE == rezol_schema_screen_info_size(WIRE_FORMAT_V1, SCREENS_PER_PAGE));
+    CHECK(rezol_ext_get_buffer_size(SCREENMIRROR) ==
+          rezol_schema_size(MirrorHeaderSchema) + rezol_schema_screen_info_size(WIRE_FORMAT_V1, 5));
+
+    // Decode what the library wrote using only the schema
+    for (int32_t format : { (int32_t)WIRE_FORMAT_V1, (int32_t)WIRE_FORMAT_V2 }) {
+        CHECK(rezol_ext_set_wire_format(format) == 0);
+        vector<char> buf((size_t)rezol_ext_get_buffer_size(SCREENINFO));
+        CHECK(buf.size() == rezol_schema_screen_info_size(format, SCREENS_PER_PAGE));
+        CHECK(rezol_ext_get_buffer_size(PHYSICALSCREEN) == rezol_schema_record_size(format));
+        char address[32];
+        snprintf(address, sizeof(address), "%p", (void*)buf.data());
+        CHECK(rezol_ext_get_screen_info(address) == 0);
+
+        bool v2 = (format == WIRE_FORMAT_V2);
+        int64_t count = v2 ? Peek(buf.data(), ScreenInfoV2Schema, "count") : Peek(buf.data(), ScreenInfoV1Schema, "count");
+        CHECK(count == 5);
+        for (int64_t i = 0; i < count && i < 5; i++) {
+            size_t at = SCHEMA_HEADER_V1_SIZE + i * SCHEMA_RECORD_V1_SIZE;
+            if (v2) {
+                uint32_t offset;
+                memcpy(&offset, buf.data() + SCHEMA_HEADER_V2_SIZE + i * SCHEMA_OFFSET_SIZE, sizeof(offset));
+                at = offset;
+            }
+            const char* record = buf.data() + at;
+            CHECK(Peek(record, PhysicalScreenSchema, "isPrimary") == wall[i].isPrimary);
+            CHECK(Peek(record, PhysicalScreenSchema, "pixelWidth") == wall[i].pixelBox.width);
+            CHECK(Peek(record, PhysicalScreenSchema, "virtualLeft") == wall[i].virtualRect.left);
+            CHECK(Peek(record, PhysicalScreenSchema, "workingBottom") == wall[i].workingRect.bottom);
+            CHECK(Peek(record, PhysicalScreenSchema, "physDiagonal") == wall[i].physSize.diagonal);
+            CHECK(strcmp(record + rezol_schema_offset(PhysicalScreenSchema, "name"), wall[i].name) == 0);
+            if (v2) {
+                CHECK(Peek(record, PhysicalScreenSchema, "effectiveDpiY") == wall[i].dpi.effectiveY);
+                CHECK(Peek(record, PhysicalScreenSchema, "rawDpiX") == wall[i].dpi.rawX);
+            }
+        }
+        // Format 1 records end where the DPI fields would start
+        if (!v2) {
+            uint32_t fourcc;
+            memcpy(&fourcc, buf.data() + SCHEMA_HEADER_V1_SIZE + 5 * SCHEMA_RECORD_V1_SIZE, sizeof(fourcc));
+            CHECK(fourcc == GMEX);
+        }
+    }
+    rezol_ext_set_wire_format(WIRE_FORMAT_V1);
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+
+    // The generated GML script
+    if (argc < 2) {
+        printf("no GML script given\n");
+        CHECK(false);
+        return TestResult();
+    }
+    ifstream in(argv[1]);
+    stringstream text;
+    text << in.rdbuf();
+    string script = text.str();
+    CHECK(!script.empty());
+    string v1Record = Function(script, "rezol_decode_physical_screen");
+    CheckMembers(v1Record, PhysicalScreenSchema, SCHEMA_RECORD_V1_FIELDS);
+    CHECK(v1Record.find("effectiveDpiX") == string::npos);
+    CheckMembers(Function(script, "rezol_decode_physical_screen_v2"), PhysicalScreenSchema);
+    CheckMembers(Function(script, "rezol_decode_window_chrome"), WindowChromeSchema);
+    CheckMembers(Function(script, "rezol_decode_mirror_header"), MirrorHeaderSchema);
+    CheckMembers(Function(script, "rezol_decode_rect_placement"), RectPlacementSchema);
+    CheckMembers(Function(script, "rezol_decode_stage_stats"), StageStatsSchema);
+    CheckMembers(Function(script, "rezol_decode_stats"), StatsHeaderSchema);
+    CheckMembers(Function(script, "rezol_decode_screen_info_v1"), ScreenInfoV1Schema);
+    CheckMembers(Function(script, "rezol_decode_screen_info_v2"), ScreenInfoV2Schema);
+    string changes = Function(script, "rezol_decode_screen_changes");
+    CheckMembers(changes, ScreenChangesSchema);
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        ostringstream test;
+        test << "if (_mask & " << (1u << g) << ") { // " << ScreenChangeGroups[g].name << "\n";
+        ostringstream step;
+        step << "_pos += " << rezol_schema_group_size(g) << ";";
+        size_t at = changes.find(test.str());
+        CHECK(at != string::npos && changes.find(step.str(), at) != string::npos);
+    }
+    CHECK(script.find("#macro REZOL_PHYSICALSCREEN_SIZE 128\n") != string::npos);
+    CHECK(script.find("#macro REZOL_PHYSICALSCREEN_V2_SIZE 152\n") != string::npos);
+    CHECK(Function(script, "rezol_decode_screen_info_v2").find("rezol_decode_physical_screen_v2(") != string::npos);
+    CHECK(Function(script, "rezol_decode_screen_info").find("REZOL_WIRE_MAGIC_V2") != string::npos);
+    // Straight-line peeks only
+    CHECK(script.find("buffer_read") == string::npos);
+    CHECK(script.find("buffer_seek") == string::npos);
+
+    return TestResult();
+}
@@ -0,0 +1,162 @@
+// Checks rezol_ext_get_screen_changes reports only what moved between two
+// topologies, one record per monitor and only the field groups that differ.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_schema.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_changes_test.gmsf";
+
+static double LoadTopology(const vector<PhysicalScreen>& screens, int32_t autoHide = 0) {
+    CHECK(rezol_fixture_write(FixturePath, screens.data(), (int32_t)screens.size(), autoHide));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    return rezol_ext_get_topology_generation();
+}
+
+// Size the buffer the way GML does, then ask for the changes
+static vector<char> Changes(double since) {
+    vector<char> buf((size_t)rezol_ext_get_buffer_size(SCREENCHANGES));
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    CHECK(rezol_ext_get_screen_changes_sized(address, (double)buf.size(), since) == 0);
+    return buf;
+}
+
+static WireChangesHeader Header(const vector<char>& buf) {
+    WireChangesHeader header;
+    memcpy(&header, buf.data(), sizeof(header));
+    CHECK(header.magic == WIRE_MAGIC_CHANGES);
+    CHECK(header.totalSize <= buf.size());
+    uint32_t fourcc;
+    memcpy(&fourcc, buf.data() + header.totalSize - SCHEMA_FOURCC_SIZE, sizeof(fourcc));
+    CHECK(fourcc == GMEX);
+    return header;
+}
+
+// Record n, stepping over the groups of the ones before it
+static WireChangeRecord Record(const vector<char>& buf, int n, const char** fields = nullptr) {
+    const char* at = buf.data() + SCHEMA_CHANGES_HEADER_SIZE;
+    WireChangeRecord record;
+    for (int i = 0; ; i++) {
+        memcpy(&record, at, sizeof(record));
+        at += SCHEMA_CHANGE_RECORD_SIZE;
+        if (i == n) {
+            break;
+        }
+        for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+            if (record.mask & (1u << g)) {
+                at += rezol_schema_group_size(g);
+            }
+        }
+    }
+    if (fields) {
+        *fields = at;
+    }
+    return record;
+}
+
+int main() {
+    vector<PhysicalScreen> wall = MakeVideoWall(4);
+    double first = LoadTopology(wall);
+
+    // Nothing since the current generation
+    WireChangesHeader header = Header(Changes(first));
+    CHECK(header.full == 0);
+    CHECK(header.recordCount == 0);
+    CHECK(header.generation == first);
+    CHECK(header.totalSize == SCHEMA_CHANGES_HEADER_SIZE + SCHEMA_FOURCC_SIZE);
+
+    // A taskbar moving on one monitor is one record carrying its work area
+    vector<PhysicalScreen> moved = wall;
+    moved[2].workingRect.bottom -= 40;
+    double second = LoadTopology(moved);
+    CHECK(second != first);
+    vector<char> buf = Changes(first);
+    header = Header(buf);
+    CHECK(header.full == 0);
+    CHECK(header.taskbarChanged == 0);
+    CHECK(header.screenCount == 4);
+    CHECK(header.sinceGeneration == first);
+    CHECK(header.generation == second);
+    CHECK(header.recordCount == 1);
+    const char* fields;
+    WireChangeRecord record = Record(buf, 0, &fields);
+    CHECK(record.kind == CHANGE_MODIFIED);
+    CHECK(record.index == 2);
+    CHECK(record.mask == (1u << rezol_schema_index(ScreenChangeGroups, "workingRect")));
+    GMSRect working;
+    memcpy(&working, fields, sizeof(working));
+    CHECK(memcmp(&working, &moved[2].workingRect, sizeof(working)) == 0);
+    CHECK(header.totalSize == SCHEMA_CHANGES_HEADER_SIZE + SCHEMA_CHANGE_RECORD_SIZE + sizeof(GMSRect) + SCHEMA_FOURCC_SIZE);
+
+    // A monitor plugged in is an add with every field
+    vector<PhysicalScreen> grown = moved;
+    grown.push_back(wall[1]);
+    snprintf(grown[4].name, MONITOR_NAME_BUFFER_SIZE, "Mirror of Wall Panel 1");
+    double third = LoadTopology(grown, 1);
+    buf = Changes(second);
+    header = Header(buf);
+    CHECK(header.taskbarChanged == 1);
+    CHECK(header.autoHideTaskbar == 1);
+    CHECK(header.recordCount == 1);
+    record = Record(buf, 0, &fields);
+    CHECK(record.kind == CHANGE_ADDED);
+    CHECK(record.index == 4);
+    CHECK(record.mask == SCHEMA_GROUP_ALL);
+    CHECK(memcmp(fields, &grown[4], SCHEMA_RECORD_SIZE) == 0);
+
+    // Going back from five to the original four: one removed, one modified
+    LoadTopology(wall);
+    buf = Changes(third);
+    header = Header(buf);
+    CHECK(header.recordCount == 2);
+    record = Record(buf, 0);
+    CHECK(record.kind == CHANGE_MODIFIED);
+    CHECK(record.index == 2);
+    record = Record(buf, 1);
+    CHECK(record.kind == CHANGE_REMOVED);
+    CHECK(record.index == 4);
+    CHECK(record.mask == 0);
+
+    // An unknown generation gets the whole topology
+    buf = Changes(12345);
+    header = Header(buf);
+    CHECK(header.full == 1);
+    CHECK(header.recordCount == 4);
+    for (int i = 0; i < 4; i++) {
+        record = Record(buf, i, &fields);
+        CHECK(record.kind == CHANGE_ADDED);
+        CHECK(record.index == i);
+        CHECK(memcmp(fields, &wall[i], SCHEMA_RECORD_SIZE) == 0);
+    }
+
+    // A buffer sized for an earlier, smaller topology is refused
+    LoadTopology(MakeVideoWall(1));
+    vector<char> small((size_t)rezol_ext_get_buffer_size(SCREENCHANGES));
+    vector<PhysicalScreen> big = MakeVideoWall(32);
+    LoadTopology(big);
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)small.data());
+    CHECK(rezol_ext_get_screen_changes_sized(address, (double)small.size(), 0) == 1);
+    CHECK(rezol_ext_get_screen_changes_sized(address, -1, 0) == 1);
+
+    // Without a size only the smallest buffer ever reported is written,
+    // which holds a page of monitors
+    CHECK(small.size() == SCHEMA_SCREEN_CHANGES_LEGACY_SIZE);
+    CHECK(rezol_ext_get_screen_changes(address, 0) == 1);
+    double eight = LoadTopology(MakeVideoWall(SCREENS_PER_PAGE));
+    CHECK(rezol_ext_get_screen_changes(address, 0) == 0);
+    CHECK(Header(small).recordCount == SCREENS_PER_PAGE);
+    CHECK(rezol_ext_get_screen_changes(address, eight) == 0);
+    CHECK(Header(small).recordCount == 0);
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    return TestResult();
+}
@@ -0,0 +1,164 @@
+// Checks the GML buffer is sized for the monitors there really are, with
+// no padding records written, that nothing is written past the size the
+// buffer was given, and that pagination reaches every monitor of a wall.
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_screen_info_test.gmsf";
+
+// Header and fourcc around the records
+static const size_t HeaderSize = (size_t)rezol_ext_get_buffer_size(SCREENINFOHEADER);
+static const size_t FixedSize = HeaderSize + sizeof(uint32_t);
+// Format 1 records stop short of the DPI fields
+static const size_t RecordSize = (size_t)rezol_ext_get_buffer_size(PHYSICALSCREEN);
+static const unsigned char Canary = 0xA5;
+
+struct Decoded {
+    int32_t count, maxCount, fromScreen, pageNum, autoHideTaskbar;
+    uint8_t more;
+    vector<PhysicalScreen> screens;
+    uint32_t fourcc;
+};
+
+static Decoded Decode(const vector<char>& buf) {
+    Decoded d;
+    const char* p = buf.data();
+    memcpy(&d.count, p, 4);
+    memcpy(&d.maxCount, p + 4, 4);
+    memcpy(&d.fromScreen, p + 8, 4);
+    memcpy(&d.pageNum, p + 12, 4);
+    memcpy(&d.autoHideTaskbar, p + 16, 4);
+    memcpy(&d.more, p + 20, 1);
+    d.screens.resize(d.count > 0 ? d.count : 0);
+    for (size_t i = 0; i < d.screens.size(); i++) {
+        memcpy(&d.screens[i], p + HeaderSize + i * RecordSize, RecordSize);
+    }
+    memcpy(&d.fourcc, p + HeaderSize + d.screens.size() * RecordSize, 4);
+    return d;
+}
+
+// Whether the records hold the monitors, as far as the wire record goes
+static bool SameScreens(const vector<PhysicalScreen>& got, const vector<PhysicalScreen>& expected) {
+    if (got.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < got.size(); i++) {
+        if (memcmp(&got[i], &expected[i], RecordSize) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void LoadWall(int count) {
+    vector<PhysicalScreen> wall = MakeVideoWall(count);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), count, 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+}
+
+// Buffer with canary bytes after size, call returns what the export did.
+// sized passes size to the export, otherwise it is trusted to stay within
+// the fixed legacy size.
+static double Call(vector<char>& buf, size_t size, int page, bool sized = true) {
+    buf.assign(size + 64, (char)Canary);
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    double result;
+    if (sized) {
+        result = (page < 0) ? rezol_ext_get_screen_info_sized(address, (double)size)
+                            : rezol_ext_get_screen_info_page_sized(address, (double)size, page);
+    } else {
+        result = (page < 0) ? rezol_ext_get_screen_info(address) : rezol_ext_get_screen_info_page(address, page);
+    }
+    for (size_t i = size; i < buf.size(); i++) {
+        if ((unsigned char)buf[i] != Canary) {
+            CHECK(!"wrote past the end of the buffer");
+            break;
+        }
+    }
+    return result;
+}
+
+int main() {
+    vector<char> buf;
+    const size_t LegacySize = FixedSize + SCREENS_PER_PAGE * RecordSize;
+
+    // A single monitor only writes one record, into a buffer sized for
+    // just that. The reported size still leaves room for a whole page.
+    LoadWall(1);
+    CHECK(RecordSize == 128);
+    CHECK((size_t)rezol_ext_get_buffer_size(SCREENINFO) == LegacySize);
+    size_t size = FixedSize + RecordSize;
+    CHECK(Call(buf, size, -1) == 0);
+    Decoded one = Decode(buf);
+    CHECK(one.count == 1 && !one.more && one.fourcc == GMEX);
+
+    // A 20 panel wall comes back whole in one call
+    LoadWall(20);
+    vector<PhysicalScreen> wall = MakeVideoWall(20);
+    size = (size_t)rezol_ext_get_buffer_size(SCREENINFO);
+    CHECK(size == FixedSize + 20 * RecordSize);
+    CHECK(Call(buf, size, -1) == 0);
+    Decoded all = Decode(buf);
+    CHECK(all.count == 20 && all.fromScreen == 0 && !all.more && all.fourcc == GMEX);
+    CHECK(SameScreens(all.screens, wall));
+
+    // and in pages of SCREENS_PER_PAGE, each needing only a page of room
+    vector<PhysicalScreen> paged;
+    for (int page = 0; page < 4; page++) {
+        CHECK(Call(buf, LegacySize, page) == 0);
+        Decoded d = Decode(buf);
+        CHECK(d.pageNum == page);
+        CHECK(d.fourcc == GMEX);
+        CHECK(d.fromScreen == page * SCREENS_PER_PAGE);
+        CHECK(d.more == (page < 2));
+        CHECK(d.count == (page < 2 ? SCREENS_PER_PAGE : (page == 2 ? 4 : 0)));
+        paged.insert(paged.end(), d.screens.begin(), d.screens.end());
+    }
+    CHECK(SameScreens(paged, wall));
+    CHECK(rezol_ext_get_screen_info_page((char*)"0", -1) == 1);
+    CHECK(rezol_ext_get_screen_info_page_sized((char*)"0", (double)LegacySize, -1) == 1);
+    CHECK(rezol_ext_get_screen_info_sized((char*)"0", -1) == 1);
+    CHECK(rezol_ext_get_screen_info_sized((char*)"0", NAN) == 1);
+    CHECK(Call(buf, HeaderSize, -1) == 1);
+
+    // The unsized exports write at most the fixed legacy buffer
+    CHECK(Call(buf, LegacySize, -1, false) == 0);
+    Decoded legacy = Decode(buf);
+    CHECK(legacy.count == SCREENS_PER_PAGE && legacy.more && legacy.fourcc == GMEX);
+    CHECK(Call(buf, LegacySize, 2, false) == 0);
+    legacy = Decode(buf);
+    CHECK(legacy.count == 4 && !legacy.more && legacy.fourcc == GMEX);
+
+    // Monitors plugged in after GML sized its buffer are left out, with
+    // more set, rather than written past the end, whatever other buffers
+    // were sized in between
+    LoadWall(2);
+    size = FixedSize + 2 * RecordSize;
+    LoadWall(9);
+    CHECK((size_t)rezol_ext_get_buffer_size(SCREENINFO) > size);
+    CHECK((size_t)rezol_ext_get_buffer_size(SCREENMIRROR) > size);
+    CHECK(Call(buf, size, -1) == 0);
+    Decoded grown = Decode(buf);
+    CHECK(grown.count == 2 && grown.more && grown.fourcc == GMEX);
+
+    // A buffer sized while there were two monitors is still a legacy one
+    LoadWall(2);
+    size = (size_t)rezol_ext_get_buffer_size(SCREENINFO);
+    LoadWall(9);
+    CHECK(Call(buf, size, -1, false) == 0);
+    grown = Decode(buf);
+    CHECK(grown.count == SCREENS_PER_PAGE && grown.more && grown.fourcc == GMEX);
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    return TestResult();
+}
@@ -0,0 +1,89 @@
+// Checks the stats buffer has the schema layout, that enumerating and
+// serializing move their stage's counters, and that a library built
+// without stats says so and reports zeros.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_schema.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_stats_test.gmsf";
+
+struct Stats {
+    double result;
+    WireStatsHeader header;
+    WireStageStats stage[STAT_STAGE_COUNT];
+    uint32_t fourcc;
+};
+
+static Stats GetStats() {
+    vector<char> buf((size_t)rezol_ext_get_buffer_size(STATS));
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    Stats stats;
+    stats.result = rezol_ext_get_stats(address);
+    memcpy(&stats.header, buf.data(), SCHEMA_STATS_HEADER_SIZE);
+    memcpy(stats.stage, buf.data() + SCHEMA_STATS_HEADER_SIZE, STAT_STAGE_COUNT * SCHEMA_STAGE_RECORD_SIZE);
+    memcpy(&stats.fourcc, buf.data() + SCHEMA_STATS_HEADER_SIZE + STAT_STAGE_COUNT * SCHEMA_STAGE_RECORD_SIZE,
+           SCHEMA_FOURCC_SIZE);
+    return stats;
+}
+
+int main() {
+    CHECK(rezol_ext_get_buffer_size(STATS) == SCHEMA_STATS_SIZE);
+
+    Stats before = GetStats();
+    CHECK(before.header.magic == WIRE_MAGIC_STATS);
+    CHECK(before.header.stageCount == STAT_STAGE_COUNT);
+    CHECK(before.header.recordSize == SCHEMA_STAGE_RECORD_SIZE);
+    CHECK(before.fourcc == GMEX);
+
+    if (before.result != 0) {
+        // Built with GMS_WITH_STATS off
+        CHECK(before.result == 1);
+        CHECK(before.header.enabled == 0);
+        for (const WireStageStats& s : before.stage) {
+            CHECK(s.calls == 0 && s.totalUs == 0 && s.lastUs == 0 && s.maxUs == 0);
+        }
+        return TestResult();
+    }
+    CHECK(before.header.enabled == 1);
+
+    vector<PhysicalScreen> wall = MakeVideoWall(64);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    for (int i = 0; i < 3; i++) {
+        rezol_ext_refresh_topology();
+    }
+    Stats enumerated = GetStats();
+    const WireStageStats& e = enumerated.stage[STAT_ENUMERATE];
+    CHECK(e.calls >= before.stage[STAT_ENUMERATE].calls + 3);
+    CHECK(e.lastUs > 0 && e.lastUs <= e.maxUs && e.maxUs <= e.totalUs);
+    CHECK(e.totalUs > before.stage[STAT_ENUMERATE].totalUs);
+    // A fixture resolves no names and queries no modes
+    CHECK(enumerated.stage[STAT_NAMES].calls == before.stage[STAT_NAMES].calls);
+    CHECK(enumerated.stage[STAT_MODES].calls == before.stage[STAT_MODES].calls);
+
+    // Both buffers GML reads count as serialization
+    vector<char> info((size_t)rezol_ext_get_buffer_size(SCREENINFO));
+    vector<char> changes((size_t)rezol_ext_get_buffer_size(SCREENCHANGES));
+    char infoAddress[32], changesAddress[32];
+    snprintf(infoAddress, sizeof(infoAddress), "%p", (void*)info.data());
+    snprintf(changesAddress, sizeof(changesAddress), "%p", (void*)changes.data());
+    CHECK(rezol_ext_get_screen_info(infoAddress) == 0);
+    CHECK(rezol_ext_get_screen_changes_sized(changesAddress, (double)changes.size(), 0) == 0);
+    Stats serialized = GetStats();
+    const WireStageStats& s = serialized.stage[STAT_SERIALIZE];
+    CHECK(s.calls == enumerated.stage[STAT_SERIALIZE].calls + 2);
+    CHECK(s.lastUs > 0 && s.lastUs <= s.maxUs);
+    CHECK(s.totalUs > enumerated.stage[STAT_SERIALIZE].totalUs);
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    return TestResult();
+}
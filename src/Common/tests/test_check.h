@@ -0,0 +1,35 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+// Tiny assertion helpers shared by the test programs. Each test is a plain
+// executable that prints failed checks and returns TestResult() from main.
+#include <cstdio>
+#include <iostream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cout << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed" << std::endl; \
+            failures++; \
+        } \
+    } while (0)
+
+// A buffer's address as GML passes it to the exports, a "%p" string
+struct BufferAddress {
+    char text[32];
+    explicit BufferAddress(const void* buffer) {
+        std::snprintf(text, sizeof(text), "%p", buffer);
+    }
+    operator char*() {
+        return text;
+    }
+};
+
+static inline int TestResult() {
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+    return failures ? 1 : 0;
+}
+
+#endif // TEST_CHECK_H
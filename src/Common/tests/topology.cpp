@@ -0,0 +1,63 @@
+// Checks the cached topology snapshot only moves its generation when the
+// monitors actually change, and that queries still see changes once the
+// watcher has been shut down.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_topology.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_topology_test.gmsf";
+
+static void LoadTopology(const vector<PhysicalScreen>& screens) {
+    CHECK(rezol_fixture_write(FixturePath, screens.data(), (int32_t)screens.size(), 0));
+    CHECK(rezol_fixture_load(FixturePath));
+}
+
+int main() {
+    LoadTopology(MakeVideoWall(4));
+    uint64_t first = (uint64_t)rezol_ext_get_topology_generation();
+    CHECK(first != 0);
+    CHECK((uint64_t)rezol_ext_get_topology_generation() == first);
+
+    TopologyRef snapshot = rezol_topology_current();
+    CHECK(snapshot->generation == first);
+    CHECK(snapshot->screens.size() == 4);
+
+    // Reloading identical content re-enumerates but keeps the generation
+    LoadTopology(MakeVideoWall(4));
+    CHECK((uint64_t)rezol_ext_get_topology_generation() == first);
+    CHECK((uint64_t)rezol_ext_refresh_topology() == first);
+    CHECK(rezol_topology_current() == snapshot);
+
+    // A real change moves it forward and leaves the old snapshot untouched
+    vector<PhysicalScreen> moved = MakeVideoWall(4);
+    moved[2].workingRect.bottom -= 40;
+    LoadTopology(moved);
+    uint64_t second = (uint64_t)rezol_ext_get_topology_generation();
+    CHECK(second > first);
+    CHECK(snapshot->screens[2].workingRect.bottom == moved[2].workingRect.bottom + 40);
+    CHECK(rezol_topology_current()->screens[2].workingRect.bottom == moved[2].workingRect.bottom);
+
+    // Snapshots keep every monitor, however many there are
+    LoadTopology(MakeVideoWall(64));
+    CHECK(rezol_topology_current()->screens.size() == 64);
+    uint64_t third = (uint64_t)rezol_ext_get_topology_generation();
+    CHECK(third > second);
+
+    // Without a watcher every query enumerates, so nothing is missed
+    rezol_topology_shutdown();
+    rezol_topology_shutdown();
+    LoadTopology(MakeVideoWall(2));
+    CHECK(rezol_topology_current()->screens.size() == 2);
+    CHECK((uint64_t)rezol_ext_get_topology_generation() > third);
+
+    rezol_fixture_unload();
+    remove(FixturePath);
+    return TestResult();
+}
@@ -0,0 +1,143 @@
+// Checks topology queries land in the trace ring as matched begin/end
+// events, that the ring keeps only the newest events while several
+// threads write to it and it is dumped at the same time, and that the
+// buffer and file exports write the same JSON.
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_topology.h"
+#include "screen_trace.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_trace_test.gmsf";
+static const char* TracePath = "gms_trace_test.json";
+
+static size_t Count(const string& text, const string& what) {
+    size_t count = 0;
+    for (size_t at = text.find(what); at != string::npos; at = text.find(what, at + what.size())) {
+        count++;
+    }
+    return count;
+}
+
+// One event per line between the header and the closing bracket
+static bool WellFormed(const string& json, size_t& events) {
+    const string head = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    const string tail = "\n]}\n";
+    if (json.compare(0, head.size(), head) != 0 || json.size() < head.size() + tail.size() - 1 ||
+        json.compare(json.size() - tail.size(), tail.size(), tail) != 0) {
+        return false;
+    }
+    events = 0;
+    istringstream lines(json.substr(head.size(), json.size() - head.size() - tail.size()));
+    string line;
+    while (getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line.back() == ',') {
+            line.pop_back();
+        }
+        if (line.compare(0, 9, "{\"name\":\"") != 0 || line.back() != '}' || line.find("\"tid\":") == string::npos) {
+            return false;
+        }
+        events++;
+    }
+    return true;
+}
+
+int main() {
+    vector<char> buf((size_t)rezol_ext_get_buffer_size(TRACE));
+    CHECK(buf.size() == TRACE_JSON_MAX + 1);
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    if (rezol_ext_get_trace(address) != 0) {
+        // Built with GMS_WITH_TRACE off
+        CHECK(rezol_trace_json().empty());
+        CHECK(rezol_ext_save_trace((char*)TracePath) == 1);
+        return TestResult();
+    }
+
+    // Queries against a fixture
+    vector<PhysicalScreen> wall = MakeVideoWall(8);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    rezol_ext_refresh_topology();
+    rezol_topology_invalidate();
+    rezol_ext_get_topology_generation();
+    CHECK(rezol_ext_get_trace(address) == 0);
+    string json = buf.data();
+    size_t events = 0;
+    CHECK(WellFormed(json, events));
+    CHECK(events > 0 && events <= TRACE_RING_SIZE);
+    CHECK(Count(json, "{\"name\":\"topology_refresh\",\"ph\":\"B\"") >= 1);
+    size_t begins = Count(json, "{\"name\":\"enumerate\",\"ph\":\"B\"");
+    CHECK(begins >= 2);
+    CHECK(Count(json, "{\"name\":\"enumerate\",\"ph\":\"E\"") == begins);
+    CHECK(json.find("{\"name\":\"invalidate\",\"ph\":\"i\"") != string::npos);
+    CHECK(json.find(",\"s\":\"t\"}") != string::npos);
+
+    // The file export writes the same text
+    CHECK(rezol_ext_save_trace((char*)TracePath) == 0);
+    ifstream in(TracePath, ios::binary);
+    stringstream saved;
+    saved << in.rdbuf();
+    in.close();
+    size_t savedEvents = 0;
+    CHECK(WellFormed(saved.str(), savedEvents));
+    CHECK(savedEvents == events);
+    CHECK(rezol_ext_save_trace((char*)"") == 1);
+
+    // Writers lapping the ring many times while it is dumped
+    atomic<bool> stop(false);
+    vector<thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&stop] {
+            for (int i = 0; i < 20000 || !stop; i++) {
+                rezol_trace_event("stress", 'B');
+                rezol_trace_event("stress", 'E');
+            }
+        });
+    }
+    for (int i = 0; i < 50; i++) {
+        string during = rezol_trace_json();
+        size_t n = 0;
+        CHECK(WellFormed(during, n));
+        CHECK(n <= TRACE_RING_SIZE);
+    }
+    stop = true;
+    for (thread& writer : writers) {
+        writer.join();
+    }
+
+    json = rezol_trace_json();
+    CHECK(WellFormed(json, events));
+    CHECK(events <= TRACE_RING_SIZE);
+    CHECK(json.find("\"enumerate\"") == string::npos);
+
+    // Once quiet the ring holds exactly the newest lap
+    for (size_t i = 0; i < TRACE_RING_SIZE / 2; i++) {
+        rezol_trace_event("after", 'B');
+        rezol_trace_event("after", 'E');
+    }
+    json = rezol_trace_json();
+    CHECK(WellFormed(json, events));
+    CHECK(events == TRACE_RING_SIZE);
+    CHECK(Count(json, "{\"name\":\"after\",") == TRACE_RING_SIZE);
+    CHECK(json.size() <= TRACE_JSON_MAX);
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    remove(TracePath);
+    return TestResult();
+}
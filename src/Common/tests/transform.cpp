@@ -0,0 +1,126 @@
+// Checks the vector transform kernels agree with the scalar reference, that
+// the pixel and millimetre desktops are laid out edge to edge on a mixed DPI
+// desktop, and that converting there and back is the identity.
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_transform.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static bool Near(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (1 + fabs(a) + fabs(b));
+}
+
+// Points spread over and around every monitor in a space
+static vector<double> MakePoints(const SpaceColumns& c) {
+    vector<double> points;
+    FixtureRandom next(3);
+    for (size_t i = 0; i < c.left.size(); i++) {
+        double w = c.right[i] - c.left[i];
+        double h = c.bottom[i] - c.top[i];
+        points.insert(points.end(), { c.left[i], c.top[i], c.right[i], c.bottom[i] });
+        for (int k = 0; k < 13; k++) {
+            double fx = next.Below(1200) / 1000.0 - 0.1;
+            double fy = next.Below(1200) / 1000.0 - 0.1;
+            points.insert(points.end(), { c.left[i] + fx * w, c.top[i] + fy * h });
+        }
+    }
+    points.insert(points.end(), { -1e6, -1e6, 1e6, 3.5 });
+    return points;
+}
+
+static void CheckKernels(const vector<PhysicalScreen>& screens) {
+    ScreenSpaces spaces;
+    rezol_spaces_build(spaces, screens);
+    for (int32_t from = 0; from < SPACE_COUNT; from++) {
+        vector<double> points = MakePoints(spaces.space[from]);
+        size_t count = points.size() / 2;
+        vector<int32_t> wantOwners(count);
+        rezol_space_owners(SIMD_SCALAR, spaces, from, points.data(), wantOwners.data(), count);
+
+        for (int32_t kernel : { (int32_t)SIMD_SSE2, (int32_t)SIMD_AVX2 }) {
+            if (!rezol_simd_supported(kernel)) {
+                continue;
+            }
+            vector<int32_t> owners(count);
+            rezol_space_owners(kernel, spaces, from, points.data(), owners.data(), count);
+            CHECK(owners == wantOwners);
+
+            for (int32_t to = 0; to < SPACE_COUNT; to++) {
+                vector<double> want(points.size()), got(points.size() + 2, 42);
+                rezol_space_apply(SIMD_SCALAR, spaces, from, to, wantOwners.data(), points.data(), want.data(), count);
+                rezol_space_apply(kernel, spaces, from, to, wantOwners.data(), points.data(), got.data() + 1, count);
+                int mismatches = 0;
+                for (size_t k = 0; k < points.size(); k++) {
+                    if (!Near(got[k + 1], want[k]) && mismatches++ < 5) {
+                        printf("kernel %d, %d to %d, value %zu: got %f, want %f\n", kernel, from, to, k, got[k + 1], want[k]);
+                    }
+                }
+                CHECK(mismatches == 0);
+                CHECK(got[0] == 42 && got.back() == 42);
+            }
+        }
+    }
+}
+
+int main() {
+    for (const vector<PhysicalScreen>& screens : MakeKernelLayouts({ 1, 2, 3, 5, 8, 64 })) {
+        CheckKernels(screens);
+    }
+
+    // The 4K laptop panel at 200% and two 1080p monitors to its right
+    vector<PhysicalScreen> dpi = MakeMixedDPI();
+    ScreenSpaces spaces;
+    rezol_spaces_build(spaces, dpi);
+    const SpaceColumns& pixels = spaces.space[SPACE_PIXELS];
+    const SpaceColumns& mm = spaces.space[SPACE_MM];
+    CHECK(pixels.right[0] == 3840 && pixels.bottom[0] == 2160);
+    CHECK(pixels.left[1] == 3840 && pixels.left[2] == 5760);
+    CHECK(Near(mm.right[0], 344) && Near(mm.left[1], 344) && Near(mm.left[2], 344 + 527));
+    CHECK(Near(mm.bottom[1], 296));
+
+    vector<double> points = { 960, 540, 2880, 540, 0, 0 };
+    vector<double> out(points.size());
+    rezol_space_transform_points(spaces, SPACE_LOGICAL, SPACE_PIXELS, points.data(), out.data(), 3);
+    CHECK(out == vector<double>({ 1920, 1080, 4800, 540, 0, 0 }));
+    rezol_space_transform_points(spaces, SPACE_LOGICAL, SPACE_MM, points.data(), out.data(), 3);
+    CHECK(Near(out[0], 172) && Near(out[1], 97));
+    CHECK(Near(out[2], 344 + 263.5) && Near(out[3], 148));
+
+    // There and back
+    for (int32_t to = 0; to < SPACE_COUNT; to++) {
+        vector<double> there(points.size()), back(points.size());
+        rezol_space_transform_points(spaces, SPACE_LOGICAL, to, points.data(), there.data(), 3);
+        rezol_space_transform_points(spaces, to, SPACE_LOGICAL, there.data(), back.data(), 3);
+        for (size_t k = 0; k < points.size(); k++) {
+            CHECK(Near(back[k], points[k]));
+        }
+    }
+
+    // A panel with no EDID is taken as 96 dpi
+    vector<PhysicalScreen> wall = MakeVideoWall(4);
+    rezol_spaces_build(spaces, wall);
+    CHECK(Near(spaces.space[SPACE_MM].right[3] - spaces.space[SPACE_MM].left[3], 1920 * 25.4 / 96));
+
+    // Through the exports, in place
+    ScopedFixture fixture("gms_transform_test.gmsf", dpi);
+    CHECK(fixture.loaded);
+    vector<double> rects = { 0, 0, 1920, 1080, 1920, 0, 3840, 1080 };
+    BufferAddress rectsAddress(rects.data());
+    CHECK(rezol_ext_transform_rects(rectsAddress, rectsAddress, 2, SPACE_LOGICAL, SPACE_PIXELS) == 0);
+    CHECK(rects == vector<double>({ 0, 0, 3840, 2160, 3840, 0, 5760, 1080 }));
+    CHECK(rezol_ext_transform_rects(rectsAddress, rectsAddress, 2, SPACE_PIXELS, SPACE_LOGICAL) == 0);
+    CHECK(rects == vector<double>({ 0, 0, 1920, 1080, 1920, 0, 3840, 1080 }));
+    BufferAddress pointsAddress(points.data());
+    CHECK(rezol_ext_transform_points(pointsAddress, pointsAddress, 3, SPACE_LOGICAL, SPACE_PIXELS) == 0);
+    CHECK(points[0] == 1920 && points[1] == 1080);
+    CHECK(rezol_ext_transform_points(pointsAddress, pointsAddress, 3, SPACE_LOGICAL, 7) == 1);
+    CHECK(rezol_ext_transform_points(pointsAddress, pointsAddress, -2, SPACE_LOGICAL, SPACE_MM) == 1);
+
+    return TestResult();
+}
@@ -0,0 +1,142 @@
+// Checks the version 1 buffer is byte for byte what the field by field
+// writer used to produce, and that a version 2 buffer carries its sizes
+// and an offset table that lands on every monitor.
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_fixture.h"
+#include "screen_wire.h"
+#include "tests/test_check.h"
+#include "tests/fixture_topologies.h"
+
+using namespace std;
+
+static const char* FixturePath = "gms_wire_format_test.gmsf";
+
+template<typename T>
+static void Put(vector<char>& out, const T& val) {
+    const char* p = reinterpret_cast<const char*>(&val);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+// The version 1 layout as it was written before the packed records
+static vector<char> ReferenceV1(const vector<PhysicalScreen>& screens) {
+    vector<char> out;
+    Put(out, (int32_t)screens.size());
+    Put(out, (int32_t)screens.size());
+    Put(out, (int32_t)0);
+    Put(out, (int32_t)0);
+    Put(out, (int32_t)0);
+    Put(out, (uint8_t)0);
+    Put(out, GMSVersionMajor);
+    Put(out, GMSVersionMinor);
+    Put(out, GMSVersionBuild);
+    for (const PhysicalScreen& s : screens) {
+        Put(out, s.errorCode);
+        Put(out, s.refreshRate);
+        Put(out, s.isPrimary);
+        Put(out, s.pixelBox.width);
+        Put(out, s.pixelBox.height);
+        Put(out, s.virtualRect.left);
+        Put(out, s.virtualRect.top);
+        Put(out, s.virtualRect.right);
+        Put(out, s.virtualRect.bottom);
+        Put(out, s.workingRect.left);
+        Put(out, s.workingRect.top);
+        Put(out, s.workingRect.right);
+        Put(out, s.workingRect.bottom);
+        Put(out, s.physSize.width);
+        Put(out, s.physSize.height);
+        Put(out, s.physSize.diagonal);
+        Put(out, s.name);
+    }
+    Put(out, GMEX);
+    return out;
+}
+
+static double Call(vector<char>& buf, int page) {
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf.data());
+    double size = (double)buf.size();
+    return (page < 0) ? rezol_ext_get_screen_info_sized(address, size)
+                      : rezol_ext_get_screen_info_page_sized(address, size, page);
+}
+
+int main() {
+    vector<PhysicalScreen> wall = MakeVideoWall(12);
+    CHECK(rezol_fixture_write(FixturePath, wall.data(), (int32_t)wall.size(), 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+
+    // Version 1 is the default and unchanged
+    CHECK(rezol_wire_format() == WIRE_FORMAT_V1);
+    CHECK(rezol_ext_get_buffer_size(SCREENINFOHEADER) == sizeof(WireHeaderV1));
+    vector<char> reference = ReferenceV1(wall);
+    CHECK(reference.size() == 24 + 12 * 128 + 4);
+    vector<char> buf((size_t)rezol_ext_get_buffer_size(SCREENINFO));
+    CHECK(buf.size() == reference.size());
+    CHECK(Call(buf, -1) == 0);
+    CHECK(buf == reference);
+
+    // Only known formats can be selected
+    CHECK(rezol_ext_set_wire_format(0) == 1);
+    CHECK(rezol_ext_set_wire_format(3) == 1);
+    CHECK(rezol_wire_format() == WIRE_FORMAT_V1);
+
+    CHECK(rezol_ext_set_wire_format(WIRE_FORMAT_V2) == 0);
+    CHECK(rezol_ext_get_buffer_size(SCREENINFOHEADER) == sizeof(WireHeaderV2));
+    size_t size = (size_t)rezol_ext_get_buffer_size(SCREENINFO);
+    CHECK(size == sizeof(WireHeaderV2) + 12 * (sizeof(uint32_t) + sizeof(PhysicalScreen)) + sizeof(uint32_t));
+    buf.assign(size, 0);
+    CHECK(Call(buf, -1) == 0);
+
+    WireHeaderV2 header;
+    memcpy(&header, buf.data(), sizeof(header));
+    CHECK(header.magic == WIRE_MAGIC_V2);
+    CHECK(header.format == WIRE_FORMAT_V2);
+    CHECK(header.headerSize == sizeof(WireHeaderV2));
+    CHECK(header.recordSize == sizeof(PhysicalScreen));
+    CHECK(header.count == 12 && header.maxCount == 12 && !header.more);
+    CHECK(header.versionMajor == GMSVersionMajor && header.versionMinor == GMSVersionMinor);
+    CHECK(header.totalSize == size);
+    uint32_t fourcc;
+    memcpy(&fourcc, buf.data() + header.totalSize - sizeof(fourcc), sizeof(fourcc));
+    CHECK(fourcc == GMEX);
+
+    // Any monitor straight from the offset table, in any order
+    for (int i = 11; i >= 0; i--) {
+        uint32_t offset;
+        memcpy(&offset, buf.data() + header.headerSize + i * sizeof(uint32_t), sizeof(offset));
+        CHECK(offset % sizeof(uint32_t) == 0);
+        CHECK(offset + header.recordSize <= header.totalSize);
+        PhysicalScreen screen;
+        memcpy(&screen, buf.data() + offset, sizeof(screen));
+        CHECK(memcmp(&screen, &wall[i], sizeof(screen)) == 0);
+    }
+
+    // Pages carry their own offsets, and a short buffer sets more
+    CHECK(Call(buf, 1) == 0);
+    memcpy(&header, buf.data(), sizeof(header));
+    CHECK(header.count == 4 && header.fromScreen == SCREENS_PER_PAGE && !header.more);
+    uint32_t offset;
+    memcpy(&offset, buf.data() + header.headerSize, sizeof(offset));
+    CHECK(offset == sizeof(WireHeaderV2) + 4 * sizeof(uint32_t));
+    CHECK(memcmp(buf.data() + offset, &wall[SCREENS_PER_PAGE], sizeof(PhysicalScreen)) == 0);
+
+    rezol_ext_get_buffer_size(SCREENINFO);
+    vector<PhysicalScreen> bigger = MakeVideoWall(14);
+    CHECK(rezol_fixture_write(FixturePath, bigger.data(), (int32_t)bigger.size(), 0));
+    CHECK(rezol_ext_load_fixture((char*)FixturePath) == 0);
+    buf.assign(size, 0);
+    CHECK(Call(buf, -1) == 0);
+    memcpy(&header, buf.data(), sizeof(header));
+    CHECK(header.count == 12 && header.more && header.totalSize == size);
+
+    // Switching back gives the old layout again
+    CHECK(rezol_ext_set_wire_format(WIRE_FORMAT_V1) == 0);
+    CHECK(rezol_ext_get_buffer_size(SCREENINFOHEADER) == sizeof(WireHeaderV1));
+
+    rezol_ext_load_fixture((char*)"");
+    remove(FixturePath);
+    return TestResult();
+}
@@ -0,0 +1,188 @@
+// GMSSchemaGen: writes the GML decode script for the buffers described in
+// screen_schema.h. Every read is a buffer_peek at an offset fixed here at
+// build time, so decoding needs no buffer_seek or sequential reads.
+//   GMSSchemaGen rezol_decode.gml
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "screen_schema.h"
+
+using namespace std;
+
+static const char* GMLType(SchemaType type) {
+    switch (type) {
+        case SCHEMA_U8:     return "buffer_u8";
+        case SCHEMA_U16:    return "buffer_u16";
+        case SCHEMA_S32:    return "buffer_s32";
+        case SCHEMA_U32:    return "buffer_u32";
+        case SCHEMA_F64:    return "buffer_f64";
+        case SCHEMA_STRING: return "buffer_string";
+    }
+    return "buffer_u8";
+}
+
+// Struct literal members, one peek per field, offsets relative to base.
+// Only the first count fields when a format ends the record early.
+template<size_t N>
+static void Members(ostream& out, const SchemaField (&fields)[N], const char* indent, const char* base = "_at",
+                    size_t count = N) {
+    for (size_t i = 0; i < count; i++) {
+        out << indent << fields[i].name << ": buffer_peek(_buf, " << base << " + " << rezol_schema_offset(fields, i)
+            << ", " << GMLType(fields[i].type) << ")" << (i + 1 < count ? "," : "") << "\n";
+    }
+}
+
+template<size_t N>
+static void DecodeFunction(ostream& out, const char* name, const SchemaField (&fields)[N], size_t count = N) {
+    out << "function " << name << "(_buf, _at = 0) {\n"
+        << "    return {\n";
+    Members(out, fields, "        ", "_at", count);
+    out << "    };\n"
+        << "}\n\n";
+}
+
+static void Write(ostream& out) {
+    out << "// Generated by GMSSchemaGen from src/Common/screen_schema.h, do not edit.\n"
+        << "// Pass the offset of the payload as _at when reading a mirrored buffer.\n\n";
+
+    out << "#macro REZOL_PHYSICALSCREEN_SIZE " << SCHEMA_RECORD_V1_SIZE << "\n"
+        << "#macro REZOL_PHYSICALSCREEN_V2_SIZE " << SCHEMA_RECORD_SIZE << "\n"
+        << "#macro REZOL_SCREENINFO_V1_HEADER_SIZE " << SCHEMA_HEADER_V1_SIZE << "\n"
+        << "#macro REZOL_SCREENINFO_V2_HEADER_SIZE " << SCHEMA_HEADER_V2_SIZE << "\n"
+        << "#macro REZOL_WINDOWCHROME_SIZE " << rezol_schema_size(WindowChromeSchema) << "\n"
+        << "#macro REZOL_MIRRORHEADER_SIZE " << rezol_schema_size(MirrorHeaderSchema) << "\n"
+        << "#macro REZOL_RECTPLACEMENT_SIZE " << rezol_schema_size(RectPlacementSchema) << "\n"
+        << "#macro REZOL_SCREENCHANGES_HEADER_SIZE " << SCHEMA_CHANGES_HEADER_SIZE << "\n"
+        << "#macro REZOL_STATS_SIZE " << SCHEMA_STATS_SIZE << "\n"
+        << "#macro REZOL_WIRE_MAGIC_V2 " << WIRE_MAGIC_V2 << "\n"
+        << "#macro REZOL_WIRE_MAGIC_CHANGES " << WIRE_MAGIC_CHANGES << "\n"
+        << "#macro REZOL_WIRE_MAGIC_STATS " << WIRE_MAGIC_STATS << "\n"
+        << "#macro REZOL_CHANGE_ADDED " << CHANGE_ADDED << "\n"
+        << "#macro REZOL_CHANGE_REMOVED " << CHANGE_REMOVED << "\n"
+        << "#macro REZOL_CHANGE_MODIFIED " << CHANGE_MODIFIED << "\n"
+        << "#macro REZOL_STAT_ENUMERATE " << STAT_ENUMERATE << "\n"
+        << "#macro REZOL_STAT_NAMES " << STAT_NAMES << "\n"
+        << "#macro REZOL_STAT_MODES " << STAT_MODES << "\n"
+        << "#macro REZOL_STAT_PHYSSIZE " << STAT_PHYSSIZE << "\n"
+        << "#macro REZOL_STAT_SERIALIZE " << STAT_SERIALIZE << "\n"
+        << "#macro REZOL_GMEX " << GMEX << "\n\n";
+
+    // Format 1 records end before the DPI fields
+    DecodeFunction(out, "rezol_decode_physical_screen", PhysicalScreenSchema, SCHEMA_RECORD_V1_FIELDS);
+    DecodeFunction(out, "rezol_decode_physical_screen_v2", PhysicalScreenSchema);
+    DecodeFunction(out, "rezol_decode_window_chrome", WindowChromeSchema);
+    DecodeFunction(out, "rezol_decode_mirror_header", MirrorHeaderSchema);
+    DecodeFunction(out, "rezol_decode_rect_placement", RectPlacementSchema);
+    DecodeFunction(out, "rezol_decode_stage_stats", StageStatsSchema);
+
+    // Stats: one record per stage, indexed by the REZOL_STAT_ macros
+    size_t stageCount = rezol_schema_offset(StatsHeaderSchema, "stageCount");
+    out << "function rezol_decode_stats(_buf, _at = 0) {\n"
+        << "    var _stats = {\n";
+    Members(out, StatsHeaderSchema, "        ");
+    out << "    };\n"
+        << "    var _count = buffer_peek(_buf, _at + " << stageCount << ", buffer_u8);\n"
+        << "    _stats.stages = array_create(_count);\n"
+        << "    for (var _i = 0; _i < _count; _i++) {\n"
+        << "        _stats.stages[_i] = rezol_decode_stage_stats(_buf, _at + " << SCHEMA_STATS_HEADER_SIZE
+        << " + _i * " << SCHEMA_STAGE_RECORD_SIZE << ");\n"
+        << "    }\n"
+        << "    _stats.fourcc = buffer_peek(_buf, _at + " << SCHEMA_STATS_HEADER_SIZE << " + _count * "
+        << SCHEMA_STAGE_RECORD_SIZE << ", buffer_u32);\n"
+        << "    return _stats;\n"
+        << "}\n\n";
+
+    // Version 1: records straight after the header
+    size_t countV1 = rezol_schema_offset(ScreenInfoV1Schema, "count");
+    out << "function rezol_decode_screen_info_v1(_buf, _at = 0) {\n"
+        << "    var _info = {\n";
+    Members(out, ScreenInfoV1Schema, "        ");
+    out << "    };\n"
+        << "    var _count = buffer_peek(_buf, _at + " << countV1 << ", buffer_s32);\n"
+        << "    _info.screens = array_create(_count);\n"
+        << "    for (var _i = 0; _i < _count; _i++) {\n"
+        << "        _info.screens[_i] = rezol_decode_physical_screen(_buf, _at + " << SCHEMA_HEADER_V1_SIZE
+        << " + _i * " << SCHEMA_RECORD_V1_SIZE << ");\n"
+        << "    }\n"
+        << "    _info.fourcc = buffer_peek(_buf, _at + " << SCHEMA_HEADER_V1_SIZE << " + _count * "
+        << SCHEMA_RECORD_V1_SIZE << ", buffer_u32);\n"
+        << "    return _info;\n"
+        << "}\n\n";
+
+    // Version 2: records found through the offset table
+    size_t countV2 = rezol_schema_offset(ScreenInfoV2Schema, "count");
+    size_t totalV2 = rezol_schema_offset(ScreenInfoV2Schema, "totalSize");
+    out << "function rezol_decode_screen_info_v2(_buf, _at = 0) {\n"
+        << "    var _info = {\n";
+    Members(out, ScreenInfoV2Schema, "        ");
+    out << "    };\n"
+        << "    var _count = buffer_peek(_buf, _at + " << countV2 << ", buffer_s32);\n"
+        << "    _info.screens = array_create(_count);\n"
+        << "    for (var _i = 0; _i < _count; _i++) {\n"
+        << "        _info.screens[_i] = rezol_decode_physical_screen_v2(_buf, _at + buffer_peek(_buf, _at + "
+        << SCHEMA_HEADER_V2_SIZE << " + _i * " << SCHEMA_OFFSET_SIZE << ", buffer_u32));\n"
+        << "    }\n"
+        << "    _info.fourcc = buffer_peek(_buf, _at + buffer_peek(_buf, _at + " << totalV2
+        << ", buffer_u32) - " << SCHEMA_FOURCC_SIZE << ", buffer_u32);\n"
+        << "    return _info;\n"
+        << "}\n\n";
+
+    // Either version, told apart by the v2 magic
+    size_t magic = rezol_schema_offset(ScreenInfoV2Schema, "magic");
+    out << "function rezol_decode_screen_info(_buf, _at = 0) {\n"
+        << "    if (buffer_peek(_buf, _at + " << magic << ", buffer_u32) == REZOL_WIRE_MAGIC_V2) {\n"
+        << "        return rezol_decode_screen_info_v2(_buf, _at);\n"
+        << "    }\n"
+        << "    return rezol_decode_screen_info_v1(_buf, _at);\n"
+        << "}\n\n";
+
+    // Changes: records vary in length, each group present is read at
+    // offsets fixed within the group and _pos steps over it
+    size_t recordCount = rezol_schema_offset(ScreenChangesSchema, "recordCount");
+    size_t mask = rezol_schema_offset(ScreenChangeRecordSchema, "mask");
+    out << "function rezol_decode_screen_changes(_buf, _at = 0) {\n"
+        << "    var _changes = {\n";
+    Members(out, ScreenChangesSchema, "        ");
+    out << "    };\n"
+        << "    var _count = buffer_peek(_buf, _at + " << recordCount << ", buffer_u16);\n"
+        << "    var _pos = _at + " << SCHEMA_CHANGES_HEADER_SIZE << ";\n"
+        << "    _changes.records = array_create(_count);\n"
+        << "    for (var _i = 0; _i < _count; _i++) {\n"
+        << "        var _record = {\n";
+    Members(out, ScreenChangeRecordSchema, "            ", "_pos");
+    out << "        };\n"
+        << "        var _mask = buffer_peek(_buf, _pos + " << mask << ", buffer_u16);\n"
+        << "        _pos += " << SCHEMA_CHANGE_RECORD_SIZE << ";\n";
+    for (size_t g = 0; g < SCHEMA_GROUP_COUNT; g++) {
+        const SchemaGroup& group = ScreenChangeGroups[g];
+        size_t first = rezol_schema_index(PhysicalScreenSchema, group.firstField);
+        out << "        if (_mask & " << (1u << g) << ") { // " << group.name << "\n";
+        for (size_t f = first; f < first + group.fieldCount; f++) {
+            out << "            _record." << PhysicalScreenSchema[f].name << " = buffer_peek(_buf, _pos + "
+                << rezol_schema_offset(PhysicalScreenSchema, f) - rezol_schema_group_offset(g) << ", "
+                << GMLType(PhysicalScreenSchema[f].type) << ");\n";
+        }
+        out << "            _pos += " << rezol_schema_group_size(g) << ";\n"
+            << "        }\n";
+    }
+    out << "        _changes.records[_i] = _record;\n"
+        << "    }\n"
+        << "    _changes.fourcc = buffer_peek(_buf, _pos, buffer_u32);\n"
+        << "    return _changes;\n"
+        << "}\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        cerr << "usage: GMSSchemaGen output.gml" << endl;
+        return 1;
+    }
+    ofstream out(argv[1], ios::binary);
+    Write(out);
+    out.close();
+    if (!out) {
+        cerr << "GMSSchemaGen: could not write " << argv[1] << endl;
+        return 1;
+    }
+    return 0;
+}
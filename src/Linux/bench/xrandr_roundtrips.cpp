@@ -0,0 +1,96 @@
+// Compares the Xlib and XCB RandR backends as the monitor count grows.
+// Run it against a private server, e.g.
+//   sh src/Linux/tests/run_xvfb.sh Xvfb ./build/bin/BenchXRandR
+// Xvfb only has one real output, so monitors 2..N are RandR 1.5 virtual
+// monitors. On real hardware each extra output also adds an output info,
+// CRTC info and EDID round trip to the Xlib path.
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <X11/Xlib.h>
+#include <X11/extensions/Xrandr.h>
+#include "screen_utils.h"
+#include "linux_backends.h"
+
+using namespace std;
+
+constexpr int MAX_BENCH_MONITORS = 16;
+constexpr int ITERATIONS = 50;
+
+static void SetMonitors(Display* dpy, Window root, int count) {
+    char name[32];
+    // Clear out the previous layout
+    for (int i = 0; i < MAX_BENCH_MONITORS; i++) {
+        snprintf(name, sizeof(name), "BENCH-%d", i);
+        Atom atom = XInternAtom(dpy, name, True);
+        if (atom != None) {
+            XRRDeleteMonitor(dpy, root, atom);
+        }
+    }
+    int width = DisplayWidth(dpy, DefaultScreen(dpy)) / MAX_BENCH_MONITORS;
+    for (int i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "BENCH-%d", i);
+        XRRMonitorInfo* mon = XRRAllocateMonitor(dpy, 0);
+        mon->name = XInternAtom(dpy, name, False);
+        mon->primary = (i == 0);
+        mon->x = i * width;
+        mon->y = 0;
+        mon->width = width;
+        mon->height = DisplayHeight(dpy, DefaultScreen(dpy));
+        mon->mwidth = width / 4;
+        mon->mheight = mon->height / 4;
+        XRRSetMonitor(dpy, root, mon);
+        XRRFreeMonitors(mon);
+    }
+    XSync(dpy, False);
+}
+
+// Median wall time in microseconds of one full enumeration
+static double TimeBackend(int32_t (*enumerate)(ScreenInfo*), int& count) {
+    PhysicalScreen screenArray[MAX_BENCH_MONITORS];
+    vector<double> samples;
+    for (int i = 0; i < ITERATIONS; i++) {
+        ScreenInfo info = {};
+        info.screen = screenArray;
+        info.maxCount = MAX_BENCH_MONITORS;
+        auto start = chrono::steady_clock::now();
+        enumerate(&info);
+        auto end = chrono::steady_clock::now();
+        samples.push_back(chrono::duration<double, micro>(end - start).count());
+        count = info.count;
+    }
+    sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main() {
+    Display* dpy = XOpenDisplay(nullptr);
+    if (dpy == nullptr) {
+        std::cout << "Cannot open display" << std::endl;
+        return 1;
+    }
+    Window root = DefaultRootWindow(dpy);
+
+    std::cout << "monitors  xlib_rt  xlib_us   xcb_rt  xcb_us" << std::endl;
+    for (int n = 1; n <= MAX_BENCH_MONITORS; n++) {
+        SetMonitors(dpy, root, n);
+        int xlibCount = 0, xcbCount = 0;
+        double xlibTime = TimeBackend(&rezol_x11_get_virtual_screens, xlibCount);
+        uint32_t xlibTrips = rezol_x11_last_round_trips();
+        double xcbTime = TimeBackend(&rezol_xcb_get_virtual_screens, xcbCount);
+        uint32_t xcbTrips = rezol_xcb_last_round_trips();
+        if (xlibCount != xcbCount) {
+            std::cout << "backends disagree at " << n << " monitors" << std::endl;
+        }
+        std::cout << setw(8) << xlibCount
+                  << setw(9) << xlibTrips << setw(9) << fixed << setprecision(1) << xlibTime
+                  << setw(9) << xcbTrips << setw(8) << xcbTime << std::endl;
+    }
+
+    SetMonitors(dpy, root, 0);
+    XCloseDisplay(dpy);
+    return 0;
+}
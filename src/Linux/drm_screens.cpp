@@ -0,0 +1,187 @@
+#include "linux_backends.h"
+#include "screen_backend.h"
+#include "screen_stats.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Sysfs root, overridable so the backend can be pointed at a fixture tree
+static string sysfsRoot;
+
+void rezol_drm_set_sysfs_root(const char* root) {
+    sysfsRoot = (root != nullptr) ? root : "";
+}
+
+static string GetSysfsRoot() {
+    if (!sysfsRoot.empty()) {
+        return sysfsRoot;
+    }
+    const char* env = getenv("GMS_SYSFS_ROOT");
+    return (env != nullptr && *env != '\0') ? env : "/sys";
+}
+
+// Read a whole sysfs attribute into buf, returns bytes read or -1
+static ssize_t ReadSysfsFile(const string& path, void* buf, size_t size) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = read(fd, static_cast<char*>(buf) + total, size - total);
+        if (n <= 0) {
+            break;
+        }
+        total += n;
+    }
+    close(fd);
+    return total;
+}
+
+// Read a one-line text attribute such as "connected\n"
+static bool ReadSysfsLine(const string& path, char* buf, size_t size) {
+    ssize_t n = ReadSysfsFile(path, buf, size - 1);
+    if (n < 0) {
+        return false;
+    }
+    buf[n] = '\0';
+    char* nl = strchr(buf, '\n');
+    if (nl) {
+        *nl = '\0';
+    }
+    return true;
+}
+
+// Connectors are named card<N>-<type>-<index>, e.g. card0-HDMI-A-1
+static bool IsConnectorName(const char* name) {
+    if (strncmp(name, "card", 4) != 0) {
+        return false;
+    }
+    const char* p = name + 4;
+    if (*p < '0' || *p > '9') {
+        return false;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    return *p == '-';
+}
+
+static bool IsInternalPanel(const string& connector) {
+    return connector.find("-eDP-") != string::npos ||
+           connector.find("-LVDS-") != string::npos ||
+           connector.find("-DSI-") != string::npos;
+}
+
+// First entry in modes is the preferred mode, e.g. "1920x1080"
+static bool ReadPreferredMode(const string& base, int32_t& width, int32_t& height) {
+    REZOL_STAT_SCOPE(STAT_MODES);
+    char line[128];
+    return ReadSysfsLine(base + "modes", line, sizeof(line)) && sscanf(line, "%dx%d", &width, &height) == 2;
+}
+
+// The EDID is where both the name and the physical size come from
+static bool ReadEDID(const string& base, EDIDInfo& edidInfo) {
+    REZOL_STAT_SCOPE(STAT_NAMES);
+    unsigned char edid[1024];
+    ssize_t edidSize = ReadSysfsFile(base + "edid", edid, sizeof(edid));
+    return edidSize > 0 && rezol_edid_parse_cached(edid, edidSize, edidInfo);
+}
+
+// --- Enumeration ---
+
+int32_t rezol_drm_get_virtual_screens(ScreenInfo* info) {
+    string drmDir = GetSysfsRoot() + "/class/drm";
+    DIR* dir = opendir(drmDir.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+
+    vector<string> connectors;
+    while (struct dirent* entry = readdir(dir)) {
+        if (IsConnectorName(entry->d_name)) {
+            connectors.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    // readdir order is arbitrary, keep the result stable between calls
+    sort(connectors.begin(), connectors.end(), [](const string& a, const string& b) {
+        return strverscmp(a.c_str(), b.c_str()) < 0;
+    });
+
+    info->autoHideTaskbar = 0;
+
+    int32_t nextLeft = 0;
+    int32_t primary = -1;
+    char line[128];
+    EDIDInfo edidInfo;
+
+    for (const string& connector : connectors) {
+        string base = drmDir + "/" + connector + "/";
+
+        if (!ReadSysfsLine(base + "status", line, sizeof(line)) || strcmp(line, "connected") != 0) {
+            continue;
+        }
+        // A connected output without a CRTC is not part of the desktop
+        if (ReadSysfsLine(base + "enabled", line, sizeof(line)) && strcmp(line, "disabled") == 0) {
+            continue;
+        }
+
+        PhysicalScreen screen = {};
+
+        int32_t width = 0, height = 0;
+        if (ReadPreferredMode(base, width, height)) {
+            screen.pixelBox = { width, height };
+        } else {
+            screen.errorCode |= 2;
+            screen.pixelBox = { 0, 0 };
+        }
+
+        // sysfs has no desktop layout, so place outputs side by side
+        screen.virtualRect = { nextLeft, 0, nextLeft + screen.pixelBox.width, screen.pixelBox.height };
+        screen.workingRect = screen.virtualRect;
+        nextLeft += screen.pixelBox.width;
+
+        bool haveEdid = ReadEDID(base, edidInfo);
+
+        if (haveEdid) {
+            screen.physSize = MakePhysicalSize(edidInfo.widthMM, edidInfo.heightMM);
+            screen.refreshRate = rezol_edid_refresh_rate(edidInfo, screen.pixelBox.width, screen.pixelBox.height);
+        } else {
+            screen.errorCode |= 4;
+            screen.physSize = { 0, 0, 0 };
+        }
+        // No display server, so nothing is scaled
+        SetScreenDPI(screen, 1);
+
+        if (haveEdid && edidInfo.name[0] != '\0') {
+            SetScreenName(screen, edidInfo.name);
+        } else {
+            // Fall back to the connector name without the card prefix
+            screen.errorCode |= 8;
+            SetScreenName(screen, connector.c_str() + connector.find('-') + 1);
+        }
+
+        if (!rezol_add_screen(info, screen)) {
+            break;
+        }
+
+        if (primary < 0 && IsInternalPanel(connector)) {
+            primary = info->count - 1;
+        }
+    }
+
+    if (info->count > 0) {
+        info->screen[primary >= 0 ? primary : 0].isPrimary = 1;
+    }
+
+    return 1;
+}
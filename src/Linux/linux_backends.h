@@ -0,0 +1,250 @@
+#ifndef LINUX_BACKENDS_H
+#define LINUX_BACKENDS_H
+
+#include "screen_utils.h"
+#include "edid.h"
+#include <math.h>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+// Each Linux backend fills a ScreenInfo the same way MonitorEnum does on
+// Windows. linux_screens.cpp picks one of them at runtime.
+
+// --- DRM / sysfs (drm_screens.cpp) ---
+
+// Reads /sys/class/drm/card*-*/{status,enabled,modes,edid}. Needs no
+// display server connection so it is safe to call during boot.
+int32_t rezol_drm_get_virtual_screens(ScreenInfo* info);
+
+// Point the DRM backend at a different sysfs root (default "/sys", or the
+// GMS_SYSFS_ROOT environment variable). Pass nullptr to restore the default.
+void rezol_drm_set_sysfs_root(const char* root);
+
+// --- X11 RandR (x11_screens.cpp, only built when Xrandr is available) ---
+
+// Uses the non-probing XRRGetScreenResourcesCurrent/XRRGetMonitors calls,
+// falling back to Xinerama and then to the core protocol screen size.
+int32_t rezol_x11_get_virtual_screens(ScreenInfo* info);
+
+// Number of blocking X round trips the last enumeration made, for comparing
+// the Xlib and XCB backends
+uint32_t rezol_x11_last_round_trips();
+
+// Outer and inner rects of a window from its geometry and
+// _NET_FRAME_EXTENTS (x11_chrome.cpp). Answers are cached per window and
+// only re-read after the server reports a change, so repeat calls make no
+// round trips. Returns non-zero on success.
+int32_t rezol_x11_get_window_chrome(uintptr_t window, WindowChrome* chrome);
+uint32_t rezol_x11_last_chrome_round_trips();
+
+// --- XCB RandR (xcb_screens.cpp, only built when xcb-randr is available) ---
+
+// Same result as the X11 backend, but every request of a stage is sent
+// before any reply is read, so the cost is a fixed number of round trips
+// however many monitors there are.
+int32_t rezol_xcb_get_virtual_screens(ScreenInfo* info);
+uint32_t rezol_xcb_last_round_trips();
+
+// --- Panel struts (xcb_struts.cpp, only built when xcb is available) ---
+
+struct PanelStrut;
+
+// Struts of every dock window (_NET_WM_WINDOW_TYPE_DOCK), kept up to date
+// from property events on a connection of our own, so a query only reads
+// what changed since the last one. autoHide is set when a dock reserves no
+// space, which is how auto-hiding panels behave. Returns false without a
+// window manager that publishes _NET_CLIENT_LIST.
+bool rezol_x11_get_panel_struts(std::vector<PanelStrut>& struts, int32_t& autoHide);
+uint32_t rezol_x11_last_strut_round_trips();
+
+// Replace every workingRect in a complete enumeration with the monitor
+// minus the struts that reach into it, and set autoHideTaskbar. Leaves
+// info alone when there are no struts to go on.
+void rezol_x11_apply_panel_struts(ScreenInfo* info);
+
+// Watch the X server on a background thread, calling onChange once per
+// burst of panel, RandR (mode, position, rotation, primary, outputs) or
+// Xft.dpi changes. Stopping also closes the connection.
+bool rezol_x11_watch_start(void (*onChange)());
+void rezol_x11_watch_stop();
+
+// --- Wayland (wayland_screens.cpp, only built when wayland-client is available) ---
+
+// Binds every wl_output and zxdg_output_manager_v1 and reads the logical
+// layout, current mode and physical size of each output in a single
+// round trip batch. Logical geometry is correct under fractional scaling,
+// unlike what XWayland reports to the X11 backends.
+int32_t rezol_wayland_get_virtual_screens(ScreenInfo* info);
+
+// Keep a connection open on a background thread and call onChange once
+// per burst of outputs being added, removed or changing mode, scale,
+// transform or position
+bool rezol_wayland_watch_start(void (*onChange)());
+void rezol_wayland_watch_stop();
+
+// --- Hotplug watcher (uevent_watch.cpp) ---
+
+// Kernel uevent socket subscribed to the kernel multicast group, or -1
+int rezol_uevent_open_netlink();
+
+// Watch fd for uevents on a background thread, calling onChange once per
+// burst that contains a drm add/change/remove. Takes ownership of fd, which
+// may be any datagram socket so tests can feed it from a socketpair.
+// Returns true if a watcher is running afterwards.
+bool rezol_uevent_watch_start(int fd, void (*onChange)());
+
+// Wake the thread, join it and close the socket
+void rezol_uevent_watch_stop();
+
+// True for a kernel "ACTION@DEVPATH\0KEY=VALUE\0..." message with
+// SUBSYSTEM=drm and ACTION=change/add/remove
+bool rezol_uevent_is_drm_change(const char* msg, size_t length);
+
+// --- Helpers shared by the backends ---
+
+// How much of the RandR EDID property to fetch, in 32 bit units: the base
+// block and up to three extensions
+constexpr long EDID_PROPERTY_LONGS = (4 * EDID_BLOCK_SIZE) / sizeof(uint32_t);
+
+// Physical size in mm with the diagonal worked out the same way as Windows
+inline PhysicalSize MakePhysicalSize(int32_t width, int32_t height) {
+    PhysicalSize size;
+    size.width = width;
+    size.height = height;
+    size.diagonal = lround(sqrt((height * height) + (width * width)));
+    return size;
+}
+
+// Native pixels per inch along one axis, 0 if the size is unknown
+inline int32_t RawDPI(int32_t pixels, int32_t mm) {
+    return (pixels > 0 && mm > 0) ? (int32_t)lround(pixels * 25.4 / mm) : 0;
+}
+
+// Fill the DPI fields once pixelBox and physSize are set. scale is what the
+// desktop renders at, 1 for 96 dpi; anything not positive counts as 1.
+inline void SetScreenDPI(PhysicalScreen& screen, double scale) {
+    if (!(scale > 0)) {
+        scale = 1;
+    }
+    int32_t effective = (int32_t)lround(96 * scale);
+    screen.dpi = { effective, effective, RawDPI(screen.pixelBox.width, screen.physSize.width),
+                   RawDPI(screen.pixelBox.height, screen.physSize.height) };
+    screen.scale = scale;
+}
+
+// Xft.dpi from an X resource database string (the root window's
+// RESOURCE_MANAGER property), 0 if it is not set. It is what GTK, Qt and
+// the desktop scale settings agree on under X11, which has no per-monitor
+// scale of its own.
+inline double XftDPI(const char* resources, size_t length) {
+    static const char key[] = "Xft.dpi";
+    const char* end = resources + length;
+    for (const char* line = resources; line < end;) {
+        const char* next = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        next = next ? next + 1 : end;
+        while (line < next && (*line == ' ' || *line == '\t')) {
+            line++;
+        }
+        if ((size_t)(next - line) > sizeof(key) - 1 && std::memcmp(line, key, sizeof(key) - 1) == 0) {
+            const char* p = line + sizeof(key) - 1;
+            while (p < next && (*p == ' ' || *p == '\t')) {
+                p++;
+            }
+            if (p < next && *p == ':') {
+                char value[32] = {};
+                std::memcpy(value, p + 1, std::min<size_t>(next - p - 1, sizeof(value) - 1));
+                double dpi = std::strtod(value, nullptr);
+                return dpi > 0 ? dpi : 0;
+            }
+        }
+        line = next;
+    }
+    return 0;
+}
+
+// Copy a (not necessarily terminated) name into the record
+inline void SetScreenName(PhysicalScreen& screen, const char* name, size_t length) {
+    length = std::min(length, MONITOR_NAME_BUFFER_SIZE - 1);
+    std::memcpy(screen.name, name, length);
+    screen.name[length] = '\0';
+}
+
+inline void SetScreenName(PhysicalScreen& screen, const char* name) {
+    SetScreenName(screen, name, std::strlen(name));
+}
+
+// Clip a monitor to the desktop-wide work area, keeping the monitor rect
+// when they do not overlap
+inline GMSRect ClipToWorkArea(const GMSRect& monitor, const GMSRect& workArea) {
+    GMSRect r = { std::max(monitor.left, workArea.left), std::max(monitor.top, workArea.top),
+                  std::min(monitor.right, workArea.right), std::min(monitor.bottom, workArea.bottom) };
+    if (r.right <= r.left || r.bottom <= r.top) {
+        return monitor;
+    }
+    return r;
+}
+
+// A dock's _NET_WM_STRUT_PARTIAL, in the order EWMH lays it out: how far
+// the panel reaches in from each edge of the root window, then the span
+// along that edge it covers (inclusive). A plain _NET_WM_STRUT covers its
+// whole edge.
+struct PanelStrut {
+    int32_t left, right, top, bottom;
+    int32_t leftStartY, leftEndY;
+    int32_t rightStartY, rightEndY;
+    int32_t topStartX, topEndX;
+    int32_t bottomStartX, bottomEndX;
+};
+
+// A monitor's work area with every strut that reaches into it taken off.
+// A strut only counts where its span runs alongside the monitor, and not
+// where it would swallow the monitor whole: that is a panel on the inner
+// edge of the next monitor, which a root-relative strut cannot describe.
+// Struts are relative to the root window, which spans (0, 0) to
+// (rootWidth, rootHeight). Keeps the monitor rect if nothing would be left.
+inline GMSRect StrutWorkArea(const GMSRect& monitor, int32_t rootWidth, int32_t rootHeight,
+                             const PanelStrut* struts, size_t count) {
+    GMSRect r = monitor;
+    for (size_t i = 0; i < count; i++) {
+        const PanelStrut& s = struts[i];
+        if (s.left > monitor.left && s.left < monitor.right &&
+            s.leftStartY < monitor.bottom && s.leftEndY >= monitor.top) {
+            r.left = std::max(r.left, s.left);
+        }
+        if (s.right > 0 && rootWidth - s.right < monitor.right && rootWidth - s.right > monitor.left &&
+            s.rightStartY < monitor.bottom && s.rightEndY >= monitor.top) {
+            r.right = std::min(r.right, rootWidth - s.right);
+        }
+        if (s.top > monitor.top && s.top < monitor.bottom &&
+            s.topStartX < monitor.right && s.topEndX >= monitor.left) {
+            r.top = std::max(r.top, s.top);
+        }
+        if (s.bottom > 0 && rootHeight - s.bottom < monitor.bottom && rootHeight - s.bottom > monitor.top &&
+            s.bottomStartX < monitor.right && s.bottomEndX >= monitor.left) {
+            r.bottom = std::min(r.bottom, rootHeight - s.bottom);
+        }
+    }
+    if (r.right <= r.left || r.bottom <= r.top) {
+        return monitor;
+    }
+    return r;
+}
+
+// Vertical refresh in Hz from RandR mode timings
+inline int32_t ModeRefreshRate(double dotClock, uint32_t hTotal, uint32_t vTotal, bool doubleScan, bool interlace) {
+    double lines = vTotal;
+    if (doubleScan) {
+        lines *= 2;
+    }
+    if (interlace) {
+        lines /= 2;
+    }
+    if (hTotal == 0 || lines == 0) {
+        return 0;
+    }
+    return (int32_t)lround(dotClock / (hTotal * lines));
+}
+
+#endif // LINUX_BACKENDS_H
@@ -0,0 +1,127 @@
+#include "linux_backends.h"
+#include "screen_backend.h"
+#include <cstdlib>
+#include <cstring>
+
+// Backends in order of preference. The first one that is usable and
+// succeeds wins, unless GMS_SCREEN_BACKEND names a specific one.
+struct LinuxScreenBackend {
+    const char* name;
+    bool (*usable)();
+    int32_t (*enumerate)(ScreenInfo* info);
+    bool (*watch)(void (*onChange)());  // nullptr when changes cannot be seen
+};
+
+static bool AlwaysUsable() {
+    return true;
+}
+
+#ifdef GMS_HAVE_WAYLAND
+static bool HaveWaylandDisplay() {
+    const char* display = getenv("WAYLAND_DISPLAY");
+    return display != nullptr && *display != '\0';
+}
+#endif
+
+#if defined(GMS_HAVE_X11) || defined(GMS_HAVE_XCB)
+static bool HaveX11Display() {
+    const char* display = getenv("DISPLAY");
+    return display != nullptr && *display != '\0';
+}
+#endif
+
+// Outputs on a bare drm device come and go through the kernel's uevents.
+// Without netlink (some sandboxes) every query enumerates again.
+static bool WatchUevents(void (*onChange)()) {
+    return rezol_uevent_watch_start(rezol_uevent_open_netlink(), onChange);
+}
+
+// A display server changes modes, positions and scales without any
+// uevent, so those backends watch the server itself. The X watcher is
+// built on XCB, an Xlib-only build has none.
+static const LinuxScreenBackend backends[] = {
+#ifdef GMS_HAVE_WAYLAND
+    { "wayland", &HaveWaylandDisplay, &rezol_wayland_get_virtual_screens, &rezol_wayland_watch_start },
+#endif
+#ifdef GMS_HAVE_XCB
+    { "xcb", &HaveX11Display, &rezol_xcb_get_virtual_screens, &rezol_x11_watch_start },
+#endif
+#ifdef GMS_HAVE_X11
+#ifdef GMS_HAVE_XCB
+    { "x11", &HaveX11Display, &rezol_x11_get_virtual_screens, &rezol_x11_watch_start },
+#else
+    { "x11", &HaveX11Display, &rezol_x11_get_virtual_screens, nullptr },
+#endif
+#endif
+    { "drm", &AlwaysUsable, &rezol_drm_get_virtual_screens, &WatchUevents },
+};
+
+// The backend GMS_SCREEN_BACKEND names, or else the first usable one
+static const LinuxScreenBackend* PreferredBackend() {
+    const char* wanted = getenv("GMS_SCREEN_BACKEND");
+    for (const LinuxScreenBackend& backend : backends) {
+        if ((wanted != nullptr && *wanted != '\0') ? strcmp(wanted, backend.name) == 0 : backend.usable()) {
+            return &backend;
+        }
+    }
+    return nullptr;
+}
+
+int32_t rezol_platform_get_virtual_screens(ScreenInfo* info) {
+    const char* wanted = getenv("GMS_SCREEN_BACKEND");
+    if (wanted != nullptr && *wanted == '\0') {
+        wanted = nullptr;
+    }
+
+    for (const LinuxScreenBackend& backend : backends) {
+        if (wanted != nullptr) {
+            if (strcmp(wanted, backend.name) == 0) {
+                return backend.enumerate(info);
+            }
+            continue;
+        }
+        if (backend.usable()) {
+            int32_t result = backend.enumerate(info);
+            if (result) {
+                return result;
+            }
+            // Discard anything a failed backend left behind
+            info->count = 0;
+            info->more = false;
+        }
+    }
+
+    return 0;
+}
+
+// Only X11 has frame extents to read. Wayland clients draw their own
+// decorations and cannot learn where they are on the desktop.
+int32_t rezol_platform_get_window_chrome(uintptr_t window, WindowChrome* chrome) {
+#ifdef GMS_HAVE_X11
+    if (HaveX11Display()) {
+        return rezol_x11_get_window_chrome(window, chrome);
+    }
+#else
+    (void)window;
+    (void)chrome;
+#endif
+    return 0;
+}
+
+// Watch with whatever the backend queries will use. When it has no
+// watcher, or it cannot start, report that so every query enumerates
+// rather than serving a snapshot nothing will ever invalidate.
+bool rezol_platform_watch_start(void (*onChange)()) {
+    const LinuxScreenBackend* backend = PreferredBackend();
+    return backend != nullptr && backend->watch != nullptr && backend->watch(onChange);
+}
+
+void rezol_platform_watch_stop() {
+#ifdef GMS_HAVE_WAYLAND
+    rezol_wayland_watch_stop();
+#endif
+#ifdef GMS_HAVE_XCB
+    rezol_x11_watch_stop();
+#endif
+    rezol_uevent_watch_stop();
+}
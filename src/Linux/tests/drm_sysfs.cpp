@@ -0,0 +1,150 @@
+// Builds a fake /sys/class/drm tree and checks the DRM backend reads it
+// the way MonitorEnum reports the same monitors on Windows.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "screen_utils.h"
+#include "linux_backends.h"
+#include "screen_stats.h"
+#include "tests/edid_blobs.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static void WriteFile(const string& path, const void* data, size_t size) {
+    ofstream out(path, ios::binary);
+    out.write(static_cast<const char*>(data), size);
+}
+
+static void WriteFile(const string& path, const string& text) {
+    WriteFile(path, text.data(), text.size());
+}
+
+static void MakeConnector(const string& drm, const string& name, const char* status,
+                          const char* enabled, const char* modes, const vector<unsigned char>& edid) {
+    string dir = drm + "/" + name;
+    mkdir(dir.c_str(), 0755);
+    WriteFile(dir + "/status", string(status) + "\n");
+    WriteFile(dir + "/enabled", string(enabled) + "\n");
+    WriteFile(dir + "/modes", modes);
+    WriteFile(dir + "/edid", edid.data(), edid.size());
+}
+
+int main() {
+    char root[] = "/tmp/gms_drm_XXXXXX";
+    if (mkdtemp(root) == nullptr) {
+        std::cout << "mkdtemp failed" << std::endl;
+        return 1;
+    }
+    string drm = string(root) + "/class";
+    mkdir(drm.c_str(), 0755);
+    drm += "/drm";
+    mkdir(drm.c_str(), 0755);
+    mkdir((drm + "/card0").c_str(), 0755); // the card itself is not a connector
+    WriteFile(drm + "/version", "drm 1.1.0 20060810\n");
+
+    MakeConnector(drm, "card0-HDMI-A-1", "connected", "enabled", "1920x1080\n1280x720\n",
+                  MakeEDID(1920, 1080, 280, 45, 14850, 527, 296, "DELL U2419H"));
+    MakeConnector(drm, "card0-eDP-1", "connected", "enabled", "2560x1600\n",
+                  MakeEDID(2560, 1600, 160, 46, 26850, 302, 189, nullptr));
+    MakeConnector(drm, "card0-DP-2", "disconnected", "disabled", "", {});
+    MakeConnector(drm, "card0-DP-10", "connected", "enabled", "3840x2160\n", {});
+
+    rezol_drm_set_sysfs_root(root);
+    rezol_edid_cache_clear();
+
+    PhysicalScreen screenArray[SCREENS_PER_PAGE];
+    ScreenInfo info = {};
+    info.screen = screenArray;
+    info.count = 0;
+    info.maxCount = SCREENS_PER_PAGE;
+    info.more = false;
+
+    StageStats before[STAT_STAGE_COUNT];
+    bool timed = rezol_stats_read(before);
+    CHECK(rezol_drm_get_virtual_screens(&info) != 0);
+    CHECK(info.count == 3);
+    CHECK(!info.more);
+
+    // One mode and one EDID read per connected output, when timed at all
+    if (timed) {
+        StageStats after[STAT_STAGE_COUNT];
+        rezol_stats_read(after);
+        CHECK(after[STAT_MODES].calls == before[STAT_MODES].calls + 3);
+        CHECK(after[STAT_NAMES].calls == before[STAT_NAMES].calls + 3);
+        CHECK(after[STAT_PHYSSIZE].calls == before[STAT_PHYSSIZE].calls);
+    }
+
+    // Sorted card0-DP-10, card0-HDMI-A-1, card0-eDP-1
+    if (info.count == 3) {
+        const PhysicalScreen& dp = info.screen[0];
+        CHECK(strcmp(dp.name, "DP-10") == 0);
+        CHECK((dp.errorCode & 4) && (dp.errorCode & 8));
+        CHECK(dp.pixelBox.width == 3840 && dp.pixelBox.height == 2160);
+        CHECK(dp.virtualRect.left == 0 && dp.virtualRect.right == 3840);
+        CHECK(!dp.isPrimary);
+        CHECK(dp.dpi.rawX == 0 && dp.dpi.effectiveX == 96 && dp.scale == 1);
+
+        const PhysicalScreen& hdmi = info.screen[1];
+        CHECK(strcmp(hdmi.name, "DELL U2419H") == 0);
+        CHECK(hdmi.errorCode == 0);
+        CHECK(hdmi.refreshRate == 60);
+        CHECK(hdmi.physSize.width == 527 && hdmi.physSize.height == 296);
+        CHECK(hdmi.physSize.diagonal == 604);
+        CHECK(hdmi.virtualRect.left == 3840 && hdmi.virtualRect.bottom == 1080);
+        CHECK(hdmi.dpi.rawX == 93 && hdmi.dpi.rawY == 93);
+
+        const PhysicalScreen& edp = info.screen[2];
+        CHECK(strcmp(edp.name, "eDP-1") == 0);
+        CHECK(edp.errorCode == 8);
+        CHECK(edp.isPrimary);
+        CHECK(edp.refreshRate == 60);
+        CHECK(edp.dpi.rawX == 215 && edp.dpi.effectiveY == 96);
+    }
+
+    // Both EDIDs were parsed once. Enumerating again parses nothing, and
+    // after swapping the HDMI monitor only the new one is parsed.
+    EDIDCacheStats stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 2 && stats.hits == 0);
+    info.count = 0;
+    CHECK(rezol_drm_get_virtual_screens(&info) != 0);
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 2 && stats.hits == 2);
+
+    EDIDBlob swapped = MakeEDID(2560, 1440, 160, 41, 24150, 597, 336, "DELL U2723QE");
+    WriteFile(drm + "/card0-HDMI-A-1/edid", swapped.data(), swapped.size());
+    info.count = 0;
+    CHECK(rezol_drm_get_virtual_screens(&info) != 0);
+    stats = rezol_edid_cache_stats();
+    CHECK(stats.misses == 3 && stats.hits == 3);
+    CHECK(info.count == 3 && strcmp(info.screen[1].name, "DELL U2723QE") == 0);
+    CHECK(rezol_ext_get_edid_cache_misses() == 3);
+
+    // Same topology through the GML entry point
+    setenv("GMS_SCREEN_BACKEND", "drm", 1);
+    size_t bufSize = rezol_ext_get_buffer_size(SCREENINFO);
+    vector<char> gmlBuf(bufSize, 0);
+    char address[32];
+    snprintf(address, sizeof(address), "%p", (void*)gmlBuf.data());
+    CHECK(rezol_ext_get_screen_info(address) == 0);
+    int32_t count;
+    memcpy(&count, gmlBuf.data(), sizeof(count));
+    CHECK(count == 3);
+
+    // A missing tree fails cleanly
+    rezol_drm_set_sysfs_root("/nonexistent");
+    info.count = 0;
+    CHECK(rezol_drm_get_virtual_screens(&info) == 0);
+
+    string cleanup = string("rm -rf ") + root;
+    if (system(cleanup.c_str()) != 0) {
+        std::cout << "cleanup of " << root << " failed" << std::endl;
+    }
+
+    return TestResult();
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Run a test against a private headless Weston compositor.
+# Usage: run_weston.sh <path to weston> <test program> [args...]
+WESTON="$1"
+shift
+
+# Weston needs a runtime dir for its socket
+if [ -z "$XDG_RUNTIME_DIR" ]; then
+    XDG_RUNTIME_DIR=$(mktemp -d)
+    chmod 700 "$XDG_RUNTIME_DIR"
+    export XDG_RUNTIME_DIR
+    ownruntime=1
+fi
+
+socket="gms-test-$$"
+"$WESTON" --backend=headless-backend.so --socket="$socket" --width=1920 --height=1080 \
+    --idle-time=0 >/dev/null 2>&1 &
+westonpid=$!
+
+tries=0
+while [ ! -S "$XDG_RUNTIME_DIR/$socket" ] && [ $tries -lt 100 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+if [ ! -S "$XDG_RUNTIME_DIR/$socket" ]; then
+    echo "weston did not start"
+    kill $westonpid 2>/dev/null
+    exit 1
+fi
+
+WAYLAND_DISPLAY="$socket"
+export WAYLAND_DISPLAY
+"$@"
+status=$?
+
+kill $westonpid 2>/dev/null
+wait $westonpid 2>/dev/null
+if [ -n "$ownruntime" ]; then
+    rm -rf "$XDG_RUNTIME_DIR"
+fi
+exit $status
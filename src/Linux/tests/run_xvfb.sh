@@ -0,0 +1,32 @@
+#!/bin/sh
+# Run a test against a private headless X server.
+# Usage: run_xvfb.sh <path to Xvfb> <test program> [args...]
+XVFB="$1"
+shift
+
+displayfile=$(mktemp)
+"$XVFB" -displayfd 3 -screen 0 5760x1080x24 -nolisten tcp 3>"$displayfile" 2>/dev/null &
+xvfbpid=$!
+
+# Xvfb writes the display number it picked once it is ready
+tries=0
+while [ ! -s "$displayfile" ] && [ $tries -lt 100 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+if [ ! -s "$displayfile" ]; then
+    echo "Xvfb did not start"
+    kill $xvfbpid 2>/dev/null
+    rm -f "$displayfile"
+    exit 1
+fi
+
+DISPLAY=":$(cat "$displayfile")"
+export DISPLAY
+"$@"
+status=$?
+
+kill $xvfbpid 2>/dev/null
+wait $xvfbpid 2>/dev/null
+rm -f "$displayfile"
+exit $status
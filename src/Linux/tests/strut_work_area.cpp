@@ -0,0 +1,74 @@
+// Checks per-monitor work areas worked out from panel struts: a panel only
+// takes space from the monitors it runs alongside, struts are measured from
+// the root window's edges, and monitors shorter than the root still lose
+// the right amount.
+#include <climits>
+#include <cstring>
+#include <vector>
+#include "screen_utils.h"
+#include "linux_backends.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static bool Same(const GMSRect& a, const GMSRect& b) {
+    return memcmp(&a, &b, sizeof(GMSRect)) == 0;
+}
+
+static PanelStrut Strut(int32_t left, int32_t right, int32_t top, int32_t bottom) {
+    PanelStrut s = { left, right, top, bottom, 0, INT_MAX, 0, INT_MAX, 0, INT_MAX, 0, INT_MAX };
+    return s;
+}
+
+int main() {
+    // Three 1080p monitors side by side
+    const GMSRect left = { 0, 0, 1920, 1080 };
+    const GMSRect middle = { 1920, 0, 3840, 1080 };
+    const GMSRect right = { 3840, 0, 5760, 1080 };
+
+    // No panels
+    CHECK(Same(StrutWorkArea(middle, 5760, 1080, nullptr, 0), middle));
+
+    // A taskbar along the bottom of the middle monitor only
+    PanelStrut taskbar = Strut(0, 0, 0, 40);
+    taskbar.bottomStartX = 1920;
+    taskbar.bottomEndX = 3839;
+    CHECK(Same(StrutWorkArea(left, 5760, 1080, &taskbar, 1), left));
+    CHECK(Same(StrutWorkArea(middle, 5760, 1080, &taskbar, 1), { 1920, 0, 3840, 1040 }));
+    CHECK(Same(StrutWorkArea(right, 5760, 1080, &taskbar, 1), right));
+
+    // A dock down the left of the desktop and one down the right, plus a
+    // top bar across everything given as a plain _NET_WM_STRUT
+    vector<PanelStrut> panels = { Strut(48, 0, 0, 0), Strut(0, 64, 0, 0), Strut(0, 0, 28, 0), taskbar };
+    panels[0].leftEndY = 1079;
+    panels[1].rightEndY = 1079;
+    CHECK(Same(StrutWorkArea(left, 5760, 1080, panels.data(), panels.size()), { 48, 28, 1920, 1080 }));
+    CHECK(Same(StrutWorkArea(middle, 5760, 1080, panels.data(), panels.size()), { 1920, 28, 3840, 1040 }));
+    CHECK(Same(StrutWorkArea(right, 5760, 1080, panels.data(), panels.size()), { 3840, 28, 5696, 1080 }));
+
+    // A 1200 line monitor next to a 1080 one makes the root 1200 high, so a
+    // panel on the bottom of the short monitor reaches up 120 + 40
+    const GMSRect tall = { 0, 0, 1920, 1200 };
+    const GMSRect shorter = { 1920, 0, 3840, 1080 };
+    PanelStrut raised = Strut(0, 0, 0, 160);
+    raised.bottomStartX = 1920;
+    raised.bottomEndX = 3839;
+    CHECK(Same(StrutWorkArea(tall, 3840, 1200, &raised, 1), tall));
+    CHECK(Same(StrutWorkArea(shorter, 3840, 1200, &raised, 1), { 1920, 0, 3840, 1040 }));
+
+    // A panel on the left edge of the second monitor reaches across the
+    // whole first one, which keeps its space
+    PanelStrut inner = Strut(1920 + 48, 0, 0, 0);
+    inner.leftEndY = 1079;
+    CHECK(Same(StrutWorkArea(left, 5760, 1080, &inner, 1), left));
+    CHECK(Same(StrutWorkArea(middle, 5760, 1080, &inner, 1), { 1968, 0, 3840, 1080 }));
+
+    // A panel alongside a different part of the edge does not count
+    PanelStrut lower = Strut(48, 0, 0, 0);
+    lower.leftStartY = 1080;
+    lower.leftEndY = 2159;
+    CHECK(Same(StrutWorkArea(left, 5760, 2160, &lower, 1), left));
+    CHECK(Same(StrutWorkArea({ 0, 1080, 1920, 2160 }, 5760, 2160, &lower, 1), { 48, 1080, 1920, 2160 }));
+
+    return TestResult();
+}
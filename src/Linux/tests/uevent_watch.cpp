@@ -0,0 +1,159 @@
+// Feeds synthetic kernel uevents through a socketpair and checks the
+// watcher only invalidates the cached topology for drm ones.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "screen_utils.h"
+#include "screen_topology.h"
+#include "linux_backends.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static atomic<int> wakeups(0);
+
+static void OnChange() {
+    wakeups++;
+    rezol_topology_invalidate();
+}
+
+static bool WaitForWakeups(int expected) {
+    for (int i = 0; i < 200 && wakeups < expected; i++) {
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    return wakeups == expected;
+}
+
+// Kernel format: "ACTION@DEVPATH" then NUL separated KEY=VALUE pairs
+static string MakeUevent(const char* action, const char* devpath, const char* subsystem) {
+    string msg = string(action) + "@" + devpath;
+    msg += '\0';
+    msg += string("ACTION=") + action + '\0';
+    msg += string("DEVPATH=") + devpath + '\0';
+    msg += string("SUBSYSTEM=") + subsystem + '\0';
+    msg += string("HOTPLUG=1") + '\0';
+    msg += string("SEQNUM=1234") + '\0';
+    return msg;
+}
+
+static void Send(int fd, const string& msg) {
+    if (send(fd, msg.data(), msg.size(), 0) != (ssize_t)msg.size()) {
+        std::cout << "send failed" << std::endl;
+    }
+}
+
+static void MakeConnector(const string& drm, const string& name, const char* modes) {
+    string dir = drm + "/" + name;
+    mkdir(dir.c_str(), 0755);
+    ofstream(dir + "/status") << "connected\n";
+    ofstream(dir + "/enabled") << "enabled\n";
+    ofstream(dir + "/modes") << modes;
+}
+
+int main() {
+    // Parser on its own
+    string change = MakeUevent("change", "/devices/pci0000:00/0000:00:02.0/drm/card0", "drm");
+    string add = MakeUevent("add", "/devices/pci0000:00/0000:00:02.0/drm/card1", "drm");
+    string usb = MakeUevent("change", "/devices/pci0000:00/usb1/1-1", "usb");
+    string bind = MakeUevent("bind", "/devices/pci0000:00/0000:00:02.0", "drm");
+    CHECK(rezol_uevent_is_drm_change(change.data(), change.size()));
+    CHECK(rezol_uevent_is_drm_change(add.data(), add.size()));
+    CHECK(!rezol_uevent_is_drm_change(usb.data(), usb.size()));
+    CHECK(!rezol_uevent_is_drm_change(bind.data(), bind.size()));
+    CHECK(!rezol_uevent_is_drm_change("libudev\0\xfe\xed\xca\xfe", 12));
+    // Truncated message without a trailing NUL
+    CHECK(!rezol_uevent_is_drm_change("change@/x\0SUBSYSTEM=dr", 22));
+
+    // Fake sysfs tree for the DRM backend to read
+    char root[] = "/tmp/gms_uevent_XXXXXX";
+    if (mkdtemp(root) == nullptr) {
+        std::cout << "mkdtemp failed" << std::endl;
+        return 1;
+    }
+    string drm = string(root) + "/class";
+    mkdir(drm.c_str(), 0755);
+    drm += "/drm";
+    mkdir(drm.c_str(), 0755);
+    MakeConnector(drm, "card0-HDMI-A-1", "1920x1080\n");
+    rezol_drm_set_sysfs_root(root);
+    setenv("GMS_SCREEN_BACKEND", "drm", 1);
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) != 0) {
+        std::cout << "socketpair failed" << std::endl;
+        return 1;
+    }
+
+    // Start our watcher before the topology's first query, which then finds
+    // one already running instead of opening the real netlink socket
+    CHECK(rezol_uevent_watch_start(sv[0], &OnChange));
+    CHECK(rezol_uevent_watch_start(-1, &OnChange)); // still running
+
+    TopologyRef first = rezol_topology_current();
+    CHECK(first->screens.size() == 1);
+
+    // Plug a second monitor in behind the library's back. Nothing is
+    // enumerated until a drm uevent says so.
+    MakeConnector(drm, "card0-DP-1", "2560x1440\n");
+    CHECK(rezol_topology_current() == first);
+
+    Send(sv[1], usb);
+    Send(sv[1], bind);
+    this_thread::sleep_for(chrono::milliseconds(50));
+    CHECK(wakeups == 0);
+    CHECK(rezol_topology_current() == first);
+
+    Send(sv[1], change);
+    CHECK(WaitForWakeups(1));
+    TopologyRef second = rezol_topology_current();
+    CHECK(second != first);
+    CHECK(second->screens.size() == 2);
+    CHECK(second->generation > first->generation);
+    CHECK(rezol_topology_current() == second);
+
+    // Stop joins the thread, later uevents are ignored
+    rezol_uevent_watch_stop();
+    Send(sv[1], change);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    CHECK(wakeups == 1);
+
+    // A new watcher can be started after a stop, and one that sees its
+    // socket closed ends by itself. Queries then enumerate every time
+    // instead of serving a snapshot nothing will invalidate any more.
+    int sv2[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv2) == 0) {
+        CHECK(rezol_uevent_watch_start(sv2[0], &OnChange));
+        Send(sv2[1], add);
+        CHECK(WaitForWakeups(2));
+        TopologyRef cached = rezol_topology_current();
+        CHECK(cached->screens.size() == 2);
+        MakeConnector(drm, "card0-DP-2", "1280x1024\n");
+        CHECK(rezol_topology_current() == cached);
+
+        close(sv2[1]);
+        bool enumerated = false;
+        for (int i = 0; i < 200 && !enumerated; i++) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+            enumerated = (rezol_topology_current()->screens.size() == 3);
+        }
+        CHECK(enumerated);
+        CHECK(wakeups == 2);
+        rezol_uevent_watch_stop();
+    }
+    close(sv[1]);
+
+    string cleanup = string("rm -rf ") + root;
+    if (system(cleanup.c_str()) != 0) {
+        std::cout << "cleanup of " << root << " failed" << std::endl;
+    }
+
+    return TestResult();
+}
@@ -0,0 +1,47 @@
+// Checks the Wayland backend and its watcher against a headless Weston
+// started by run_weston.sh with a single 1920x1080 output.
+#include <iostream>
+#include <cstring>
+#include "screen_utils.h"
+#include "linux_backends.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static int changes = 0;
+
+static void OnChange() {
+    changes++;
+}
+
+int main() {
+    PhysicalScreen screenArray[SCREENS_PER_PAGE];
+    ScreenInfo info = {};
+    info.screen = screenArray;
+    info.count = 0;
+    info.maxCount = SCREENS_PER_PAGE;
+    info.more = false;
+
+    CHECK(rezol_wayland_get_virtual_screens(&info) != 0);
+    CHECK(info.count == 1);
+
+    if (info.count == 1) {
+        const PhysicalScreen& s = info.screen[0];
+        CHECK(s.isPrimary);
+        CHECK(s.pixelBox.width == 1920 && s.pixelBox.height == 1080);
+        CHECK(s.virtualRect.left == 0 && s.virtualRect.top == 0);
+        CHECK(s.virtualRect.right == 1920 && s.virtualRect.bottom == 1080);
+        CHECK(s.refreshRate > 0);
+        CHECK(strlen(s.name) > 0);
+    }
+
+    // Weston adds no outputs here, but the watcher has to come up and go
+    // away cleanly
+    CHECK(rezol_wayland_watch_start(&OnChange));
+    CHECK(rezol_wayland_watch_start(&OnChange));
+    rezol_wayland_watch_stop();
+    rezol_wayland_watch_stop();
+    CHECK(changes == 0);
+
+    return TestResult();
+}
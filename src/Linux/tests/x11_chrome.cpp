@@ -0,0 +1,116 @@
+// Checks window chrome comes from the window geometry and the
+// _NET_FRAME_EXTENTS set on it, that repeat calls are served from the cache
+// with no round trips, and that property and configure events refresh it.
+// Xvfb runs no window manager, so the test plays one. Run through
+// run_xvfb.sh so DISPLAY is a private server.
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include "screen_utils.h"
+#include "linux_backends.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static void SetExtents(Display* dpy, Window window, long left, long right, long top, long bottom) {
+    long extents[4] = { left, right, top, bottom };
+    XChangeProperty(dpy, window, XInternAtom(dpy, "_NET_FRAME_EXTENTS", False), XA_CARDINAL, 32,
+                    PropModeReplace, (const unsigned char*)extents, 4);
+    XSync(dpy, False);
+}
+
+static bool Same(const GMSRect& a, const GMSRect& b) {
+    return memcmp(&a, &b, sizeof(GMSRect)) == 0;
+}
+
+// Events reach the library's own connection a moment after our XSync, so
+// poll until the chrome matches or give up after a second
+static bool WaitForChrome(Window window, const GMSRect& outer, const GMSRect& inner) {
+    for (int i = 0; i < 100; i++) {
+        WindowChrome chrome;
+        if (rezol_x11_get_window_chrome(window, &chrome) &&
+            Same(chrome.outerRect, outer) && Same(chrome.innerRect, inner)) {
+            return true;
+        }
+        usleep(10000);
+    }
+    return false;
+}
+
+int main() {
+    Display* dpy = XOpenDisplay(nullptr);
+    if (dpy == nullptr) {
+        printf("Cannot open display\n");
+        return 1;
+    }
+    Window root = DefaultRootWindow(dpy);
+    Window window = XCreateSimpleWindow(dpy, root, 100, 50, 800, 600, 0, 0, 0);
+    XMapWindow(dpy, window);
+    SetExtents(dpy, window, 4, 4, 30, 4);
+
+    // First call reads geometry and extents, the next ones are cached
+    WindowChrome chrome;
+    CHECK(rezol_x11_get_window_chrome(window, &chrome) != 0);
+    CHECK(Same(chrome.innerRect, { 100, 50, 900, 650 }));
+    CHECK(Same(chrome.outerRect, { 96, 20, 904, 654 }));
+    CHECK(chrome.fourcc == GMEX);
+    CHECK(rezol_x11_last_chrome_round_trips() > 0);
+    for (int i = 0; i < 10; i++) {
+        CHECK(rezol_x11_get_window_chrome(window, &chrome) != 0);
+        CHECK(rezol_x11_last_chrome_round_trips() == 0);
+    }
+
+    // A new frame only re-reads the property
+    SetExtents(dpy, window, 10, 10, 40, 10);
+    CHECK(WaitForChrome(window, { 90, 10, 910, 660 }, { 100, 50, 900, 650 }));
+    CHECK(rezol_x11_get_window_chrome(window, &chrome) != 0);
+    CHECK(rezol_x11_last_chrome_round_trips() == 0);
+
+    // Moved by the server, the geometry is read again
+    XMoveResizeWindow(dpy, window, 300, 200, 640, 480);
+    XSync(dpy, False);
+    CHECK(WaitForChrome(window, { 290, 160, 950, 690 }, { 300, 200, 940, 680 }));
+
+    // Moved by a window manager, which tells the client where it is in root
+    // coordinates. Nothing needs reading.
+    XEvent ev = {};
+    ev.xconfigure.type = ConfigureNotify;
+    ev.xconfigure.event = window;
+    ev.xconfigure.window = window;
+    ev.xconfigure.x = 500;
+    ev.xconfigure.y = 400;
+    ev.xconfigure.width = 640;
+    ev.xconfigure.height = 480;
+    XSendEvent(dpy, window, False, StructureNotifyMask, &ev);
+    XSync(dpy, False);
+    CHECK(WaitForChrome(window, { 490, 360, 1150, 890 }, { 500, 400, 1140, 880 }));
+    CHECK(rezol_x11_last_chrome_round_trips() == 0);
+
+    // Through the GML entry point, handle and buffer as pointer strings
+    char buf[sizeof(WindowChrome)] = {};
+    char address[32], handle[32];
+    snprintf(address, sizeof(address), "%p", (void*)buf);
+    snprintf(handle, sizeof(handle), "%lx", (unsigned long)window);
+    CHECK(rezol_ext_get_window_chrome(address, handle) == 0);
+    memcpy(&chrome, buf, sizeof(chrome));
+    CHECK(Same(chrome.innerRect, { 500, 400, 1140, 880 }));
+    CHECK(chrome.fourcc == GMEX);
+    CHECK(rezol_ext_get_window_chrome(address, (char*)"") == 1);
+
+    // Gone, and never a window
+    XDestroyWindow(dpy, window);
+    XSync(dpy, False);
+    bool gone = false;
+    for (int i = 0; i < 100 && !gone; i++) {
+        gone = rezol_x11_get_window_chrome(window, &chrome) == 0;
+        usleep(10000);
+    }
+    CHECK(gone);
+    CHECK(rezol_x11_get_window_chrome(0, &chrome) == 0);
+    CHECK(rezol_x11_get_window_chrome(0x7fffff, &chrome) == 0);
+
+    XCloseDisplay(dpy);
+    return TestResult();
+}
@@ -0,0 +1,138 @@
+// Splits an Xvfb screen into three RandR 1.5 monitors and checks the X11
+// backend reports them, and that the X watcher sees Xft.dpi and RandR
+// changes. Run through run_xvfb.sh so DISPLAY is a private server.
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xrandr.h>
+#include "screen_utils.h"
+#include "linux_backends.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static atomic<int> changes(0);
+
+static void OnChange() {
+    changes++;
+}
+
+static bool WaitForChange() {
+    for (int i = 0; i < 200 && changes == 0; i++) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    return changes.exchange(0) > 0;
+}
+
+static void SetMonitor(Display* dpy, Window root, const char* name, int x, int width,
+                       RROutput* output, bool primary) {
+    XRRMonitorInfo* mon = XRRAllocateMonitor(dpy, output ? 1 : 0);
+    mon->name = XInternAtom(dpy, name, False);
+    mon->primary = primary;
+    mon->x = x;
+    mon->y = 0;
+    mon->width = width;
+    mon->height = 1080;
+    mon->mwidth = width / 4;
+    mon->mheight = 270;
+    if (output) {
+        mon->outputs[0] = *output;
+    }
+    XRRSetMonitor(dpy, root, mon);
+    XRRFreeMonitors(mon);
+}
+
+int main() {
+    Display* dpy = XOpenDisplay(nullptr);
+    if (dpy == nullptr) {
+        std::cout << "Cannot open display" << std::endl;
+        return 1;
+    }
+    Window root = DefaultRootWindow(dpy);
+
+    XRRScreenResources* res = XRRGetScreenResourcesCurrent(dpy, root);
+    CHECK(res != nullptr && res->noutput > 0);
+    if (res == nullptr || res->noutput == 0) {
+        return 1;
+    }
+    RROutput output = res->outputs[0];
+
+    // The first monitor takes over Xvfb's only output, the others are virtual
+    SetMonitor(dpy, root, "LEFT", 0, 1920, &output, false);
+    SetMonitor(dpy, root, "MIDDLE", 1920, 1920, nullptr, true);
+    SetMonitor(dpy, root, "RIGHT", 3840, 1920, nullptr, false);
+    // A desktop set to 150%
+    const char* resources = "Xft.antialias:\t1\nXft.dpi:\t144\n";
+    XChangeProperty(dpy, root, XA_RESOURCE_MANAGER, XA_STRING, 8, PropModeReplace,
+                    (const unsigned char*)resources, strlen(resources));
+    XSync(dpy, False);
+
+    PhysicalScreen screenArray[SCREENS_PER_PAGE];
+    ScreenInfo info = {};
+    info.screen = screenArray;
+    info.count = 0;
+    info.maxCount = SCREENS_PER_PAGE;
+    info.more = false;
+
+    CHECK(rezol_x11_get_virtual_screens(&info) != 0);
+    CHECK(info.count == 3);
+
+    int primaries = 0;
+    for (int i = 0; i < info.count; i++) {
+        const PhysicalScreen& s = info.screen[i];
+        CHECK(s.virtualRect.bottom - s.virtualRect.top == 1080);
+        CHECK(s.virtualRect.right - s.virtualRect.left == 1920);
+        CHECK(s.physSize.width == 480 && s.physSize.height == 270);
+        CHECK(s.physSize.diagonal == 551);
+        CHECK(s.errorCode & 8); // Xvfb has no EDID
+        CHECK(s.dpi.effectiveX == 144 && s.dpi.effectiveY == 144 && s.scale == 1.5);
+        CHECK(s.dpi.rawX == 102 && s.dpi.rawY == 102);
+        if (s.isPrimary) {
+            primaries++;
+            CHECK(s.virtualRect.left == 1920);
+            CHECK(strcmp(s.name, "MIDDLE") == 0);
+        }
+    }
+    CHECK(primaries == 1);
+
+#ifdef GMS_HAVE_XCB
+    // The pipelined XCB backend must produce exactly the same records
+    PhysicalScreen xcbArray[SCREENS_PER_PAGE];
+    ScreenInfo xcbInfo = {};
+    xcbInfo.screen = xcbArray;
+    xcbInfo.count = 0;
+    xcbInfo.maxCount = SCREENS_PER_PAGE;
+    xcbInfo.more = false;
+
+    CHECK(rezol_xcb_get_virtual_screens(&xcbInfo) != 0);
+    CHECK(xcbInfo.count == info.count);
+    for (int i = 0; i < info.count && i < xcbInfo.count; i++) {
+        CHECK(memcmp(&info.screen[i], &xcbInfo.screen[i], sizeof(PhysicalScreen)) == 0);
+    }
+    // Three stages however many monitors there are
+    CHECK(rezol_xcb_last_round_trips() == 3);
+    CHECK(rezol_x11_last_round_trips() > rezol_xcb_last_round_trips());
+
+    // Neither of these raises a uevent
+    CHECK(rezol_x11_watch_start(&OnChange));
+    const char* unscaled = "Xft.antialias:\t1\nXft.dpi:\t96\n";
+    XChangeProperty(dpy, root, XA_RESOURCE_MANAGER, XA_STRING, 8, PropModeReplace,
+                    (const unsigned char*)unscaled, strlen(unscaled));
+    XSync(dpy, False);
+    CHECK(WaitForChange());
+    // The output itself was never made primary
+    XRRSetOutputPrimary(dpy, root, output);
+    XSync(dpy, False);
+    CHECK(WaitForChange());
+    rezol_x11_watch_stop();
+#endif
+
+    XRRFreeScreenResources(res);
+    XCloseDisplay(dpy);
+
+    return TestResult();
+}
@@ -0,0 +1,164 @@
+#include "linux_backends.h"
+#include "screen_topology.h"
+#include "screen_trace.h"
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+using namespace std;
+
+// Background thread that waits for kernel uevents and reports drm ones.
+// Only one watcher runs at a time.
+static thread watchThread;
+static int watchFd = -1;
+static int wakeFd = -1;
+static void (*watchCallback)() = nullptr;
+
+static bool StartsWith(const char* s, size_t length, const char* prefix, size_t prefixLength) {
+    return length >= prefixLength && memcmp(s, prefix, prefixLength) == 0;
+}
+
+bool rezol_uevent_is_drm_change(const char* msg, size_t length) {
+    // Messages re-broadcast by udevd carry a binary header, we only want
+    // the kernel's own "ACTION@DEVPATH\0KEY=VALUE\0..." form
+    if (StartsWith(msg, length, "libudev", 8)) {
+        return false;
+    }
+    bool drm = false;
+    bool action = false;
+    const char* p = msg;
+    const char* end = msg + length;
+    while (p < end) {
+        size_t len = strnlen(p, end - p);
+        if (StartsWith(p, len, "SUBSYSTEM=", 10)) {
+            drm = (len == 13 && memcmp(p + 10, "drm", 3) == 0);
+        } else if (StartsWith(p, len, "ACTION=", 7)) {
+            // Connector hotplug arrives as "change" on the card, GPUs
+            // coming and going as add/remove
+            const char* value = p + 7;
+            size_t valueLen = len - 7;
+            action = (valueLen == 6 && memcmp(value, "change", 6) == 0) ||
+                     (valueLen == 3 && memcmp(value, "add", 3) == 0) ||
+                     (valueLen == 6 && memcmp(value, "remove", 6) == 0);
+        }
+        p += len + 1;
+    }
+    return drm && action;
+}
+
+int rezol_uevent_open_netlink() {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_pid = 0;     // let the kernel pick
+    addr.nl_groups = 1;  // kernel uevent multicast group
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void WatchLoop(int fd, int wake) {
+    char buf[8192];
+    struct pollfd fds[2] = { { fd, POLLIN, 0 }, { wake, POLLIN, 0 } };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            // Asked to stop
+            return;
+        }
+        REZOL_TRACE_INSTANT("uevent_wake");
+
+        // Drain everything that is queued so a burst of uevents (one per
+        // connector) only causes one invalidation
+        bool changed = false;
+        bool closed = false;
+        for (;;) {
+            struct sockaddr_nl sender = {};
+            struct iovec iov = { buf, sizeof(buf) };
+            struct msghdr msg = {};
+            msg.msg_name = &sender;
+            msg.msg_namelen = sizeof(sender);
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+
+            ssize_t n = recvmsg(fd, &msg, MSG_DONTWAIT);
+            if (n == 0) {
+                closed = true;
+                break;
+            }
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ENOBUFS) {
+                    closed = true;
+                }
+                // ENOBUFS means the queue overflowed and events were lost
+                changed |= (errno == ENOBUFS);
+                break;
+            }
+            // On netlink only trust the kernel itself (pid 0)
+            if (msg.msg_namelen == sizeof(sender) && sender.nl_family == AF_NETLINK && sender.nl_pid != 0) {
+                continue;
+            }
+            if (rezol_uevent_is_drm_change(buf, n)) {
+                changed = true;
+            }
+        }
+        if (changed) {
+            watchCallback();
+        }
+        if (closed || (fds[0].revents & (POLLERR | POLLNVAL))) {
+            break;
+        }
+    }
+    // The socket failed, so hotplugs would go unseen from here on
+    rezol_topology_watcher_lost();
+}
+
+bool rezol_uevent_watch_start(int fd, void (*onChange)()) {
+    if (watchThread.joinable() || fd < 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return watchThread.joinable();
+    }
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0) {
+        close(fd);
+        return false;
+    }
+    watchFd = fd;
+    watchCallback = onChange;
+    watchThread = thread(&WatchLoop, watchFd, wakeFd);
+    return true;
+}
+
+void rezol_uevent_watch_stop() {
+    if (!watchThread.joinable()) {
+        return;
+    }
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        // Closing the socket below still ends the loop on its next wakeup
+    }
+    watchThread.join();
+    close(watchFd);
+    close(wakeFd);
+    watchFd = -1;
+    wakeFd = -1;
+    watchCallback = nullptr;
+}
@@ -0,0 +1,472 @@
+#include "linux_backends.h"
+#include "screen_backend.h"
+#include "screen_topology.h"
+#include "screen_trace.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <wayland-client.h>
+#include "xdg-output-unstable-v1-client-protocol.h"
+
+using namespace std;
+
+// Everything the compositor tells us about one wl_output
+struct WaylandOutput {
+    wl_output* output = nullptr;
+    zxdg_output_v1* xdgOutput = nullptr;
+    int32_t x = 0, y = 0;                     // wl_output.geometry, compositor space
+    int32_t mmWidth = 0, mmHeight = 0;
+    int32_t transform = WL_OUTPUT_TRANSFORM_NORMAL;
+    int32_t modeWidth = 0, modeHeight = 0;    // current mode, hardware pixels
+    int32_t refreshMilliHz = 0;
+    int32_t scale = 1;
+    bool haveLogical = false;
+    int32_t logicalX = 0, logicalY = 0;       // zxdg_output_v1, logical pixels
+    int32_t logicalWidth = 0, logicalHeight = 0;
+    string name;
+    string model;
+};
+
+struct WaylandState {
+    zxdg_output_manager_v1* xdgManager = nullptr;
+    vector<WaylandOutput*> outputs;
+};
+
+// --- wl_output ---
+
+static void OutputGeometry(void* data, wl_output*, int32_t x, int32_t y, int32_t physicalWidth,
+                           int32_t physicalHeight, int32_t, const char*, const char* model, int32_t transform) {
+    WaylandOutput* out = static_cast<WaylandOutput*>(data);
+    out->x = x;
+    out->y = y;
+    out->mmWidth = physicalWidth;
+    out->mmHeight = physicalHeight;
+    out->transform = transform;
+    if (model != nullptr && strcmp(model, "unknown") != 0) {
+        out->model = model;
+    }
+}
+
+static void OutputMode(void* data, wl_output*, uint32_t flags, int32_t width, int32_t height, int32_t refresh) {
+    WaylandOutput* out = static_cast<WaylandOutput*>(data);
+    if (flags & WL_OUTPUT_MODE_CURRENT) {
+        out->modeWidth = width;
+        out->modeHeight = height;
+        out->refreshMilliHz = refresh;
+    }
+}
+
+static void OutputDone(void*, wl_output*) {
+}
+
+static void OutputScale(void* data, wl_output*, int32_t factor) {
+    static_cast<WaylandOutput*>(data)->scale = factor;
+}
+
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+static void OutputName(void* data, wl_output*, const char* name) {
+    static_cast<WaylandOutput*>(data)->name = name;
+}
+
+static void OutputDescription(void*, wl_output*, const char*) {
+}
+#endif
+
+static const wl_output_listener outputListener = {
+    &OutputGeometry,
+    &OutputMode,
+    &OutputDone,
+    &OutputScale,
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+    &OutputName,
+    &OutputDescription,
+#endif
+};
+
+// --- zxdg_output_v1 ---
+
+static void XdgOutputLogicalPosition(void* data, zxdg_output_v1*, int32_t x, int32_t y) {
+    WaylandOutput* out = static_cast<WaylandOutput*>(data);
+    out->logicalX = x;
+    out->logicalY = y;
+    out->haveLogical = true;
+}
+
+static void XdgOutputLogicalSize(void* data, zxdg_output_v1*, int32_t width, int32_t height) {
+    WaylandOutput* out = static_cast<WaylandOutput*>(data);
+    out->logicalWidth = width;
+    out->logicalHeight = height;
+}
+
+static void XdgOutputDone(void*, zxdg_output_v1*) {
+}
+
+static void XdgOutputName(void* data, zxdg_output_v1*, const char* name) {
+    WaylandOutput* out = static_cast<WaylandOutput*>(data);
+    if (out->name.empty()) {
+        out->name = name;
+    }
+}
+
+static void XdgOutputDescription(void*, zxdg_output_v1*, const char*) {
+}
+
+static const zxdg_output_v1_listener xdgOutputListener = {
+    &XdgOutputLogicalPosition,
+    &XdgOutputLogicalSize,
+    &XdgOutputDone,
+    &XdgOutputName,
+    &XdgOutputDescription,
+};
+
+// --- wl_registry ---
+
+static void RegistryGlobal(void* data, wl_registry* registry, uint32_t id, const char* interface, uint32_t version) {
+    WaylandState* state = static_cast<WaylandState*>(data);
+    if (strcmp(interface, wl_output_interface.name) == 0) {
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+        uint32_t wanted = 4;
+#else
+        uint32_t wanted = 3;
+#endif
+        WaylandOutput* out = new WaylandOutput();
+        out->output = static_cast<wl_output*>(
+            wl_registry_bind(registry, id, &wl_output_interface, std::min(version, wanted)));
+        wl_output_add_listener(out->output, &outputListener, out);
+        state->outputs.push_back(out);
+    } else if (strcmp(interface, zxdg_output_manager_v1_interface.name) == 0) {
+        state->xdgManager = static_cast<zxdg_output_manager_v1*>(
+            wl_registry_bind(registry, id, &zxdg_output_manager_v1_interface, std::min(version, 3u)));
+    }
+}
+
+static void RegistryGlobalRemove(void*, wl_registry*, uint32_t) {
+}
+
+static const wl_registry_listener registryListener = {
+    &RegistryGlobal,
+    &RegistryGlobalRemove,
+};
+
+static bool IsSideways(int32_t transform) {
+    // 90, 270 and their flipped variants
+    return transform & 1;
+}
+
+static void FillScreen(const WaylandOutput& out, PhysicalScreen& screen) {
+    bool sideways = IsSideways(out.transform);
+
+    if (out.modeWidth > 0 && out.modeHeight > 0) {
+        screen.pixelBox.width = sideways ? out.modeHeight : out.modeWidth;
+        screen.pixelBox.height = sideways ? out.modeWidth : out.modeHeight;
+        screen.refreshRate = (int32_t)lround(out.refreshMilliHz / 1000.0);
+    } else {
+        screen.errorCode |= 2;
+        screen.pixelBox = { 0, 0 };
+        screen.refreshRate = 0;
+    }
+
+    // xdg-output gives the real logical layout, including fractional scaling.
+    // Without it the best guess is the mode size divided by the integer scale.
+    if (out.haveLogical && out.logicalWidth > 0 && out.logicalHeight > 0) {
+        screen.virtualRect = { out.logicalX, out.logicalY,
+                               out.logicalX + out.logicalWidth, out.logicalY + out.logicalHeight };
+    } else {
+        int32_t scale = out.scale > 0 ? out.scale : 1;
+        screen.virtualRect = { out.x, out.y, out.x + screen.pixelBox.width / scale,
+                               out.y + screen.pixelBox.height / scale };
+    }
+    // Wayland has no work area, panels are layer-shell surfaces we cannot see
+    screen.workingRect = screen.virtualRect;
+
+    if (out.mmWidth > 0 && out.mmHeight > 0) {
+        screen.physSize = sideways ? MakePhysicalSize(out.mmHeight, out.mmWidth)
+                                   : MakePhysicalSize(out.mmWidth, out.mmHeight);
+    } else {
+        screen.errorCode |= 4;
+        screen.physSize = { 0, 0, 0 };
+    }
+
+    // With xdg-output the scale is how many mode pixels one logical pixel
+    // covers, fractional scales included, rounded to the 1/120 steps of
+    // wp_fractional_scale. wl_output only knows the integer buffer scale.
+    double scale = out.scale;
+    int32_t logicalWidth = screen.virtualRect.right - screen.virtualRect.left;
+    if (out.haveLogical && logicalWidth > 0 && screen.pixelBox.width > 0) {
+        scale = lround(120.0 * screen.pixelBox.width / logicalWidth) / 120.0;
+    }
+    SetScreenDPI(screen, scale);
+
+    if (!out.model.empty()) {
+        SetScreenName(screen, out.model.c_str());
+    } else {
+        screen.errorCode |= 8;
+        SetScreenName(screen, out.name.empty() ? "Unknown Monitor" : out.name.c_str());
+    }
+}
+
+int32_t rezol_wayland_get_virtual_screens(ScreenInfo* info) {
+    wl_display* display = wl_display_connect(nullptr);
+    if (display == nullptr) {
+        return 0;
+    }
+
+    WaylandState state;
+    wl_registry* registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &registryListener, &state);
+
+    // First round trip announces the globals and binds every output
+    int32_t result = 0;
+    if (wl_display_roundtrip(display) >= 0) {
+        if (state.xdgManager != nullptr) {
+            for (WaylandOutput* out : state.outputs) {
+                out->xdgOutput = zxdg_output_manager_v1_get_xdg_output(state.xdgManager, out->output);
+                zxdg_output_v1_add_listener(out->xdgOutput, &xdgOutputListener, out);
+            }
+        }
+        // Second round trip delivers wl_output and xdg-output events for all
+        // outputs in one batch
+        if (wl_display_roundtrip(display) >= 0) {
+            info->autoHideTaskbar = 0;
+            int32_t primary = -1;
+            for (WaylandOutput* out : state.outputs) {
+                PhysicalScreen screen = {};
+                FillScreen(*out, screen);
+                if (!rezol_add_screen(info, screen)) {
+                    break;
+                }
+                // No primary output in Wayland, use the one at the origin
+                if (primary < 0 && screen.virtualRect.left == 0 && screen.virtualRect.top == 0) {
+                    primary = info->count - 1;
+                }
+            }
+            if (info->count > 0) {
+                info->screen[primary >= 0 ? primary : 0].isPrimary = 1;
+            }
+            result = 1;
+        }
+    }
+
+    for (WaylandOutput* out : state.outputs) {
+        if (out->xdgOutput) {
+            zxdg_output_v1_destroy(out->xdgOutput);
+        }
+        if (wl_output_get_version(out->output) >= WL_OUTPUT_RELEASE_SINCE_VERSION) {
+            wl_output_release(out->output);
+        } else {
+            wl_output_destroy(out->output);
+        }
+        delete out;
+    }
+    if (state.xdgManager) {
+        zxdg_output_manager_v1_destroy(state.xdgManager);
+    }
+    wl_registry_destroy(registry);
+    wl_display_disconnect(display);
+    return result;
+}
+
+// --- Watcher ---
+
+// A connection of our own, kept open on a background thread with every
+// wl_output bound. Outputs coming and going arrive as registry globals,
+// and every change to an output's mode, scale, transform or position is
+// followed by wl_output.done (with xdg-output v3 its logical layout too).
+struct WaylandWatch {
+    wl_display* display = nullptr;
+    wl_registry* registry = nullptr;
+    vector<pair<uint32_t, wl_output*>> outputs;  // registry name, bound output
+    bool ready = false;    // past the events describing the starting outputs
+    bool changed = false;
+};
+
+static WaylandWatch watch;
+static thread watchThread;
+static int wakeFd = -1;
+static void (*watchCallback)() = nullptr;
+
+static void WatchGeometry(void*, wl_output*, int32_t, int32_t, int32_t, int32_t, int32_t, const char*,
+                          const char*, int32_t) {
+}
+
+static void WatchMode(void*, wl_output*, uint32_t, int32_t, int32_t, int32_t) {
+}
+
+static void WatchDone(void* data, wl_output*) {
+    WaylandWatch* w = static_cast<WaylandWatch*>(data);
+    w->changed |= w->ready;
+}
+
+static void WatchScale(void*, wl_output*, int32_t) {
+}
+
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+static void WatchName(void*, wl_output*, const char*) {
+}
+
+static void WatchDescription(void*, wl_output*, const char*) {
+}
+#endif
+
+static const wl_output_listener watchOutputListener = {
+    &WatchGeometry,
+    &WatchMode,
+    &WatchDone,
+    &WatchScale,
+#ifdef WL_OUTPUT_NAME_SINCE_VERSION
+    &WatchName,
+    &WatchDescription,
+#endif
+};
+
+static void ReleaseOutput(wl_output* output) {
+    if (wl_output_get_version(output) >= WL_OUTPUT_RELEASE_SINCE_VERSION) {
+        wl_output_release(output);
+    } else {
+        wl_output_destroy(output);
+    }
+}
+
+static void WatchGlobal(void* data, wl_registry* registry, uint32_t id, const char* interface, uint32_t version) {
+    WaylandWatch* w = static_cast<WaylandWatch*>(data);
+    if (strcmp(interface, wl_output_interface.name) == 0) {
+        // done arrived in version 2
+        wl_output* output = static_cast<wl_output*>(
+            wl_registry_bind(registry, id, &wl_output_interface, std::min(version, 3u)));
+        wl_output_add_listener(output, &watchOutputListener, w);
+        w->outputs.emplace_back(id, output);
+        w->changed |= w->ready;
+    }
+}
+
+static void WatchGlobalRemove(void* data, wl_registry*, uint32_t id) {
+    WaylandWatch* w = static_cast<WaylandWatch*>(data);
+    for (auto it = w->outputs.begin(); it != w->outputs.end(); ++it) {
+        if (it->first == id) {
+            ReleaseOutput(it->second);
+            w->outputs.erase(it);
+            w->changed |= w->ready;
+            break;
+        }
+    }
+}
+
+static const wl_registry_listener watchRegistryListener = {
+    &WatchGlobal,
+    &WatchGlobalRemove,
+};
+
+static void WatchDisconnect() {
+    for (const auto& output : watch.outputs) {
+        ReleaseOutput(output.second);
+    }
+    watch.outputs.clear();
+    if (watch.registry) {
+        wl_registry_destroy(watch.registry);
+    }
+    if (watch.display) {
+        wl_display_disconnect(watch.display);
+    }
+    watch = WaylandWatch();
+}
+
+// Returns true when asked to stop, false when the connection failed
+static bool WatchEvents(wl_display* display, int wake) {
+    struct pollfd fds[2] = { { wl_display_get_fd(display), POLLIN, 0 }, { wake, POLLIN, 0 } };
+    for (;;) {
+        // Dispatch whatever is queued before blocking on the socket
+        while (wl_display_prepare_read(display) != 0) {
+            if (wl_display_dispatch_pending(display) < 0) {
+                return false;
+            }
+        }
+        if (watch.changed) {
+            watch.changed = false;
+            REZOL_TRACE_INSTANT("wayland_output_change");
+            watchCallback();
+        }
+        wl_display_flush(display);
+
+        if (poll(fds, 2, -1) < 0) {
+            wl_display_cancel_read(display);
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (fds[1].revents) {
+            wl_display_cancel_read(display);
+            return true;
+        }
+        if (fds[0].revents & POLLIN) {
+            if (wl_display_read_events(display) < 0) {
+                return false;
+            }
+        } else {
+            wl_display_cancel_read(display);
+            if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                return false;
+            }
+        }
+        if (wl_display_dispatch_pending(display) < 0) {
+            return false;
+        }
+    }
+}
+
+static void WatchLoop(wl_display* display, int wake) {
+    if (!WatchEvents(display, wake)) {
+        // Outputs coming and going would go unseen from here on
+        rezol_topology_watcher_lost();
+    }
+}
+
+bool rezol_wayland_watch_start(void (*onChange)()) {
+    if (watchThread.joinable()) {
+        return true;
+    }
+    watch.display = wl_display_connect(nullptr);
+    if (watch.display == nullptr) {
+        return false;
+    }
+    watch.registry = wl_display_get_registry(watch.display);
+    wl_registry_add_listener(watch.registry, &watchRegistryListener, &watch);
+    // Bind the outputs there are and take their first events, which only
+    // describe what the next enumeration will see anyway
+    if (wl_display_roundtrip(watch.display) < 0 || wl_display_roundtrip(watch.display) < 0) {
+        WatchDisconnect();
+        return false;
+    }
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0) {
+        WatchDisconnect();
+        return false;
+    }
+    watch.ready = true;
+    watch.changed = false;
+    watchCallback = onChange;
+    watchThread = thread(&WatchLoop, watch.display, wakeFd);
+    return true;
+}
+
+void rezol_wayland_watch_stop() {
+    if (!watchThread.joinable()) {
+        return;
+    }
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        // Nothing else wakes the thread, but eventfd writes do not fail
+    }
+    watchThread.join();
+    close(wakeFd);
+    wakeFd = -1;
+    watchCallback = nullptr;
+    WatchDisconnect();
+}
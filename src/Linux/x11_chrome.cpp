@@ -0,0 +1,189 @@
+#include "linux_backends.h"
+#include <mutex>
+#include <unordered_map>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+using namespace std;
+
+// Window chrome is read over a connection of our own that stays open, so
+// the server can tell us when a cached answer goes stale. Every window we
+// are asked about gets PropertyChangeMask and StructureNotifyMask selected
+// on it (event masks are per client, so the game's own selection is left
+// alone), and between calls the only work is draining whatever events have
+// already arrived. A window is only queried again after:
+//   PropertyNotify on _NET_FRAME_EXTENTS   frame extents re-read
+//   ConfigureNotify from the server        geometry re-read
+//   ConfigureNotify sent by the WM         taken from the event itself
+//   ReparentNotify                         geometry re-read
+//   DestroyNotify                          dropped from the cache
+// ICCCM has window managers send the synthetic ConfigureNotify, in root
+// coordinates, whenever they move a frame, so dragging a window costs no
+// round trips at all.
+
+struct CachedChrome {
+    GMSRect inner;       // client area in root coordinates
+    int32_t extents[4];  // _NET_FRAME_EXTENTS left, right, top, bottom
+    bool    haveGeometry;
+    bool    haveExtents;
+};
+
+static mutex chromeLock;
+static Display* chromeDisplay = nullptr;
+static Atom frameExtentsAtom = None;
+static unordered_map<Window, CachedChrome> chromeCache;
+static uint32_t roundTrips = 0;
+
+uint32_t rezol_x11_last_chrome_round_trips() {
+    return roundTrips;
+}
+
+// Xlib reports errors through one process-wide handler, so it is only
+// swapped in around our own requests, each of which ends in a reply that
+// makes Xlib deliver any error from the requests before it.
+static bool chromeError = false;
+
+static int TrapChromeError(Display*, XErrorEvent*) {
+    chromeError = true;
+    return 0;
+}
+
+static void HandleEvent(const XEvent& ev) {
+    switch (ev.type) {
+        case PropertyNotify: {
+            auto it = chromeCache.find(ev.xproperty.window);
+            if (it != chromeCache.end() && ev.xproperty.atom == frameExtentsAtom) {
+                it->second.haveExtents = false;
+            }
+            break;
+        }
+        case ConfigureNotify: {
+            auto it = chromeCache.find(ev.xconfigure.window);
+            if (it == chromeCache.end()) {
+                break;
+            }
+            const XConfigureEvent& c = ev.xconfigure;
+            if (c.send_event) {
+                int32_t left = c.x + c.border_width;
+                int32_t top = c.y + c.border_width;
+                it->second.inner = { left, top, left + c.width, top + c.height };
+                it->second.haveGeometry = true;
+            } else {
+                // Relative to the parent, which is the frame once reparented
+                it->second.haveGeometry = false;
+            }
+            break;
+        }
+        case ReparentNotify: {
+            auto it = chromeCache.find(ev.xreparent.window);
+            if (it != chromeCache.end()) {
+                it->second.haveGeometry = false;
+            }
+            break;
+        }
+        case DestroyNotify:
+            chromeCache.erase(ev.xdestroywindow.window);
+            break;
+    }
+}
+
+static bool ReadGeometry(Window window, CachedChrome& cached) {
+    Window root, child;
+    int x, y, rootX, rootY;
+    unsigned int width, height, border, depth;
+    roundTrips++;
+    if (!XGetGeometry(chromeDisplay, window, &root, &x, &y, &width, &height, &border, &depth) || chromeError) {
+        return false;
+    }
+    roundTrips++;
+    if (!XTranslateCoordinates(chromeDisplay, window, root, 0, 0, &rootX, &rootY, &child) || chromeError) {
+        return false;
+    }
+    cached.inner = { rootX, rootY, rootX + (int32_t)width, rootY + (int32_t)height };
+    cached.haveGeometry = true;
+    return true;
+}
+
+// No _NET_FRAME_EXTENTS means no frame, as for an undecorated window
+static bool ReadExtents(Window window, CachedChrome& cached) {
+    Atom type;
+    int format;
+    unsigned long nitems, after;
+    unsigned char* data = nullptr;
+    cached.extents[0] = cached.extents[1] = cached.extents[2] = cached.extents[3] = 0;
+    roundTrips++;
+    if (XGetWindowProperty(chromeDisplay, window, frameExtentsAtom, 0, 4, False, XA_CARDINAL,
+                           &type, &format, &nitems, &after, &data) == Success &&
+        data != nullptr && format == 32 && nitems >= 4) {
+        const long* v = reinterpret_cast<const long*>(data);
+        for (int i = 0; i < 4; i++) {
+            cached.extents[i] = (int32_t)v[i];
+        }
+    }
+    if (data) {
+        XFree(data);
+    }
+    cached.haveExtents = !chromeError;
+    return cached.haveExtents;
+}
+
+int32_t rezol_x11_get_window_chrome(uintptr_t window, WindowChrome* chrome) {
+    lock_guard<mutex> lock(chromeLock);
+    roundTrips = 0;
+    if (window == None) {
+        return 0;
+    }
+    if (chromeDisplay == nullptr) {
+        chromeDisplay = XOpenDisplay(nullptr);
+        if (chromeDisplay == nullptr) {
+            return 0;
+        }
+        roundTrips++;
+        frameExtentsAtom = XInternAtom(chromeDisplay, "_NET_FRAME_EXTENTS", False);
+    }
+
+    // Only what is already on the socket, this never waits on the server
+    while (XEventsQueued(chromeDisplay, QueuedAfterReading) > 0) {
+        XEvent ev;
+        XNextEvent(chromeDisplay, &ev);
+        HandleEvent(ev);
+    }
+
+    auto it = chromeCache.find(window);
+    bool known = it != chromeCache.end();
+    if (!known || !it->second.haveGeometry || !it->second.haveExtents) {
+        CachedChrome fresh = known ? it->second : CachedChrome();
+        chromeError = false;
+        XErrorHandler previous = XSetErrorHandler(&TrapChromeError);
+        if (!known) {
+            // Selected before the first read so no change can slip in between
+            XSelectInput(chromeDisplay, window, PropertyChangeMask | StructureNotifyMask);
+        }
+        bool ok = (fresh.haveGeometry || ReadGeometry(window, fresh)) &&
+                  (fresh.haveExtents || ReadExtents(window, fresh));
+        XSetErrorHandler(previous);
+        if (!ok) {
+            // Most likely not a window (any more)
+            chromeCache.erase(window);
+            return 0;
+        }
+        it = chromeCache.insert_or_assign(window, fresh).first;
+    }
+
+    const CachedChrome& cached = it->second;
+    chrome->innerRect = cached.inner;
+    chrome->outerRect = { cached.inner.left - cached.extents[0], cached.inner.top - cached.extents[2],
+                          cached.inner.right + cached.extents[1], cached.inner.bottom + cached.extents[3] };
+    chrome->fourcc = GMEX;
+    return 1;
+}
+
+// The connection would otherwise outlive an unloaded library
+__attribute__((destructor)) static void CloseChromeDisplay() {
+    lock_guard<mutex> lock(chromeLock);
+    if (chromeDisplay != nullptr) {
+        XCloseDisplay(chromeDisplay);
+        chromeDisplay = nullptr;
+    }
+    chromeCache.clear();
+}
@@ -0,0 +1,274 @@
+#include "linux_backends.h"
+#include "screen_backend.h"
+#include "screen_stats.h"
+#include <cstdio>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/Xrandr.h>
+#ifdef GMS_HAVE_XINERAMA
+#include <X11/extensions/Xinerama.h>
+#endif
+
+using namespace std;
+
+// Every Xlib call below that returns server data blocks for one round trip
+static uint32_t roundTrips = 0;
+
+uint32_t rezol_x11_last_round_trips() {
+    return roundTrips;
+}
+
+// The desktop-wide _NET_WORKAREA of the current desktop, if the WM sets one
+static bool GetNetWorkArea(Display* dpy, Window root, GMSRect& area) {
+    roundTrips++;
+    Atom workArea = XInternAtom(dpy, "_NET_WORKAREA", True);
+    if (workArea == None) {
+        return false;
+    }
+    Atom type;
+    int format;
+    unsigned long nitems, after;
+    unsigned char* data = nullptr;
+    bool ok = false;
+    roundTrips++;
+    if (XGetWindowProperty(dpy, root, workArea, 0, 4, False, XA_CARDINAL,
+                           &type, &format, &nitems, &after, &data) == Success &&
+        data != nullptr && format == 32 && nitems >= 4) {
+        const long* v = reinterpret_cast<const long*>(data);
+        area = { (int32_t)v[0], (int32_t)v[1], (int32_t)(v[0] + v[2]), (int32_t)(v[1] + v[3]) };
+        ok = true;
+    }
+    if (data) {
+        XFree(data);
+    }
+    return ok;
+}
+
+// EDID product name of an output, read without triggering a re-probe
+static bool OutputEDIDName(Display* dpy, RROutput output, Atom edidAtom, char* out, size_t outSize) {
+    REZOL_STAT_SCOPE(STAT_NAMES);
+    if (edidAtom == None) {
+        return false;
+    }
+    Atom type;
+    int format;
+    unsigned long nitems, after;
+    unsigned char* data = nullptr;
+    bool ok = false;
+    roundTrips++;
+    if (XRRGetOutputProperty(dpy, output, edidAtom, 0, EDID_PROPERTY_LONGS, False, False, AnyPropertyType,
+                             &type, &format, &nitems, &after, &data) == Success &&
+        data != nullptr && format == 8) {
+        EDIDInfo edid;
+        if (rezol_edid_parse_cached(data, nitems, edid) && edid.name[0] != '\0') {
+            snprintf(out, outSize, "%s", edid.name);
+            ok = true;
+        }
+    }
+    if (data) {
+        XFree(data);
+    }
+    return ok;
+}
+
+static int32_t RandREnum(Display* dpy, Window root, double scale, ScreenInfo* info) {
+    // GetScreenResourcesCurrent returns the server's cached state, unlike
+    // GetScreenResources which makes the server poll every output over DDC
+    roundTrips++;
+    XRRScreenResources* res = XRRGetScreenResourcesCurrent(dpy, root);
+    if (res == nullptr) {
+        return 0;
+    }
+    int monitorCount = 0;
+    roundTrips++;
+    XRRMonitorInfo* monitors = XRRGetMonitors(dpy, root, True, &monitorCount);
+    if (monitors == nullptr || monitorCount <= 0) {
+        if (monitors) {
+            XRRFreeMonitors(monitors);
+        }
+        XRRFreeScreenResources(res);
+        return 0;
+    }
+
+    roundTrips++;
+    Atom edidAtom = XInternAtom(dpy, RR_PROPERTY_RANDR_EDID, True);
+    GMSRect workArea;
+    bool haveWorkArea = GetNetWorkArea(dpy, root, workArea);
+
+    for (int m = 0; m < monitorCount; m++) {
+        const XRRMonitorInfo& mon = monitors[m];
+        PhysicalScreen screen = {};
+
+        screen.virtualRect = { mon.x, mon.y, mon.x + mon.width, mon.y + mon.height };
+        screen.workingRect = haveWorkArea ? ClipToWorkArea(screen.virtualRect, workArea) : screen.virtualRect;
+        screen.isPrimary = mon.primary ? 1 : 0;
+        screen.pixelBox = { mon.width, mon.height };
+
+        bool named = false;
+        int32_t mmWidth = mon.mwidth;
+        int32_t mmHeight = mon.mheight;
+
+        XRROutputInfo* output = nullptr;
+        if (mon.noutput > 0) {
+            roundTrips++;
+            output = XRRGetOutputInfo(dpy, res, mon.outputs[0]);
+        }
+        if (output != nullptr) {
+            if (mmWidth <= 0 || mmHeight <= 0) {
+                mmWidth = output->mm_width;
+                mmHeight = output->mm_height;
+            }
+
+            XRRCrtcInfo* crtc = nullptr;
+            if (output->crtc) {
+                REZOL_STAT_SCOPE(STAT_MODES);
+                roundTrips++;
+                crtc = XRRGetCrtcInfo(dpy, res, output->crtc);
+            }
+            const XRRModeInfo* mode = nullptr;
+            if (crtc != nullptr) {
+                for (int i = 0; i < res->nmode; i++) {
+                    if (res->modes[i].id == crtc->mode) {
+                        mode = &res->modes[i];
+                        break;
+                    }
+                }
+            }
+            if (mode != nullptr) {
+                // Native pixels of the mode, before any RandR scaling transform
+                bool sideways = crtc->rotation & (RR_Rotate_90 | RR_Rotate_270);
+                screen.pixelBox.width = sideways ? mode->height : mode->width;
+                screen.pixelBox.height = sideways ? mode->width : mode->height;
+                screen.refreshRate = ModeRefreshRate(mode->dotClock, mode->hTotal, mode->vTotal,
+                                                     mode->modeFlags & RR_DoubleScan, mode->modeFlags & RR_Interlace);
+            } else {
+                screen.errorCode |= 2;
+                screen.refreshRate = 0;
+            }
+            if (crtc) {
+                XRRFreeCrtcInfo(crtc);
+            }
+
+            named = OutputEDIDName(dpy, mon.outputs[0], edidAtom, screen.name, MONITOR_NAME_BUFFER_SIZE);
+            if (!named) {
+                SetScreenName(screen, output->name);
+            }
+            XRRFreeOutputInfo(output);
+        } else {
+            // A monitor defined with xrandr --setmonitor may have no outputs
+            screen.errorCode |= 2;
+            roundTrips++;
+            char* atomName = XGetAtomName(dpy, mon.name);
+            if (atomName) {
+                SetScreenName(screen, atomName);
+                XFree(atomName);
+            }
+        }
+
+        if (!named) {
+            screen.errorCode |= 8;
+        }
+
+        if (mmWidth > 0 && mmHeight > 0) {
+            screen.physSize = MakePhysicalSize(mmWidth, mmHeight);
+        } else {
+            screen.errorCode |= 4;
+            screen.physSize = { 0, 0, 0 };
+        }
+        SetScreenDPI(screen, scale);
+
+        if (!rezol_add_screen(info, screen)) {
+            break;
+        }
+    }
+
+    XRRFreeMonitors(monitors);
+    XRRFreeScreenResources(res);
+    return 1;
+}
+
+#ifdef GMS_HAVE_XINERAMA
+static int32_t XineramaEnum(Display* dpy, double scale, ScreenInfo* info) {
+    roundTrips += 2;
+    if (!XineramaIsActive(dpy)) {
+        return 0;
+    }
+    int count = 0;
+    XineramaScreenInfo* screens = XineramaQueryScreens(dpy, &count);
+    if (screens == nullptr) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        PhysicalScreen screen = {};
+        screen.virtualRect = { screens[i].x_org, screens[i].y_org,
+                               screens[i].x_org + screens[i].width, screens[i].y_org + screens[i].height };
+        screen.workingRect = screen.virtualRect;
+        screen.pixelBox = { screens[i].width, screens[i].height };
+        screen.isPrimary = (i == 0);
+        // Xinerama knows nothing about modes, sizes or names
+        screen.errorCode = 2 | 4 | 8;
+        snprintf(screen.name, MONITOR_NAME_BUFFER_SIZE, "Screen %d", screens[i].screen_number);
+        SetScreenDPI(screen, scale);
+        if (!rezol_add_screen(info, screen)) {
+            break;
+        }
+    }
+    XFree(screens);
+    return 1;
+}
+#endif
+
+// Last resort, the core protocol only knows the size of the whole screen
+static int32_t CoreEnum(Display* dpy, double scale, ScreenInfo* info) {
+    int scr = DefaultScreen(dpy);
+    PhysicalScreen screen = {};
+    screen.pixelBox = { DisplayWidth(dpy, scr), DisplayHeight(dpy, scr) };
+    screen.virtualRect = { 0, 0, screen.pixelBox.width, screen.pixelBox.height };
+    screen.workingRect = screen.virtualRect;
+    screen.physSize = MakePhysicalSize(DisplayWidthMM(dpy, scr), DisplayHeightMM(dpy, scr));
+    screen.isPrimary = 1;
+    screen.errorCode = 2 | 8;
+    SetScreenName(screen, DisplayString(dpy));
+    SetScreenDPI(screen, scale);
+    rezol_add_screen(info, screen);
+    return 1;
+}
+
+int32_t rezol_x11_get_virtual_screens(ScreenInfo* info) {
+    Display* dpy = XOpenDisplay(nullptr);
+    if (dpy == nullptr) {
+        return 0;
+    }
+    Window root = DefaultRootWindow(dpy);
+    info->autoHideTaskbar = 0;
+
+    roundTrips = 0;
+    // Xlib read RESOURCE_MANAGER when the display was opened
+    const char* resources = XResourceManagerString(dpy);
+    double scale = resources ? XftDPI(resources, strlen(resources)) / 96 : 0;
+    int32_t result = 0;
+    int eventBase, errorBase, major = 0, minor = 0;
+    // XRRGetMonitors needs RandR 1.5
+    roundTrips += 2;
+    if (XRRQueryExtension(dpy, &eventBase, &errorBase) &&
+        XRRQueryVersion(dpy, &major, &minor) && (major > 1 || (major == 1 && minor >= 5))) {
+        result = RandREnum(dpy, root, scale, info);
+    }
+#ifdef GMS_HAVE_XINERAMA
+    if (!result) {
+        info->count = 0;
+        result = XineramaEnum(dpy, scale, info);
+    }
+#endif
+    if (!result) {
+        info->count = 0;
+        result = CoreEnum(dpy, scale, info);
+    }
+#ifdef GMS_HAVE_XCB
+    // Per-monitor work areas from the panels, over _NET_WORKAREA
+    rezol_x11_apply_panel_struts(info);
+#endif
+
+    XCloseDisplay(dpy);
+    return result;
+}
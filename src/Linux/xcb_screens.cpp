@@ -0,0 +1,294 @@
+#include "linux_backends.h"
+#include "screen_backend.h"
+#include "screen_stats.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+
+using namespace std;
+
+// Each stage below sends all of its requests before waiting on any reply,
+// so the whole query is three round trips no matter how many monitors:
+//   1. RandR extension presence + atoms
+//   2. version, current resources, monitors, work area, resources string
+//   3. output info, EDID and atom name per monitor, every CRTC
+static uint32_t roundTrips = 0;
+
+uint32_t rezol_xcb_last_round_trips() {
+    return roundTrips;
+}
+
+static xcb_intern_atom_cookie_t InternAtom(xcb_connection_t* conn, const char* name) {
+    return xcb_intern_atom(conn, 1, strlen(name), name);
+}
+
+static xcb_atom_t AtomReply(xcb_connection_t* conn, xcb_intern_atom_cookie_t cookie) {
+    xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(conn, cookie, nullptr);
+    xcb_atom_t atom = reply ? reply->atom : XCB_ATOM_NONE;
+    free(reply);
+    return atom;
+}
+
+// Per monitor requests issued in stage 3
+struct MonitorRequests {
+    xcb_randr_output_t output;
+    xcb_randr_get_output_info_cookie_t outputInfo;
+    xcb_randr_get_output_property_cookie_t edid;
+    xcb_get_atom_name_cookie_t atomName;
+};
+
+static int32_t RandREnum(xcb_connection_t* conn, xcb_window_t root, ScreenInfo* info) {
+    // Stage 1
+    xcb_prefetch_extension_data(conn, &xcb_randr_id);
+    xcb_intern_atom_cookie_t edidCookie = InternAtom(conn, "EDID");
+    xcb_intern_atom_cookie_t workAreaCookie = InternAtom(conn, "_NET_WORKAREA");
+
+    const xcb_query_extension_reply_t* ext = xcb_get_extension_data(conn, &xcb_randr_id);
+    xcb_atom_t edidAtom = AtomReply(conn, edidCookie);
+    xcb_atom_t workAreaAtom = AtomReply(conn, workAreaCookie);
+    roundTrips++;
+    if (ext == nullptr || !ext->present) {
+        return 0;
+    }
+
+    // Stage 2. GetScreenResourcesCurrent does not make the server re-probe.
+    xcb_randr_query_version_cookie_t versionCookie = xcb_randr_query_version(conn, 1, 5);
+    xcb_randr_get_screen_resources_current_cookie_t resCookie = xcb_randr_get_screen_resources_current(conn, root);
+    xcb_randr_get_monitors_cookie_t monitorsCookie = xcb_randr_get_monitors(conn, root, 1);
+    xcb_get_property_cookie_t workAreaProp = {};
+    if (workAreaAtom != XCB_ATOM_NONE) {
+        workAreaProp = xcb_get_property(conn, 0, root, workAreaAtom, XCB_ATOM_CARDINAL, 0, 4);
+    }
+    // What Xlib reads into XResourceManagerString when it connects
+    xcb_get_property_cookie_t resourcesProp =
+        xcb_get_property(conn, 0, root, XCB_ATOM_RESOURCE_MANAGER, XCB_ATOM_STRING, 0, 16384);
+
+    xcb_randr_query_version_reply_t* version = xcb_randr_query_version_reply(conn, versionCookie, nullptr);
+    xcb_randr_get_screen_resources_current_reply_t* res =
+        xcb_randr_get_screen_resources_current_reply(conn, resCookie, nullptr);
+    xcb_randr_get_monitors_reply_t* monitors = xcb_randr_get_monitors_reply(conn, monitorsCookie, nullptr);
+
+    GMSRect workArea = {};
+    bool haveWorkArea = false;
+    if (workAreaAtom != XCB_ATOM_NONE) {
+        xcb_get_property_reply_t* prop = xcb_get_property_reply(conn, workAreaProp, nullptr);
+        if (prop && prop->format == 32 && xcb_get_property_value_length(prop) >= 16) {
+            const uint32_t* v = static_cast<const uint32_t*>(xcb_get_property_value(prop));
+            workArea = { (int32_t)v[0], (int32_t)v[1], (int32_t)(v[0] + v[2]), (int32_t)(v[1] + v[3]) };
+            haveWorkArea = true;
+        }
+        free(prop);
+    }
+    double scale = 0;
+    xcb_get_property_reply_t* resources = xcb_get_property_reply(conn, resourcesProp, nullptr);
+    if (resources && resources->format == 8) {
+        scale = XftDPI(static_cast<const char*>(xcb_get_property_value(resources)),
+                       xcb_get_property_value_length(resources)) / 96;
+    }
+    free(resources);
+    roundTrips++;
+
+    bool ok = version && res && monitors &&
+              (version->major_version > 1 || (version->major_version == 1 && version->minor_version >= 5));
+    free(version);
+    if (!ok || monitors->nMonitors == 0) {
+        free(res);
+        free(monitors);
+        return 0;
+    }
+
+    // Stage 3. CRTCs are fetched up front for the whole screen rather than
+    // after each output reply, which would cost another round trip.
+    xcb_timestamp_t configTime = res->config_timestamp;
+    int crtcCount = xcb_randr_get_screen_resources_current_crtcs_length(res);
+    const xcb_randr_crtc_t* crtcs = xcb_randr_get_screen_resources_current_crtcs(res);
+    vector<xcb_randr_get_crtc_info_cookie_t> crtcCookies(crtcCount);
+    for (int i = 0; i < crtcCount; i++) {
+        crtcCookies[i] = xcb_randr_get_crtc_info(conn, crtcs[i], configTime);
+    }
+
+    vector<MonitorRequests> requests;
+    requests.reserve(monitors->nMonitors);
+    xcb_randr_monitor_info_iterator_t it = xcb_randr_get_monitors_monitors_iterator(monitors);
+    for (; it.rem; xcb_randr_monitor_info_next(&it)) {
+        MonitorRequests r = {};
+        r.atomName = xcb_get_atom_name(conn, it.data->name);
+        if (it.data->nOutput > 0) {
+            r.output = xcb_randr_monitor_info_outputs(it.data)[0];
+            r.outputInfo = xcb_randr_get_output_info(conn, r.output, configTime);
+            if (edidAtom != XCB_ATOM_NONE) {
+                r.edid = xcb_randr_get_output_property(conn, r.output, edidAtom, XCB_GET_PROPERTY_TYPE_ANY,
+                                                       0, EDID_PROPERTY_LONGS, 0, 0);
+            }
+        }
+        requests.push_back(r);
+    }
+
+    // The stage's one round trip is waited out here, so it counts as modes
+    vector<xcb_randr_get_crtc_info_reply_t*> crtcInfo(crtcCount);
+    {
+        REZOL_STAT_SCOPE(STAT_MODES);
+        for (int i = 0; i < crtcCount; i++) {
+            crtcInfo[i] = xcb_randr_get_crtc_info_reply(conn, crtcCookies[i], nullptr);
+        }
+    }
+
+    const xcb_randr_mode_info_t* modes = xcb_randr_get_screen_resources_current_modes(res);
+    int modeCount = xcb_randr_get_screen_resources_current_modes_length(res);
+
+    it = xcb_randr_get_monitors_monitors_iterator(monitors);
+    bool full = false;
+    for (size_t m = 0; it.rem; xcb_randr_monitor_info_next(&it), m++) {
+        const xcb_randr_monitor_info_t* mon = it.data;
+        MonitorRequests& r = requests[m];
+
+        // Every reply has to be collected, even once the caller's array is full
+        xcb_get_atom_name_reply_t* atomName = xcb_get_atom_name_reply(conn, r.atomName, nullptr);
+        xcb_randr_get_output_info_reply_t* output = nullptr;
+        xcb_randr_get_output_property_reply_t* edid = nullptr;
+        if (mon->nOutput > 0) {
+            output = xcb_randr_get_output_info_reply(conn, r.outputInfo, nullptr);
+            if (edidAtom != XCB_ATOM_NONE) {
+                edid = xcb_randr_get_output_property_reply(conn, r.edid, nullptr);
+            }
+        }
+
+        if (!full) {
+            PhysicalScreen screen = {};
+            screen.virtualRect = { mon->x, mon->y, mon->x + mon->width, mon->y + mon->height };
+            screen.workingRect = haveWorkArea ? ClipToWorkArea(screen.virtualRect, workArea) : screen.virtualRect;
+            screen.isPrimary = mon->primary ? 1 : 0;
+            screen.pixelBox = { mon->width, mon->height };
+
+            bool named = false;
+            int32_t mmWidth = mon->width_in_millimeters;
+            int32_t mmHeight = mon->height_in_millimeters;
+
+            if (output != nullptr) {
+                if (mmWidth <= 0 || mmHeight <= 0) {
+                    mmWidth = output->mm_width;
+                    mmHeight = output->mm_height;
+                }
+
+                const xcb_randr_get_crtc_info_reply_t* crtc = nullptr;
+                for (int i = 0; i < crtcCount && output->crtc; i++) {
+                    if (crtcs[i] == output->crtc) {
+                        crtc = crtcInfo[i];
+                        break;
+                    }
+                }
+                const xcb_randr_mode_info_t* mode = nullptr;
+                for (int i = 0; crtc && i < modeCount; i++) {
+                    if (modes[i].id == crtc->mode) {
+                        mode = &modes[i];
+                        break;
+                    }
+                }
+                if (mode != nullptr) {
+                    // Native pixels of the mode, before any RandR scaling transform
+                    bool sideways = crtc->rotation & (XCB_RANDR_ROTATION_ROTATE_90 | XCB_RANDR_ROTATION_ROTATE_270);
+                    screen.pixelBox.width = sideways ? mode->height : mode->width;
+                    screen.pixelBox.height = sideways ? mode->width : mode->height;
+                    screen.refreshRate = ModeRefreshRate(mode->dot_clock, mode->htotal, mode->vtotal,
+                                                         mode->mode_flags & XCB_RANDR_MODE_FLAG_DOUBLE_SCAN,
+                                                         mode->mode_flags & XCB_RANDR_MODE_FLAG_INTERLACE);
+                } else {
+                    screen.errorCode |= 2;
+                    screen.refreshRate = 0;
+                }
+
+                if (edid && edid->format == 8) {
+                    REZOL_STAT_SCOPE(STAT_NAMES);
+                    const unsigned char* data = xcb_randr_get_output_property_data(edid);
+                    int length = xcb_randr_get_output_property_data_length(edid);
+                    EDIDInfo edidInfo;
+                    named = rezol_edid_parse_cached(data, length, edidInfo) && edidInfo.name[0] != '\0';
+                    if (named) {
+                        SetScreenName(screen, edidInfo.name);
+                    }
+                }
+                if (!named) {
+                    SetScreenName(screen, (const char*)xcb_randr_get_output_info_name(output),
+                                  xcb_randr_get_output_info_name_length(output));
+                }
+            } else {
+                // A monitor defined with xrandr --setmonitor may have no outputs
+                screen.errorCode |= 2;
+                if (atomName) {
+                    SetScreenName(screen, xcb_get_atom_name_name(atomName), xcb_get_atom_name_name_length(atomName));
+                }
+            }
+
+            if (!named) {
+                screen.errorCode |= 8;
+            }
+
+            if (mmWidth > 0 && mmHeight > 0) {
+                screen.physSize = MakePhysicalSize(mmWidth, mmHeight);
+            } else {
+                screen.errorCode |= 4;
+                screen.physSize = { 0, 0, 0 };
+            }
+            SetScreenDPI(screen, scale);
+
+            full = !rezol_add_screen(info, screen);
+        }
+
+        free(atomName);
+        free(output);
+        free(edid);
+    }
+    roundTrips++;
+
+    for (xcb_randr_get_crtc_info_reply_t* crtc : crtcInfo) {
+        free(crtc);
+    }
+    free(res);
+    free(monitors);
+    return 1;
+}
+
+int32_t rezol_xcb_get_virtual_screens(ScreenInfo* info) {
+    int screenNum = 0;
+    xcb_connection_t* conn = xcb_connect(nullptr, &screenNum);
+    if (xcb_connection_has_error(conn)) {
+        xcb_disconnect(conn);
+        return 0;
+    }
+
+    xcb_screen_iterator_t screens = xcb_setup_roots_iterator(xcb_get_setup(conn));
+    for (int i = 0; i < screenNum && screens.rem; i++) {
+        xcb_screen_next(&screens);
+    }
+    if (!screens.rem) {
+        xcb_disconnect(conn);
+        return 0;
+    }
+
+    roundTrips = 0;
+    info->autoHideTaskbar = 0;
+    int32_t result = RandREnum(conn, screens.data->root, info);
+    if (!result) {
+        // No usable RandR, report the whole X screen like the core protocol does
+        info->count = 0;
+        PhysicalScreen screen = {};
+        screen.pixelBox = { screens.data->width_in_pixels, screens.data->height_in_pixels };
+        screen.virtualRect = { 0, 0, screen.pixelBox.width, screen.pixelBox.height };
+        screen.workingRect = screen.virtualRect;
+        screen.physSize = MakePhysicalSize(screens.data->width_in_millimeters, screens.data->height_in_millimeters);
+        screen.isPrimary = 1;
+        screen.errorCode = 2 | 8;
+        const char* display = getenv("DISPLAY");
+        SetScreenName(screen, display ? display : "X11");
+        SetScreenDPI(screen, 1);
+        rezol_add_screen(info, screen);
+        result = 1;
+    }
+    // Per-monitor work areas from the panels, over _NET_WORKAREA
+    rezol_x11_apply_panel_struts(info);
+
+    xcb_disconnect(conn);
+    return result;
+}
@@ -0,0 +1,396 @@
+#include "linux_backends.h"
+#include "screen_topology.h"
+#include "screen_trace.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <xcb/xcb.h>
+#include <xcb/randr.h>
+
+using namespace std;
+
+// X11 only publishes one desktop-wide _NET_WORKAREA, so per-monitor work
+// areas are worked out from the struts of the dock windows themselves.
+// The struts are kept on a connection of our own that stays open:
+//   _NET_CLIENT_LIST on the root is watched for windows coming and going,
+//     and only windows that are new to it have their type read
+//   _NET_WM_STRUT_PARTIAL / _NET_WM_STRUT are watched on every dock and
+//     only the docks whose strut changed are read again
+// Every read of a stage is sent before any reply is collected, so each
+// update is at most three round trips however many windows there are, and
+// a query with nothing changed makes none. The watcher thread wakes on the
+// connection's socket so a panel moving invalidates the topology the way
+// a hotplug does.
+//
+// The same connection is what the X backends watch with. Modes,
+// positions, rotation and the primary output change through RandR and
+// Xft.dpi through RESOURCE_MANAGER on the root, none of it with a uevent,
+// so the root also selects RandR screen, CRTC and output notifications.
+
+struct DockWindow {
+    bool       reserves;  // has a strut with some space in it
+    PanelStrut strut;
+};
+
+static mutex strutLock;
+static xcb_connection_t* conn = nullptr;
+static bool connectFailed = false;
+static xcb_window_t root = XCB_WINDOW_NONE;
+static xcb_atom_t clientListAtom, windowTypeAtom, typeDockAtom, strutPartialAtom, strutAtom;
+static bool haveClientList = false;  // false without a window manager that sets it
+static bool clientListStale = true;
+static unordered_set<xcb_window_t> clients;
+static unordered_map<xcb_window_t, DockWindow> docks;
+static unordered_set<xcb_window_t> staleDocks;
+static uint8_t randrFirstEvent = 0;  // 0 without RandR
+static bool displayChanged = false;  // RandR or RESOURCE_MANAGER since last taken
+static uint32_t roundTrips = 0;
+
+uint32_t rezol_x11_last_strut_round_trips() {
+    return roundTrips;
+}
+
+static xcb_intern_atom_cookie_t InternAtom(const char* name) {
+    return xcb_intern_atom(conn, 0, strlen(name), name);
+}
+
+static xcb_atom_t AtomReply(xcb_intern_atom_cookie_t cookie) {
+    xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(conn, cookie, nullptr);
+    xcb_atom_t atom = reply ? reply->atom : XCB_ATOM_NONE;
+    free(reply);
+    return atom;
+}
+
+static void SelectPropertyChanges(xcb_window_t window) {
+    uint32_t mask = XCB_EVENT_MASK_PROPERTY_CHANGE;
+    xcb_change_window_attributes(conn, window, XCB_CW_EVENT_MASK, &mask);
+}
+
+// Once only. A server that goes away is not reconnected to, queries fall
+// back to _NET_WORKAREA.
+static bool Connect() {
+    if (conn != nullptr) {
+        return !xcb_connection_has_error(conn);
+    }
+    if (connectFailed) {
+        return false;
+    }
+    int screenNum = 0;
+    conn = xcb_connect(nullptr, &screenNum);
+    xcb_screen_iterator_t screens = xcb_setup_roots_iterator(xcb_get_setup(conn));
+    for (int i = 0; !xcb_connection_has_error(conn) && i < screenNum && screens.rem; i++) {
+        xcb_screen_next(&screens);
+    }
+    if (xcb_connection_has_error(conn) || !screens.rem) {
+        xcb_disconnect(conn);
+        conn = nullptr;
+        connectFailed = true;
+        return false;
+    }
+    root = screens.data->root;
+
+    xcb_intern_atom_cookie_t cookies[] = {
+        InternAtom("_NET_CLIENT_LIST"), InternAtom("_NET_WM_WINDOW_TYPE"), InternAtom("_NET_WM_WINDOW_TYPE_DOCK"),
+        InternAtom("_NET_WM_STRUT_PARTIAL"), InternAtom("_NET_WM_STRUT")
+    };
+    clientListAtom = AtomReply(cookies[0]);
+    windowTypeAtom = AtomReply(cookies[1]);
+    typeDockAtom = AtomReply(cookies[2]);
+    strutPartialAtom = AtomReply(cookies[3]);
+    strutAtom = AtomReply(cookies[4]);
+    roundTrips++;
+    SelectPropertyChanges(root);
+
+    // RandR 1.2 notifications are only sent to clients that asked for 1.2
+    const xcb_query_extension_reply_t* randr = xcb_get_extension_data(conn, &xcb_randr_id);
+    roundTrips++;
+    if (randr != nullptr && randr->present) {
+        randrFirstEvent = randr->first_event;
+        xcb_discard_reply(conn, xcb_randr_query_version(conn, 1, 5).sequence);
+        xcb_randr_select_input(conn, root, XCB_RANDR_NOTIFY_MASK_SCREEN_CHANGE | XCB_RANDR_NOTIFY_MASK_CRTC_CHANGE |
+                                           XCB_RANDR_NOTIFY_MASK_OUTPUT_CHANGE);
+    }
+    return true;
+}
+
+// Whatever events have arrived, without waiting for more. Errors from
+// windows that vanished under us arrive here too and are dropped.
+static void HandleEvents() {
+    while (xcb_generic_event_t* ev = xcb_poll_for_event(conn)) {
+        uint8_t type = ev->response_type & 0x7f;
+        if (type == XCB_PROPERTY_NOTIFY) {
+            const xcb_property_notify_event_t* p = reinterpret_cast<const xcb_property_notify_event_t*>(ev);
+            if (p->window == root && p->atom == clientListAtom) {
+                clientListStale = true;
+            } else if (p->window == root && p->atom == XCB_ATOM_RESOURCE_MANAGER) {
+                displayChanged = true;
+            } else if ((p->atom == strutPartialAtom || p->atom == strutAtom) && docks.count(p->window)) {
+                staleDocks.insert(p->window);
+            }
+        } else if (randrFirstEvent != 0 && (type == randrFirstEvent + XCB_RANDR_SCREEN_CHANGE_NOTIFY ||
+                                            type == randrFirstEvent + XCB_RANDR_NOTIFY)) {
+            displayChanged = true;
+        }
+        free(ev);
+    }
+}
+
+// Windows that left the client list are dropped, new ones have their type
+// read, and new docks are watched and queued for a strut read
+static bool UpdateClientList() {
+    xcb_get_property_reply_t* list = xcb_get_property_reply(
+        conn, xcb_get_property(conn, 0, root, clientListAtom, XCB_ATOM_WINDOW, 0, 65536), nullptr);
+    roundTrips++;
+    size_t docksBefore = docks.size();
+    if (list == nullptr || list->format != 32) {
+        haveClientList = false;
+        clients.clear();
+        docks.clear();
+        staleDocks.clear();
+        free(list);
+        return docksBefore != 0;
+    }
+    haveClientList = true;
+
+    const xcb_window_t* windows = static_cast<const xcb_window_t*>(xcb_get_property_value(list));
+    size_t count = xcb_get_property_value_length(list) / sizeof(xcb_window_t);
+    unordered_set<xcb_window_t> current(windows, windows + count);
+    free(list);
+
+    bool changed = false;
+    for (auto it = clients.begin(); it != clients.end();) {
+        if (current.count(*it) == 0) {
+            changed |= docks.erase(*it) != 0;
+            staleDocks.erase(*it);
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    vector<pair<xcb_window_t, xcb_get_property_cookie_t>> types;
+    for (xcb_window_t window : current) {
+        if (clients.insert(window).second) {
+            types.emplace_back(window, xcb_get_property(conn, 0, window, windowTypeAtom, XCB_ATOM_ATOM, 0, 32));
+        }
+    }
+    for (const auto& type : types) {
+        xcb_get_property_reply_t* reply = xcb_get_property_reply(conn, type.second, nullptr);
+        bool dock = false;
+        if (reply && reply->format == 32) {
+            const xcb_atom_t* atoms = static_cast<const xcb_atom_t*>(xcb_get_property_value(reply));
+            int n = xcb_get_property_value_length(reply) / sizeof(xcb_atom_t);
+            for (int i = 0; i < n && !dock; i++) {
+                dock = (atoms[i] == typeDockAtom);
+            }
+        }
+        free(reply);
+        if (dock) {
+            // Watched before its strut is read so no change slips in between
+            SelectPropertyChanges(type.first);
+            docks[type.first] = DockWindow();
+            staleDocks.insert(type.first);
+            changed = true;
+        }
+    }
+    if (!types.empty()) {
+        roundTrips++;
+    }
+    return changed;
+}
+
+static bool ReadStaleStruts() {
+    if (staleDocks.empty()) {
+        return false;
+    }
+    struct StrutRequest {
+        xcb_window_t window;
+        xcb_get_property_cookie_t partial, strut;
+    };
+    vector<StrutRequest> requests;
+    for (xcb_window_t window : staleDocks) {
+        requests.push_back({ window, xcb_get_property(conn, 0, window, strutPartialAtom, XCB_ATOM_CARDINAL, 0, 12),
+                             xcb_get_property(conn, 0, window, strutAtom, XCB_ATOM_CARDINAL, 0, 4) });
+    }
+    staleDocks.clear();
+
+    bool changed = false;
+    for (const StrutRequest& r : requests) {
+        xcb_get_property_reply_t* partial = xcb_get_property_reply(conn, r.partial, nullptr);
+        xcb_get_property_reply_t* strut = xcb_get_property_reply(conn, r.strut, nullptr);
+        DockWindow dock = {};
+        if (partial && partial->format == 32 && xcb_get_property_value_length(partial) >= 48) {
+            memcpy(&dock.strut, xcb_get_property_value(partial), sizeof(PanelStrut));
+        } else if (strut && strut->format == 32 && xcb_get_property_value_length(strut) >= 16) {
+            // The older form covers the whole edge
+            memcpy(&dock.strut, xcb_get_property_value(strut), 4 * sizeof(int32_t));
+            dock.strut.leftEndY = dock.strut.rightEndY = INT32_MAX;
+            dock.strut.topEndX = dock.strut.bottomEndX = INT32_MAX;
+        }
+        free(partial);
+        free(strut);
+        dock.reserves = dock.strut.left > 0 || dock.strut.right > 0 || dock.strut.top > 0 || dock.strut.bottom > 0;
+
+        auto it = docks.find(r.window);
+        if (it != docks.end() && (it->second.reserves != dock.reserves ||
+                                  memcmp(&it->second.strut, &dock.strut, sizeof(PanelStrut)) != 0)) {
+            it->second = dock;
+            changed = true;
+        }
+    }
+    roundTrips++;
+    return changed;
+}
+
+// Apply everything that has changed since last time, true if the struts
+// did. Replies can bring more events in with them, so go round until
+// nothing is left.
+static bool Refresh() {
+    if (!Connect()) {
+        return false;
+    }
+    bool changed = false;
+    for (;;) {
+        HandleEvents();
+        if (!clientListStale && staleDocks.empty()) {
+            break;
+        }
+        if (clientListStale) {
+            clientListStale = false;
+            changed |= UpdateClientList();
+        }
+        changed |= ReadStaleStruts();
+    }
+    return changed;
+}
+
+bool rezol_x11_get_panel_struts(vector<PanelStrut>& struts, int32_t& autoHide) {
+    lock_guard<mutex> lock(strutLock);
+    roundTrips = 0;
+    Refresh();
+    // Read off the socket here the watcher never wakes for it, and it may
+    // be newer than what the caller just enumerated
+    if (displayChanged) {
+        displayChanged = false;
+        rezol_topology_invalidate();
+    }
+    if (conn == nullptr || xcb_connection_has_error(conn) || !haveClientList) {
+        return false;
+    }
+    struts.clear();
+    autoHide = 0;
+    for (const auto& dock : docks) {
+        if (dock.second.reserves) {
+            struts.push_back(dock.second.strut);
+        } else {
+            // A dock that reserves nothing slides over windows, which is
+            // what an auto-hiding panel does
+            autoHide = 1;
+        }
+    }
+    return true;
+}
+
+void rezol_x11_apply_panel_struts(ScreenInfo* info) {
+    vector<PanelStrut> struts;
+    int32_t autoHide = 0;
+    // The root window spans every monitor, which needs all of them here
+    if (info->count == 0 || info->more || !rezol_x11_get_panel_struts(struts, autoHide)) {
+        return;
+    }
+    int32_t rootWidth = 0, rootHeight = 0;
+    for (int32_t i = 0; i < info->count; i++) {
+        rootWidth = max(rootWidth, info->screen[i].virtualRect.right);
+        rootHeight = max(rootHeight, info->screen[i].virtualRect.bottom);
+    }
+    for (int32_t i = 0; i < info->count; i++) {
+        PhysicalScreen& screen = info->screen[i];
+        screen.workingRect = StrutWorkArea(screen.virtualRect, rootWidth, rootHeight, struts.data(), struts.size());
+    }
+    info->autoHideTaskbar = autoHide;
+}
+
+// --- Watcher ---
+
+static thread watchThread;
+static int wakeFd = -1;
+static void (*watchCallback)() = nullptr;
+
+static void WatchLoop(int fd, int wake) {
+    struct pollfd fds[2] = { { fd, POLLIN, 0 }, { wake, POLLIN, 0 } };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            // Asked to stop
+            return;
+        }
+        bool changed, closed;
+        {
+            REZOL_TRACE_SCOPE("x11_refresh");
+            lock_guard<mutex> lock(strutLock);
+            changed = Refresh() || displayChanged;
+            displayChanged = false;
+            closed = xcb_connection_has_error(conn);
+        }
+        if (changed) {
+            watchCallback();
+        }
+        if (closed || (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))) {
+            break;
+        }
+    }
+    // Lost the X server connection, so changes would go unseen from here on
+    rezol_topology_watcher_lost();
+}
+
+bool rezol_x11_watch_start(void (*onChange)()) {
+    lock_guard<mutex> lock(strutLock);
+    if (watchThread.joinable()) {
+        return true;
+    }
+    if (!Connect()) {
+        return false;
+    }
+    Refresh();
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0) {
+        return false;
+    }
+    watchCallback = onChange;
+    watchThread = thread(&WatchLoop, xcb_get_file_descriptor(conn), wakeFd);
+    return true;
+}
+
+void rezol_x11_watch_stop() {
+    if (watchThread.joinable()) {
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0) {
+            // Nothing else wakes the thread, but eventfd writes do not fail
+        }
+        watchThread.join();
+        close(wakeFd);
+        wakeFd = -1;
+        watchCallback = nullptr;
+    }
+    // Enumerations may have connected without a watcher, reconnects on
+    // the next one
+    lock_guard<mutex> lock(strutLock);
+    if (conn != nullptr) {
+        xcb_disconnect(conn);
+        conn = nullptr;
+    }
+}
@@ -6,13 +6,13 @@ int main() {
 	SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
 	
     // We can only query for a fixed number of screens.
-    PhysicalScreen screenArray[MAX_SCREENS];
+    PhysicalScreen screenArray[SCREENS_PER_PAGE];
     ScreenInfo info;
 
     // Initialize the struct to pass to the library function
     info.screen = screenArray;
     info.count = 0;
-    info.maxCount = MAX_SCREENS;
+    info.maxCount = SCREENS_PER_PAGE;
     info.more = false;
 
     // Call the function from the DLL
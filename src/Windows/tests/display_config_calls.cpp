@@ -0,0 +1,235 @@
+// Fakes 1 to 64 monitors behind a stubbed Win32 layer and checks one
+// enumeration makes a number of OS calls linear in the monitor count,
+// with every friendly name and EDID still matched to the right monitor.
+#include <windows.h>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <vector>
+#include "screen_utils.h"
+#include "screen_backend.h"
+#include "win_display_config.h"
+#include "tests/edid_blobs.h"
+#include "tests/test_check.h"
+
+using namespace std;
+
+static int monitorCount = 0;
+
+struct CallCounts {
+    int getBufferSizes, queryConfig, getDeviceInfo, enumMonitors, getMonitorInfo;
+    int enumSettings, createDC, getDeviceCaps, deleteDC, regGetValue, getDpiForMonitor;
+};
+static CallCounts calls;
+
+// Monitor i is HMONITOR i + 1 on GDI device \\.\DISPLAY<i + 1>, and its
+// path has source id i and target id 100 + i. Paths come back in reverse
+// so matching by position would give the wrong names.
+
+static LONG WINAPI StubGetBufferSizes(UINT32, UINT32* pathCount, UINT32* modeCount) {
+    calls.getBufferSizes++;
+    *pathCount = monitorCount;
+    *modeCount = 0;
+    return ERROR_SUCCESS;
+}
+
+static LONG WINAPI StubQueryConfig(UINT32, UINT32* pathCount, DISPLAYCONFIG_PATH_INFO* paths,
+                                   UINT32* modeCount, DISPLAYCONFIG_MODE_INFO*, DISPLAYCONFIG_TOPOLOGY_ID*) {
+    calls.queryConfig++;
+    if (*pathCount < (UINT32)monitorCount) {
+        return ERROR_INSUFFICIENT_BUFFER;
+    }
+    for (int i = 0; i < monitorCount; i++) {
+        DISPLAYCONFIG_PATH_INFO& path = paths[monitorCount - 1 - i];
+        path = DISPLAYCONFIG_PATH_INFO();
+        path.sourceInfo.id = i;
+        path.targetInfo.id = 100 + i;
+        path.targetInfo.adapterId.LowPart = 7;
+    }
+    *pathCount = monitorCount;
+    *modeCount = 0;
+    return ERROR_SUCCESS;
+}
+
+static LONG WINAPI StubGetDeviceInfo(DISPLAYCONFIG_DEVICE_INFO_HEADER* header) {
+    calls.getDeviceInfo++;
+    if (header->type == DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME) {
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME* source = reinterpret_cast<DISPLAYCONFIG_SOURCE_DEVICE_NAME*>(header);
+        swprintf(source->viewGdiDeviceName, CCHDEVICENAME, L"\\\\.\\DISPLAY%u", header->id + 1);
+        return ERROR_SUCCESS;
+    }
+    if (header->type == DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME) {
+        DISPLAYCONFIG_TARGET_DEVICE_NAME* target = reinterpret_cast<DISPLAYCONFIG_TARGET_DEVICE_NAME*>(header);
+        // Target 100 is an internal panel with no name
+        if (header->id != 100) {
+            swprintf(target->monitorFriendlyDeviceName, 64, L"Panel %u", header->id);
+        }
+        swprintf(target->monitorDevicePath, 128,
+                 L"\\\\?\\DISPLAY#TST%04u#5&1&0&UID%u#{e6f07b5f-ee97-4a90-b076-33f57bf4eaa7}",
+                 header->id, header->id);
+        return ERROR_SUCCESS;
+    }
+    return ERROR_INVALID_PARAMETER;
+}
+
+static BOOL WINAPI StubEnumMonitors(HDC, LPCRECT, MONITORENUMPROC proc, LPARAM data) {
+    calls.enumMonitors++;
+    for (int i = 0; i < monitorCount; i++) {
+        RECT rect = { i * 1920, 0, (i + 1) * 1920, 1080 };
+        if (!proc(reinterpret_cast<HMONITOR>((INT_PTR)(i + 1)), NULL, &rect, data)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static BOOL WINAPI StubGetMonitorInfo(HMONITOR monitor, LPMONITORINFO info) {
+    calls.getMonitorInfo++;
+    int i = (int)reinterpret_cast<INT_PTR>(monitor) - 1;
+    MONITORINFOEX* infoEx = reinterpret_cast<MONITORINFOEX*>(info);
+    infoEx->rcMonitor = { i * 1920, 0, (i + 1) * 1920, 1080 };
+    infoEx->rcWork = { i * 1920, 0, (i + 1) * 1920, 1040 };
+    infoEx->dwFlags = (i == 0) ? MONITORINFOF_PRIMARY : 0;
+    snprintf(infoEx->szDevice, CCHDEVICENAME, "\\\\.\\DISPLAY%d", i + 1);
+    return TRUE;
+}
+
+static BOOL WINAPI StubEnumSettings(LPCSTR, DWORD, DEVMODEA* mode, DWORD) {
+    calls.enumSettings++;
+    mode->dmPelsWidth = 1920;
+    mode->dmPelsHeight = 1080;
+    mode->dmDisplayFrequency = 60;
+    return TRUE;
+}
+
+static HDC WINAPI StubCreateDC(LPCSTR, LPCSTR, LPCSTR, const DEVMODEA*) {
+    calls.createDC++;
+    return reinterpret_cast<HDC>((INT_PTR)1);
+}
+
+static int WINAPI StubGetDeviceCaps(HDC, int index) {
+    calls.getDeviceCaps++;
+    return (index == HORZSIZE) ? 527 : 296;
+}
+
+static BOOL WINAPI StubDeleteDC(HDC) {
+    calls.deleteDC++;
+    return TRUE;
+}
+
+// Every monitor has an EDID, 500 + target mm wide, named only off the panel
+static LONG WINAPI StubRegGetValue(HKEY, LPCWSTR subKey, LPCWSTR value, DWORD, LPDWORD, PVOID data, LPDWORD size) {
+    calls.regGetValue++;
+    unsigned id = 0;
+    if (swscanf(subKey, L"SYSTEM\\CurrentControlSet\\Enum\\DISPLAY\\TST%u\\", &id) != 1 ||
+        wcsstr(subKey, L"\\Device Parameters") == nullptr || wcscmp(value, L"EDID") != 0) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    char name[16];
+    snprintf(name, sizeof(name), "EDID %u", id);
+    EDIDBlob edid = MakeEDID(1920, 1080, 280, 45, 14850, 500 + id, 300, id == 100 ? nullptr : name);
+    if (*size < edid.size()) {
+        return ERROR_MORE_DATA;
+    }
+    memcpy(data, edid.data(), edid.size());
+    *size = (DWORD)edid.size();
+    return ERROR_SUCCESS;
+}
+
+// Every monitor at 150%
+static HRESULT WINAPI StubGetDpiForMonitor(HMONITOR, MONITOR_DPI_TYPE type, UINT* dpiX, UINT* dpiY) {
+    calls.getDpiForMonitor++;
+    *dpiX = *dpiY = (type == MDT_EFFECTIVE_DPI) ? 144 : 92;
+    return S_OK;
+}
+
+static const WinDisplayApi stubApi = {
+    &StubGetBufferSizes,
+    &StubQueryConfig,
+    &StubGetDeviceInfo,
+    &StubEnumMonitors,
+    &StubGetMonitorInfo,
+    &StubEnumSettings,
+    &StubCreateDC,
+    &StubGetDeviceCaps,
+    &StubDeleteDC,
+    &StubRegGetValue,
+    &StubGetDpiForMonitor
+};
+
+static int TotalCalls() {
+    return calls.getBufferSizes + calls.queryConfig + calls.getDeviceInfo + calls.enumMonitors +
+           calls.getMonitorInfo + calls.enumSettings + calls.createDC + calls.getDeviceCaps + calls.deleteDC +
+           calls.regGetValue + calls.getDpiForMonitor;
+}
+
+int main() {
+    rezol_win_set_api(&stubApi);
+
+    int perMonitor = -1;
+    for (int n : { 1, 2, 4, 8, 16, 64 }) {
+        monitorCount = n;
+        calls = CallCounts();
+        vector<PhysicalScreen> screens(n);
+        ScreenInfo info = {};
+        info.screen = screens.data();
+        info.maxCount = n;
+
+        CHECK(rezol_platform_get_virtual_screens(&info) != 0);
+        CHECK(info.count == n);
+        CHECK(!info.more);
+
+        // One display config query for the whole enumeration, and one
+        // source plus one target lookup per path
+        CHECK(calls.getBufferSizes == 1);
+        CHECK(calls.queryConfig == 1);
+        CHECK(calls.getDeviceInfo == 2 * n);
+        CHECK(calls.enumMonitors == 1);
+        // One EDID read per target, which makes a DC for the size unnecessary
+        CHECK(calls.regGetValue == n);
+        CHECK(calls.createDC == 0);
+
+        // Everything else is a fixed number of calls per monitor
+        int fixed = calls.getBufferSizes + calls.queryConfig + calls.enumMonitors;
+        int each = (TotalCalls() - fixed) / n;
+        CHECK((TotalCalls() - fixed) % n == 0);
+        if (perMonitor < 0) {
+            perMonitor = each;
+        }
+        CHECK(each == perMonitor);
+        printf("%3d monitors: %d OS calls\n", n, TotalCalls());
+
+        for (int i = 0; i < info.count; i++) {
+            char expected[MONITOR_NAME_BUFFER_SIZE];
+            if (i == 0) {
+                snprintf(expected, sizeof(expected), "Internal Display");
+            } else {
+                snprintf(expected, sizeof(expected), "Panel %d", 100 + i);
+            }
+            CHECK(strcmp(info.screen[i].name, expected) == 0);
+            CHECK((info.screen[i].errorCode & 8) == 0);
+            CHECK(info.screen[i].virtualRect.left == i * 1920);
+            CHECK(info.screen[i].isPrimary == (i == 0));
+            CHECK(info.screen[i].physSize.width == 600 + i);
+            CHECK(info.screen[i].physSize.height == 300);
+            CHECK(info.screen[i].dpi.effectiveX == 144 && info.screen[i].dpi.rawY == 92);
+            CHECK(info.screen[i].scale == 1.5);
+        }
+    }
+
+    // The index also carries the target id and adapter of each device
+    monitorCount = 3;
+    DisplayConfigIndex index;
+    rezol_win_build_display_config_index(index);
+    CHECK(index.size() == 3);
+    CHECK(index.count("\\\\.\\DISPLAY2") == 1);
+    if (index.count("\\\\.\\DISPLAY2")) {
+        CHECK(index["\\\\.\\DISPLAY2"].targetId == 101);
+        CHECK(index["\\\\.\\DISPLAY2"].adapterId.LowPart == 7);
+        CHECK(index["\\\\.\\DISPLAY2"].hasEDID);
+        CHECK(strcmp(index["\\\\.\\DISPLAY2"].edid.name, "EDID 101") == 0);
+    }
+
+    rezol_win_set_api(nullptr);
+    return TestResult();
+}
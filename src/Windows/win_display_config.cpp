@@ -0,0 +1,162 @@
+#include "win_display_config.h"
+#include "screen_stats.h"
+#include <vector>
+
+using namespace std;
+
+static const WinDisplayApi realApi = {
+    &::GetDisplayConfigBufferSizes,
+    &::QueryDisplayConfig,
+    &::DisplayConfigGetDeviceInfo,
+    &::EnumDisplayMonitors,
+    &::GetMonitorInfo,
+    &::EnumDisplaySettingsEx,
+    &::CreateDC,
+    &::GetDeviceCaps,
+    &::DeleteDC,
+    &::RegGetValueW,
+    &::GetDpiForMonitor
+};
+
+static const WinDisplayApi* currentApi = &realApi;
+
+const WinDisplayApi& rezol_win_api() {
+    return *currentApi;
+}
+
+void rezol_win_set_api(const WinDisplayApi* api) {
+    currentApi = api ? api : &realApi;
+}
+
+// Wide to UTF-8, empty on failure
+static string WideToUTF8(const wchar_t* wide) {
+    int utf8Length = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+    if (utf8Length <= 0) {
+        return string();
+    }
+    string narrow(utf8Length - 1, '\0'); // -1 to exclude null terminator
+    WideCharToMultiByte(CP_UTF8, 0, wide, -1, &narrow[0], utf8Length, nullptr, nullptr);
+    return narrow;
+}
+
+// The target's device path is the monitor's PnP interface,
+// "\\?\DISPLAY#GSM5B7F#5&2a6ff2d5&0&UID4352#{e6f07b5f-...}", and its
+// instance key under Enum\DISPLAY keeps the EDID Windows last read.
+static void TargetEDID(const WinDisplayApi& api, const wchar_t* devicePath, DisplayConfigTarget& target) {
+    target.hasEDID = false;
+    const wchar_t* path = devicePath;
+    if (wcsncmp(path, L"\\\\?\\", 4) == 0) {
+        path += 4;
+    }
+    const wchar_t* end = wcsrchr(path, L'#');
+    if (end == nullptr || end == path) {
+        return;
+    }
+
+    wchar_t subKey[512] = L"SYSTEM\\CurrentControlSet\\Enum\\";
+    size_t pos = wcslen(subKey);
+    const wchar_t suffix[] = L"\\Device Parameters";
+    if (pos + (end - path) + wcslen(suffix) >= sizeof(subKey) / sizeof(subKey[0])) {
+        return;
+    }
+    for (const wchar_t* c = path; c < end; c++) {
+        subKey[pos++] = (*c == L'#') ? L'\\' : *c;
+    }
+    wcscpy(subKey + pos, suffix);
+
+    unsigned char edid[32 * EDID_BLOCK_SIZE];
+    DWORD size = sizeof(edid);
+    if (api.regGetValue(HKEY_LOCAL_MACHINE, subKey, L"EDID", RRF_RT_REG_BINARY, nullptr, edid, &size) != ERROR_SUCCESS) {
+        return;
+    }
+    target.hasEDID = rezol_edid_parse_cached(edid, size, target.edid);
+}
+
+static void TargetName(const WinDisplayApi& api, const DISPLAYCONFIG_PATH_INFO& path, DisplayConfigTarget& target) {
+    DISPLAYCONFIG_TARGET_DEVICE_NAME targetName = {};
+    targetName.header.adapterId = path.targetInfo.adapterId;
+    targetName.header.id = path.targetInfo.id;
+    targetName.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME;
+    targetName.header.size = sizeof(targetName);
+
+    target.targetId = path.targetInfo.id;
+    target.adapterId = path.targetInfo.adapterId;
+    target.nameOk = false;
+    target.friendlyName = "Unknown Monitor";
+    target.hasEDID = false;
+
+    if (api.getDeviceInfo(&targetName.header) != ERROR_SUCCESS) {
+        return;
+    }
+    TargetEDID(api, targetName.monitorDevicePath, target);
+    // Internal panels often have no friendly name at all, though their
+    // EDID may still carry one
+    if (wcslen(targetName.monitorFriendlyDeviceName) == 0) {
+        target.nameOk = true;
+        target.friendlyName = (target.hasEDID && target.edid.name[0]) ? target.edid.name : "Internal Display";
+        return;
+    }
+    string name = WideToUTF8(targetName.monitorFriendlyDeviceName);
+    if (!name.empty()) {
+        target.nameOk = true;
+        target.friendlyName = name;
+    }
+}
+
+void rezol_win_build_display_config_index(DisplayConfigIndex& index) {
+    REZOL_STAT_SCOPE(STAT_NAMES);
+    const WinDisplayApi& api = rezol_win_api();
+    index.clear();
+
+    vector<DISPLAYCONFIG_PATH_INFO> paths;
+    vector<DISPLAYCONFIG_MODE_INFO> modes;
+    UINT32 flags = QDC_ONLY_ACTIVE_PATHS | QDC_VIRTUAL_MODE_AWARE;
+    LONG result = ERROR_SUCCESS;
+
+    do
+    {
+        UINT32 pathCount, modeCount;
+        result = api.getBufferSizes(flags, &pathCount, &modeCount);
+
+        if (result != ERROR_SUCCESS)
+        {
+            return;
+        }
+
+        paths.resize(pathCount);
+        modes.resize(modeCount);
+
+        result = api.queryConfig(flags, &pathCount, paths.data(), &modeCount, modes.data(), nullptr);
+
+        paths.resize(pathCount);
+        modes.resize(modeCount);
+
+    } while (result == ERROR_INSUFFICIENT_BUFFER);
+
+    if (result != ERROR_SUCCESS)
+    {
+        return;
+    }
+
+    for (const DISPLAYCONFIG_PATH_INFO& path : paths)
+    {
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME sourceName = {};
+        sourceName.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+        sourceName.header.size = sizeof(sourceName);
+        sourceName.header.adapterId = path.sourceInfo.adapterId;
+        sourceName.header.id = path.sourceInfo.id;
+
+        if (api.getDeviceInfo(&sourceName.header) != ERROR_SUCCESS)
+        {
+            continue;
+        }
+        // GDI device names are plain ASCII
+        string gdiName = WideToUTF8(sourceName.viewGdiDeviceName);
+        // A cloned source has one path per target, the first one wins
+        if (gdiName.empty() || index.count(gdiName))
+        {
+            continue;
+        }
+        TargetName(api, path, index[gdiName]);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef WIN_DISPLAY_CONFIG_H
+#define WIN_DISPLAY_CONFIG_H
+
+#include <windows.h>
+#include <shellscalingapi.h>
+#include <string>
+#include <unordered_map>
+#include "edid.h"
+
+// --- OS calls used by the Windows backend ---
+
+// Every Win32 call the enumeration makes goes through this table, so a
+// test can swap in stubs that fake any number of monitors and count how
+// often each call is made.
+struct WinDisplayApi {
+    decltype(&::GetDisplayConfigBufferSizes) getBufferSizes;
+    decltype(&::QueryDisplayConfig)          queryConfig;
+    decltype(&::DisplayConfigGetDeviceInfo)  getDeviceInfo;
+    decltype(&::EnumDisplayMonitors)         enumMonitors;
+    decltype(&::GetMonitorInfo)              getMonitorInfo;
+    decltype(&::EnumDisplaySettingsEx)       enumSettings;
+    decltype(&::CreateDC)                    createDC;
+    decltype(&::GetDeviceCaps)               getDeviceCaps;
+    decltype(&::DeleteDC)                    deleteDC;
+    decltype(&::RegGetValueW)                regGetValue;
+    decltype(&::GetDpiForMonitor)            getDpiForMonitor;
+};
+
+// The table in use, the real Win32 functions unless a test replaced them
+const WinDisplayApi& rezol_win_api();
+
+// Replace the table, nullptr goes back to the real functions
+void rezol_win_set_api(const WinDisplayApi* api);
+
+// --- Display config index ---
+
+// What QueryDisplayConfig knows about the monitor behind one GDI device
+struct DisplayConfigTarget {
+    std::string friendlyName;  // UTF-8, "Internal Display" when the panel reports none
+    bool        nameOk;        // false if the target name could not be read
+    UINT32      targetId;
+    LUID        adapterId;
+    bool        hasEDID;       // EDID read from the monitor's device registry key
+    EDIDInfo    edid;
+};
+
+// Keyed by GDI device name ("\\.\DISPLAY1"), as in MONITORINFOEX::szDevice
+typedef std::unordered_map<std::string, DisplayConfigTarget> DisplayConfigIndex;
+
+// One QueryDisplayConfig for the whole enumeration, plus a source and a
+// target name lookup and one EDID registry read per active path. Leaves
+// the index empty on failure.
+void rezol_win_build_display_config_index(DisplayConfigIndex& index);
+
+#endif // WIN_DISPLAY_CONFIG_H
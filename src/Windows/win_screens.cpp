@@ -0,0 +1,308 @@
+#include "screen_utils.h"
+#include "screen_backend.h"
+#include "screen_topology.h"
+#include "win_display_config.h"
+#include "screen_stats.h"
+#include "screen_trace.h"
+#include <atomic>
+#include <string>
+#include <math.h>
+#include <stdio.h>
+#include <shellscalingapi.h>
+#include <dwmapi.h>
+#include <utility>
+#include <vector>
+
+#pragma comment(lib, "shcore.lib")
+#pragma comment(lib, "dwmapi.lib")
+
+using namespace std;
+
+// Helper functions
+
+static GMSRect RectToGMSRect(LPRECT lprcMonitor) {
+    GMSRect rect;
+    rect.left = lprcMonitor->left;
+    rect.top = lprcMonitor->top;
+    rect.right = lprcMonitor->right;
+    rect.bottom = lprcMonitor->bottom;
+    return rect;
+}
+
+static GMSRect RectToGMSRect(RECT rcMonitor) {
+    GMSRect rect;
+    rect.left = rcMonitor.left;
+    rect.top = rcMonitor.top;
+    rect.right = rcMonitor.right;
+    rect.bottom = rcMonitor.bottom;
+    return rect;
+}
+
+// State for one EnumDisplayMonitors pass
+struct WinEnumContext {
+    ScreenInfo* info;
+    DisplayConfigIndex displayConfig; // built once per enumeration
+};
+
+static BOOL CALLBACK MonitorEnum(
+    HMONITOR hMonitor, // Monitor Handle
+    HDC hdc, // Unused
+    LPRECT lprcMonitor, // Scaled rect of this screen
+    LPARAM pData // For passing data around
+    ) {
+    WinEnumContext* context = reinterpret_cast<WinEnumContext*>(pData);
+    ScreenInfo* info = context->info;
+    const WinDisplayApi& api = rezol_win_api();
+    // Paging is done by the core on the cached snapshot, here we only
+    // stop when the caller's array is full
+    if (info->count >= info->maxCount) {
+        info->more = true;
+        return false;
+    }
+    info->screen[info->count].virtualRect = RectToGMSRect(lprcMonitor);
+    info->screen[info->count].workingRect = { 0,0,0,0 };
+    info->screen[info->count].errorCode = 0;
+
+    info->autoHideTaskbar = 0;
+    
+    MONITORINFOEX monitorInfo; // Used to get Primary + Display Name
+  
+    monitorInfo.cbSize = sizeof(MONITORINFOEX);
+    if (api.getMonitorInfo(hMonitor, &monitorInfo)) {
+        // Friendly name from the display config index, no OS call here
+        auto target = context->displayConfig.find(monitorInfo.szDevice);
+        const char* mn = "Unknown Monitor";
+        if (target != context->displayConfig.end()) {
+            mn = target->second.friendlyName.c_str();
+        }
+		if(target == context->displayConfig.end() || !target->second.nameOk) {
+            info->screen[info->count].errorCode |= 8;
+		}
+		
+		std::strncpy(info->screen[info->count].name, mn, MONITOR_NAME_BUFFER_SIZE - 1);
+		info->screen[info->count].name[MONITOR_NAME_BUFFER_SIZE - 1] = '\0';
+		
+        info->screen[info->count].isPrimary = (monitorInfo.dwFlags & MONITORINFOF_PRIMARY);
+		info->screen[info->count].workingRect = RectToGMSRect(monitorInfo.rcWork);
+
+        // --- Get Native/Physical Pixel Resolution using EnumDisplaySettingsEx ---
+        // This gives the true resolution of the monitor's current display mode.
+        DEVMODE devMode;
+        devMode.dmSize = sizeof(DEVMODE);
+        devMode.dmDriverExtra = 0; // Must be 0 for EnumDisplaySettingsEx
+
+        BOOL haveMode;
+        {
+            REZOL_STAT_SCOPE(STAT_MODES);
+            haveMode = api.enumSettings(monitorInfo.szDevice, ENUM_CURRENT_SETTINGS, &devMode, 0);
+        }
+        if (haveMode) {
+            info->screen[info->count].pixelBox.width   = devMode.dmPelsWidth;
+            info->screen[info->count].pixelBox.height  = devMode.dmPelsHeight;
+            info->screen[info->count].refreshRate       = devMode.dmDisplayFrequency;
+
+            // --- Get physical dimensions (mm), from the EDID if there is one ---
+            // GetDeviceCaps only reports a size derived from the DPI setting
+            REZOL_STAT_SCOPE(STAT_PHYSSIZE);
+            HDC hdc = NULL;
+            if (target != context->displayConfig.end() && target->second.hasEDID &&
+                target->second.edid.widthMM > 0 && target->second.edid.heightMM > 0) {
+                int32_t pwidth = target->second.edid.widthMM;
+                int32_t pheight = target->second.edid.heightMM;
+                info->screen[info->count].physSize.width = pwidth;
+                info->screen[info->count].physSize.height = pheight;
+                info->screen[info->count].physSize.diagonal = lround(sqrt((pheight * pheight) + (pwidth * pwidth)));
+            } else if ((hdc = api.createDC(monitorInfo.szDevice, nullptr, nullptr, nullptr)) != NULL) {
+                int32_t pwidth = api.getDeviceCaps(hdc, HORZSIZE); // Physical width in mm
+                info->screen[info->count].physSize.width = pwidth;
+                int32_t pheight = api.getDeviceCaps(hdc, VERTSIZE); // Physical height in mm
+                info->screen[info->count].physSize.height = pheight;
+                info->screen[info->count].physSize.diagonal = lround(sqrt((pheight * pheight) + (pwidth * pwidth)));
+                
+                api.deleteDC(hdc); // Always release the DC
+            } else {
+                info->screen[info->count].errorCode |= 4;
+                info->screen[info->count].physSize = { 0, 0, 0 };
+            }
+
+
+        } else {
+            info->screen[info->count].errorCode |= 2;
+            info->screen[info->count].pixelBox = { 0,0 };
+            info->screen[info->count].refreshRate = 0;
+        }
+        
+    } else {
+        info->screen[info->count].errorCode |= 1;
+        info->screen[info->count].isPrimary = false;
+    }
+    
+    // Effective DPI is what the user's scale setting renders at, raw DPI
+    // the panel's own, both only reported per monitor to a process that is
+    // per-monitor DPI aware (see permonitor-dpi-aware.manifest)
+    UINT dpiX = 0, dpiY = 0;
+    PhysicalScreen& screen = info->screen[info->count];
+    if (api.getDpiForMonitor(hMonitor, MDT_EFFECTIVE_DPI, &dpiX, &dpiY) == S_OK && dpiX > 0) {
+        screen.dpi.effectiveX = dpiX;
+        screen.dpi.effectiveY = dpiY;
+    } else {
+        screen.dpi.effectiveX = USER_DEFAULT_SCREEN_DPI;
+        screen.dpi.effectiveY = USER_DEFAULT_SCREEN_DPI;
+    }
+    screen.scale = screen.dpi.effectiveX / (double)USER_DEFAULT_SCREEN_DPI;
+    if (api.getDpiForMonitor(hMonitor, MDT_RAW_DPI, &dpiX, &dpiY) == S_OK) {
+        screen.dpi.rawX = dpiX;
+        screen.dpi.rawY = dpiY;
+    } else {
+        screen.dpi.rawX = 0;
+        screen.dpi.rawY = 0;
+    }
+
+    info->count++;
+    
+    return true;
+}
+
+int32_t rezol_platform_get_virtual_screens(ScreenInfo* info) {
+  WinEnumContext context;
+  context.info = info;
+  rezol_win_build_display_config_index(context.displayConfig);
+
+  // Stopping early makes EnumDisplayMonitors return FALSE, which is not a
+  // failure when it was only because the array was full
+  return rezol_win_api().enumMonitors(
+    NULL,
+    NULL,
+    &MonitorEnum,
+    reinterpret_cast<LPARAM>(&context)
+  ) || info->more;
+}
+
+// --- Window chrome ---
+
+// Windows keeps both rects itself, so there is nothing to cache
+int32_t rezol_platform_get_window_chrome(uintptr_t window, WindowChrome* chrome) {
+    HWND hwnd = reinterpret_cast<HWND>(window);
+    RECT outer, inner;
+    if (!IsWindow(hwnd) || !GetWindowRect(hwnd, &outer) || !GetClientRect(hwnd, &inner)) {
+        return 0;
+    }
+    // Since Windows 10 GetWindowRect includes the invisible resize borders,
+    // DWM knows where the visible frame is
+    RECT frame;
+    if (DwmGetWindowAttribute(hwnd, DWMWA_EXTENDED_FRAME_BOUNDS, &frame, sizeof(frame)) == S_OK) {
+        outer = frame;
+    }
+    MapWindowPoints(hwnd, NULL, reinterpret_cast<POINT*>(&inner), 2);
+    chrome->outerRect = RectToGMSRect(outer);
+    chrome->innerRect = RectToGMSRect(inner);
+    chrome->fourcc = GMEX;
+    return 1;
+}
+
+// --- Display change watcher ---
+
+// A hidden top-level window on its own thread. WM_DISPLAYCHANGE is only
+// broadcast to top-level windows, so a message-only window would miss it.
+static void (*watchCallback)() = nullptr;
+static HANDLE watchThread = NULL;
+static DWORD watchThreadId = 0;
+static atomic<bool> watchStopping(false);
+
+static LRESULT CALLBACK WatchWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+        case WM_DISPLAYCHANGE:
+        case WM_DPICHANGED:
+            REZOL_TRACE_INSTANT(msg == WM_DISPLAYCHANGE ? "WM_DISPLAYCHANGE" : "WM_DPICHANGED");
+            watchCallback();
+            return 0;
+        case WM_SETTINGCHANGE:
+            // Taskbar moved or resized, so rcWork changed
+            if (wParam == SPI_SETWORKAREA) {
+                REZOL_TRACE_INSTANT("WM_SETTINGCHANGE");
+                watchCallback();
+            }
+            return 0;
+        case WM_CLOSE:
+            DestroyWindow(hwnd);
+            return 0;
+        case WM_DESTROY:
+            PostQuitMessage(0);
+            return 0;
+    }
+    return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+static DWORD WINAPI WatchThreadProc(LPVOID param) {
+    HANDLE ready = reinterpret_cast<HANDLE>(param);
+    HINSTANCE instance = NULL;
+    GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                      reinterpret_cast<LPCTSTR>(&WatchWndProc), &instance);
+
+    WNDCLASS wc = {};
+    wc.lpfnWndProc = &WatchWndProc;
+    wc.hInstance = instance;
+    wc.lpszClassName = TEXT("GMSVirtualScreenWatch");
+    RegisterClass(&wc);
+    HWND hwnd = CreateWindowEx(0, wc.lpszClassName, TEXT(""), WS_POPUP, 0, 0, 0, 0,
+                               NULL, NULL, instance, NULL);
+    SetEvent(ready);
+    if (hwnd == NULL) {
+        return 1;
+    }
+
+    MSG msg;
+    while (GetMessage(&msg, NULL, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+    UnregisterClass(wc.lpszClassName, instance);
+    // Anything but rezol_platform_watch_stop ending the loop, such as the
+    // window being closed, means display changes go unseen from here on
+    if (!watchStopping) {
+        rezol_topology_watcher_lost();
+    }
+    return 0;
+}
+
+bool rezol_platform_watch_start(void (*onChange)()) {
+    if (watchThread != NULL) {
+        return true;
+    }
+    // Pin the DLL so it can never be unmapped under the watcher thread
+    HMODULE self = NULL;
+    GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+                      reinterpret_cast<LPCTSTR>(&WatchWndProc), &self);
+
+    watchCallback = onChange;
+    watchStopping = false;
+    HANDLE ready = CreateEvent(NULL, TRUE, FALSE, NULL);
+    watchThread = CreateThread(NULL, 0, &WatchThreadProc, ready, 0, &watchThreadId);
+    if (watchThread == NULL) {
+        CloseHandle(ready);
+        return false;
+    }
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+
+    // The thread exits straight away if it could not create its window
+    if (WaitForSingleObject(watchThread, 0) == WAIT_OBJECT_0) {
+        CloseHandle(watchThread);
+        watchThread = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Called by rezol_topology_shutdown. The DLL is pinned, so that is at
+// process exit, when the thread has already been ended for us.
+void rezol_platform_watch_stop() {
+    if (watchThread == NULL) {
+        return;
+    }
+    watchStopping = true;
+    PostThreadMessage(watchThreadId, WM_QUIT, 0, 0);
+    WaitForSingleObject(watchThread, 1000);
+    CloseHandle(watchThread);
+    watchThread = NULL;
+}